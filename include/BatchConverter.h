@@ -0,0 +1,118 @@
+#ifndef BATCH_CONVERTER_H
+#define BATCH_CONVERTER_H
+
+#include "ConversionCache.h"
+#include "FileConverter.h"
+
+
+namespace conv {
+
+/* conversion of one input file into one output file, with the transformations applied in order */
+struct BatchJob {
+  std::string inputPath;
+  std::string outputPath;
+  std::vector<Transform> transforms;
+};
+
+/* work done by one stage of the pipeline */
+struct StageStatistics {
+  size_t numOfJobs = 0u;
+  uint64_t numOfBytes = 0u;
+  uint64_t numOfTriangles = 0u;
+
+  /* time spent in the stage, summed over its threads */
+  double busySeconds = 0.0;
+
+  /*
+   * largest resident set size of the whole process sampled after the jobs of the stage (0 if not available)
+   * the stages run concurrently, so this is not the memory used by the stage itself
+   */
+  uint64_t maxResidentBytes = 0u;
+
+  double bytesPerSecond() const {
+    return (busySeconds > 0.0) ? (numOfBytes / busySeconds) : 0.0;
+  }
+
+  double trianglesPerSecond() const {
+    return (busySeconds > 0.0) ? (numOfTriangles / busySeconds) : 0.0;
+  }
+
+  void merge(const StageStatistics& other) {
+    numOfJobs += other.numOfJobs;
+    numOfBytes += other.numOfBytes;
+    numOfTriangles += other.numOfTriangles;
+    busySeconds += other.busySeconds;
+    maxResidentBytes = std::max(maxResidentBytes, other.maxResidentBytes);
+  }
+};
+
+/* job that could not be converted */
+struct BatchFailure {
+  size_t job = 0u;
+  std::string message;
+};
+
+/* result of a batch run */
+struct BatchReport {
+  StageStatistics read;
+  StageStatistics transform;
+  StageStatistics write;
+
+  /* cache misses of the jobs whose vertex cache was optimized */
+  VertexCacheStatistics vertexCache;
+
+  /* wall clock time of the whole batch */
+  double wallSeconds = 0.0;
+
+  /* jobs whose output was taken from the cache (not counted by the stages) */
+  size_t numOfCacheHits = 0u;
+
+  std::vector<BatchFailure> failures;
+};
+
+/* settings of the batch engine */
+struct BatchOptions {
+  /* by default the input formats are detected and the output formats follow the output extensions */
+  InputType input = InputType::INPUT_TYPE_AUTO;
+  OutputType output = OutputType::OUTPUT_TYPE_AUTO;
+
+  /* threads of the read and write stages, the transformations run on the scheduler */
+  size_t numOfReaders = 2u;
+  size_t numOfWriters = 2u;
+
+  /* maximum number of meshes read but not written yet */
+  size_t maxNumOfMeshes = 8u;
+
+  /* cache of the conversion results (none if null) */
+  std::shared_ptr<ConversionCache> cache;
+};
+
+/*
+ * batch engine: converts a list of jobs in a pipeline of read -> transform -> write stages
+ * reads and writes block on the disk, so they run on threads of their own, the transformations
+ * are tasks of the work-stealing scheduler shared with the parallel loops of the converters,
+ * so reading job N + 1 overlaps the transformation of job N and the writing of job N - 1
+ * while the number of meshes in memory stays bounded
+ */
+class BatchConverter {
+public:
+  explicit BatchConverter(const BatchOptions& options = BatchOptions());
+  ~BatchConverter() = default;
+
+  /* function to convert every job, failed jobs are reported and do not stop the batch */
+  BatchReport run(const std::vector<BatchJob>& jobs) const;
+
+private:
+  BatchOptions options_;
+};
+
+/* function to get the current resident set size of the process in bytes (0 if not available) */
+uint64_t residentBytes();
+
+/* function to apply a transformation step on a converter session (the vertex cache statistics are added to vertexCache if given) */
+void applyTransform(FileConverter& converter, const Transform& transform, VertexCacheStatistics* vertexCache = nullptr);
+
+} // namespace conv
+
+
+#endif // BATCH_CONVERTER_H
@@ -0,0 +1,73 @@
+#ifndef BOUNDED_QUEUE_H
+#define BOUNDED_QUEUE_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+
+namespace conv {
+
+/*
+ * blocking first-in first-out queue with a fixed capacity
+ * producers wait while the queue is full, consumers wait while it is empty,
+ * after close() producers are refused and consumers drain the remaining items
+ */
+template <typename T>
+class BoundedQueue {
+public:
+  explicit BoundedQueue(size_t capacity) : capacity_(std::max<size_t>(capacity, 1u)) {}
+  ~BoundedQueue() = default;
+
+  BoundedQueue(const BoundedQueue&) = delete;
+  BoundedQueue& operator= (const BoundedQueue&) = delete;
+
+  /* function to add an item, returns false if the queue has been closed */
+  bool push(T item) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    notFull_.wait(lock, [this]() { return closed_ || items_.size() < capacity_; });
+    if (closed_) {
+      return false;
+    }
+
+    items_.emplace_back(std::move(item));
+    notEmpty_.notify_one();
+    return true;
+  }
+
+  /* function to take the oldest item, returns false if the queue is closed and empty */
+  bool pop(T& item) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    notEmpty_.wait(lock, [this]() { return closed_ || !items_.empty(); });
+    if (items_.empty()) {
+      return false;
+    }
+
+    item = std::move(items_.front());
+    items_.pop_front();
+    notFull_.notify_one();
+    return true;
+  }
+
+  /* function to refuse further items and wake up every waiting thread */
+  void close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+    notEmpty_.notify_all();
+    notFull_.notify_all();
+  }
+
+private:
+  const size_t capacity_;
+  bool closed_ = false;
+  std::deque<T> items_;
+  std::mutex mutex_;
+  std::condition_variable notEmpty_;
+  std::condition_variable notFull_;
+};
+
+} // namespace conv
+
+
+#endif // BOUNDED_QUEUE_H
@@ -0,0 +1,116 @@
+#ifndef BVH_H
+#define BVH_H
+
+#include "Core.h"
+
+
+namespace conv {
+
+/* number of rays traversed together as one packet */
+constexpr size_t RAY_PACKET_SIZE = 4u;
+
+/* triangle index of a ray hit that did not hit anything */
+constexpr uint32_t INVALID_TRIANGLE = std::numeric_limits<uint32_t>::max();
+
+/* ray (or segment) given by origin, direction and the valid parameter interval [tMin, tMax] */
+struct Ray {
+  glm::dvec3 origin{0.0, 0.0, 0.0};
+  glm::dvec3 direction{0.0, 0.0, 1.0};
+  double tMin = 0.0;
+  double tMax = std::numeric_limits<double>::infinity();
+};
+
+/* intersection of a ray with a triangle (index into MeshData::triangles) */
+struct RayHit {
+  uint32_t triangle = INVALID_TRIANGLE;
+  double t = std::numeric_limits<double>::infinity();
+
+  /* barycentric coordinates of the hit point relative to vertices[1] and vertices[2] */
+  double u = 0.0;
+  double v = 0.0;
+
+  bool valid() const {
+    return triangle != INVALID_TRIANGLE;
+  }
+};
+
+/* node of the flattened hierarchy; the left child of an inner node directly follows its parent */
+struct BvhNode {
+  glm::dvec3 boundsMin;
+  glm::dvec3 boundsMax;
+
+  /* first triangle of a leaf or index of the right child of an inner node */
+  uint32_t offset = 0u;
+
+  /* number of triangles of a leaf, 0 for inner nodes */
+  uint16_t count = 0u;
+
+  /* split axis of an inner node (used to order the traversal front to back) */
+  uint16_t axis = 0u;
+};
+
+/*
+ * bounding volume hierarchy over the triangles of a mesh
+ * built with a binned surface area heuristic, traversed with packets of RAY_PACKET_SIZE rays
+ */
+class Bvh {
+public:
+  explicit Bvh(const std::vector<Triangle>& triangles);
+  ~Bvh() = default;
+
+  /* function to find the closest hit of every ray */
+  std::vector<RayHit> firstHits(const std::vector<Ray>& rays) const;
+
+  /* function to find an arbitrary hit of every ray (occlusion test) */
+  std::vector<RayHit> anyHits(const std::vector<Ray>& rays) const;
+
+  /* function to find every hit of every ray, ordered by the ray parameter */
+  std::vector<std::vector<RayHit>> allHits(const std::vector<Ray>& rays) const;
+
+  /* function to collect the triangles whose bounding boxes are crossed by the segment [from, to] */
+  void collectCandidates(const glm::dvec3& from, const glm::dvec3& to, std::vector<uint32_t>& candidates) const;
+
+  /* function to get the number of nodes of the hierarchy */
+  size_t nodeCount() const {
+    return nodes_.size();
+  }
+
+private:
+  /* kind of query done by the packet traversal */
+  enum class Query : uint8_t {
+    QUERY_FIRST = 0u,
+    QUERY_ANY,
+    QUERY_ALL
+  };
+
+  /* rays of a packet in structure of arrays layout, so the per-lane loops vectorize */
+  struct RayPacket;
+
+  /* function to build the subtree over triangles [begin, end) and return the index of its root */
+  uint32_t build(std::vector<uint32_t>& order, const std::vector<glm::dvec3>& boundsMin,
+                 const std::vector<glm::dvec3>& boundsMax, const std::vector<glm::dvec3>& centroids,
+                 uint32_t begin, uint32_t end);
+
+  /* function to trace a packet of rays through the hierarchy */
+  void traverse(RayPacket& packet, Query query, RayHit* hits, std::vector<RayHit>* allHits) const;
+
+  /* function to run a query over a batch of rays packet by packet */
+  void tracePackets(const std::vector<Ray>& rays, Query query, RayHit* hits, std::vector<RayHit>* allHits) const;
+
+
+  /* flattened nodes, the root is nodes_[0] */
+  std::vector<BvhNode> nodes_;
+
+  /* triangle index in MeshData::triangles for every triangle slot of the leaves */
+  std::vector<uint32_t> triangleIds_;
+
+  /* precomputed triangle data in leaf order: first vertex and the two edges leaving it */
+  std::vector<glm::dvec3> vertices0_;
+  std::vector<glm::dvec3> edges1_;
+  std::vector<glm::dvec3> edges2_;
+};
+
+} // namespace conv
+
+
+#endif // BVH_H
@@ -0,0 +1,45 @@
+#ifndef COMMAND_LINE_H
+#define COMMAND_LINE_H
+
+#include "Core.h"
+
+#include <ostream>
+
+
+namespace conv {
+
+/* exit codes of the tool */
+constexpr int EXIT_CODE_SUCCESS = 0;
+constexpr int EXIT_CODE_FAILED_JOBS = 1;
+constexpr int EXIT_CODE_USAGE = 2;
+
+/* settings given on the command line */
+struct CommandLine {
+  std::vector<std::string> inputs;
+  std::string output;
+  std::string format;
+  size_t numOfJobs = 2u;
+  std::vector<Transform> transforms;
+  bool stats = false;
+  bool help = false;
+
+  /* cache of the conversion results */
+  std::string cacheDirectory;
+  double cacheSizeInMegabytes = 1024.0;
+
+  /* socket of the daemon to serve or to connect to */
+  std::string daemonSocket;
+  std::string connectSocket;
+  bool shutdown = false;
+};
+
+/* function to parse the arguments of the tool (argv[0] is the name of the tool), throws std::invalid_argument */
+CommandLine parseCommandLine(int argc, const char* const* argv);
+
+/* function to run the 3dfc tool with the arguments, printing to out and err, returns the exit code */
+int runCommandLine(int argc, const char* const* argv, std::ostream& out, std::ostream& err);
+
+} // namespace conv
+
+
+#endif // COMMAND_LINE_H
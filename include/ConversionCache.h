@@ -0,0 +1,79 @@
+#ifndef CONVERSION_CACHE_H
+#define CONVERSION_CACHE_H
+
+#include "Core.h"
+
+#include <filesystem>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+
+namespace conv {
+
+/* version of the converted outputs, part of every key (to be increased whenever a writer changes its output) */
+constexpr uint32_t CONVERSION_CACHE_VERSION = 2u;
+
+/*
+ * on-disk cache of conversion results, addressed by the content of the conversion
+ * the key is the hash of the input bytes, the formats and the transformation chain, so an input
+ * exported again byte by byte hits the cache under any path
+ * a hit clones (reflinks) or copies the stored output, the least recently used outputs are removed
+ * when the size of the cache exceeds its limit (the use is kept in the modification time of the files)
+ */
+class ConversionCache {
+public:
+  ConversionCache(const std::string& directory, uint64_t maxSizeInBytes);
+  ~ConversionCache() = default;
+
+  ConversionCache(const ConversionCache&) = delete;
+  ConversionCache& operator= (const ConversionCache&) = delete;
+
+  /* function to calculate the key of a conversion (the input file is mapped and hashed) */
+  static uint64_t key(const std::string& inputPath, InputType input, OutputType output,
+                      const std::vector<Transform>& transforms);
+
+  /* function to calculate the key of a conversion from the bytes of the input file */
+  static uint64_t key(const uint8_t* bytes, size_t size, InputType input, OutputType output,
+                      const std::vector<Transform>& transforms);
+
+  /* function to copy the stored output of the key to the path, returns false if the key is not stored */
+  bool fetch(uint64_t key, const std::string& outputPath);
+
+  /* function to store the output of the key */
+  void store(uint64_t key, const std::string& outputPath);
+
+  /* function to get the size of the stored outputs */
+  uint64_t sizeInBytes() const;
+
+private:
+  struct Entry {
+    uint64_t size = 0u;
+    std::list<uint64_t>::iterator position;
+  };
+
+  /* function to get the path of the stored output of the key */
+  std::filesystem::path entryPath(uint64_t key) const;
+
+  /* function to remove the least recently used outputs until the cache fits its limit */
+  void evict();
+
+
+  const std::filesystem::path directory_;
+  const uint64_t maxSizeInBytes_;
+
+  mutable std::mutex mutex_;
+
+  /* keys from the most recently to the least recently used */
+  std::list<uint64_t> order_;
+  std::unordered_map<uint64_t, Entry> entries_;
+  uint64_t sizeInBytes_ = 0u;
+};
+
+/* function to copy the file, cloning its blocks if the file system supports it */
+void cloneOrCopyFile(const std::filesystem::path& source, const std::filesystem::path& target);
+
+} // namespace conv
+
+
+#endif // CONVERSION_CACHE_H
@@ -1,6 +1,8 @@
 #ifndef CORE_H
 #define CORE_H
 
+#include "Parallel.h"
+
 #include <glm.hpp>
 
 #include <algorithm>
@@ -21,15 +23,54 @@ namespace conv {
 /* enum class for read object types */
 enum class InputType : uint8_t {
   INPUT_TYPE_OBJ = 0u,
+  INPUT_TYPE_STL,
+  INPUT_TYPE_STL_ASCII,
+  INPUT_TYPE_PLY,
+  INPUT_TYPE_NATIVE,
+  INPUT_TYPE_PACKED,
+  INPUT_TYPE_EDGEBREAKER,
+  INPUT_TYPE_OFF,
+
+  /* detected from the first bytes of every read file */
+  INPUT_TYPE_AUTO = std::numeric_limits<uint8_t>::max() - 1u,
   INPUT_TYPE_UNKNOWN = std::numeric_limits<uint8_t>::max()
 };
 
 /* enum class for write object types */
 enum class OutputType : uint8_t {
   OUTPUT_TYPE_STL = 0u,
+  OUTPUT_TYPE_STL_ASCII,
+  OUTPUT_TYPE_PLY,
+  OUTPUT_TYPE_GLB,
+  OUTPUT_TYPE_NATIVE,
+  OUTPUT_TYPE_PACKED,
+  OUTPUT_TYPE_EDGEBREAKER,
+  OUTPUT_TYPE_OBJ,
+  OUTPUT_TYPE_OFF,
+  OUTPUT_TYPE_3MF,
+
+  /* chosen by the extension of every written path */
+  OUTPUT_TYPE_AUTO = std::numeric_limits<uint8_t>::max() - 1u,
   OUTPUT_TYPE_UNKNOWN = std::numeric_limits<uint8_t>::max()
 };
 
+/* number of faces triangulated by one task */
+constexpr size_t TRIANGULATE_BLOCK_SIZE = 4096u;
+
+/* enum class for transformation types */
+enum class TransformType : uint8_t {
+  TRANSFORM_TYPE_ROTATE = 0u,
+  TRANSFORM_TYPE_SCALE,
+  TRANSFORM_TYPE_TRANSLATE,
+  TRANSFORM_TYPE_OPTIMIZE_VERTEX_CACHE
+};
+
+/* single transformation step (angles in radians for rotations, no value for the vertex cache optimization) */
+struct Transform {
+  TransformType type = TransformType::TRANSFORM_TYPE_TRANSLATE;
+  glm::dvec3 value{0.0, 0.0, 0.0};
+};
+
 /* structure to store 'f' parameter */
 struct Face {
   std::vector<uint32_t> geometricVertexReferences;
@@ -49,6 +90,43 @@ struct Triangle {
   glm::dvec3 normal;
 };
 
+/* integral properties of the solid bounded by the mesh (unit density) */
+struct MeshProperties {
+  double volume = 0.0;
+  double surface = 0.0;
+
+  /* center of mass */
+  glm::dvec3 centroid{0.0, 0.0, 0.0};
+
+  /* inertia tensor about the center of mass */
+  glm::dmat3 inertia{0.0};
+
+  /* axis aligned bounding box of the triangles */
+  glm::dvec3 boundsMin{0.0, 0.0, 0.0};
+  glm::dvec3 boundsMax{0.0, 0.0, 0.0};
+};
+
+class Bvh;
+class VertexOctree;
+
+/* derived data built on demand from the mesh, dropped whenever the mesh changes */
+struct MeshCache {
+  /* acceleration structure over the triangles for ray queries */
+  std::shared_ptr<const Bvh> bvh;
+
+  /* volume, surface, centroid, inertia tensor and bounding box */
+  std::shared_ptr<const MeshProperties> properties;
+
+  /* spatial index over the geometric vertices for neighbourhood queries */
+  std::shared_ptr<const VertexOctree> vertexOctree;
+
+  void clear() {
+    bvh.reset();
+    properties.reset();
+    vertexOctree.reset();
+  }
+};
+
 /* internal data structure to store information about the given mesh */
 struct MeshData {
   MeshData() = default;
@@ -61,34 +139,41 @@ struct MeshData {
     vertexNormals.clear();
     faces.clear();
     triangles.clear();
-    polygonBoundaries.clear();
     transformOperations.clear();
+    cache.clear();
   }
 
   /* update triangles after transformations */
   void updateTriangles() {
-    /* clear triangles if needed */
-    if (!triangles.empty()) {
-      triangles.clear();
+    /* derived data belongs to the old triangles */
+    cache.clear();
+
+    /* index of the first triangle of every face, so the faces can be triangulated in parallel */
+    std::vector<size_t> firstTriangle(faces.size() + 1u, 0u);
+    for (size_t i = 0u; i < faces.size(); ++i) {
+      size_t numOfVertices = faces[i].geometricVertexReferences.size();
+      firstTriangle[i + 1u] = firstTriangle[i] + ((numOfVertices > 2u) ? (numOfVertices - 2u) : 0u);
     }
+    triangles.resize(firstTriangle.back());
 
     /* triangulate faces (assuming n>3-gons are convex and coplanar) */
-    for (auto& f : faces) {
-      for (size_t i = 1u; (i + 1) < f.geometricVertexReferences.size(); ++i) {
-        Triangle t;
-
-        /* calculate triangle vertices */
-        t.vertices[0] = geometricVertices[f.geometricVertexReferences[0] - 1];
-        t.vertices[1] = geometricVertices[f.geometricVertexReferences[i] - 1];
-        t.vertices[2] = geometricVertices[f.geometricVertexReferences[i + 1] - 1];
-
-        /* calculate normal vector */
-        glm::dvec3 crossProduct = glm::cross(t.vertices[1] - t.vertices[0], t.vertices[2] - t.vertices[0]);
-        t.normal = glm::normalize(crossProduct);
-
-        triangles.emplace_back(t);
+    parallelFor(faces.size(), TRIANGULATE_BLOCK_SIZE, [&](size_t begin, size_t end) {
+      for (size_t j = begin; j < end; ++j) {
+        const Face& f = faces[j];
+        for (size_t i = 1u; (i + 1) < f.geometricVertexReferences.size(); ++i) {
+          Triangle& t = triangles[firstTriangle[j] + i - 1u];
+
+          /* calculate triangle vertices */
+          t.vertices[0] = geometricVertices[f.geometricVertexReferences[0] - 1];
+          t.vertices[1] = geometricVertices[f.geometricVertexReferences[i] - 1];
+          t.vertices[2] = geometricVertices[f.geometricVertexReferences[i + 1] - 1];
+
+          /* calculate normal vector */
+          glm::dvec3 crossProduct = glm::cross(t.vertices[1] - t.vertices[0], t.vertices[2] - t.vertices[0]);
+          t.normal = glm::normalize(crossProduct);
+        }
       }
-    }
+    });
   }
 
   /* parameter v */
@@ -106,11 +191,11 @@ struct MeshData {
   /* storage for the triangles that make the surface of the polygon mesh */
   std::vector<Triangle> triangles;
 
-  /* boundary points of the given polygon */
-  std::vector<glm::dvec3> polygonBoundaries;
-
   /* storage for the arbitrary number of transformations */
   std::vector<glm::dmat4> transformOperations;
+
+  /* derived data (mutable, so const queries can build it on demand) */
+  mutable MeshCache cache;
 };
 
 } // namespace conv
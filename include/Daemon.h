@@ -0,0 +1,168 @@
+#ifndef DAEMON_H
+#define DAEMON_H
+
+#include "BatchConverter.h"
+
+#include <condition_variable>
+#include <filesystem>
+#include <future>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+
+
+namespace conv {
+
+/*
+ * protocol of the daemon: one request per line, one response per line, fields separated by tabs
+ *
+ * requests (the key=value fields after the command, transformations are applied in the given order):
+ *   convert  input=<path> output=<path> [format=<name>] [rotate=x,y,z] [scale=x,y,z] [translate=x,y,z]...
+ *            (without a format the output is written in the format of its extension)
+ *   volume   input=<path> [transformations]
+ *   surface  input=<path> [transformations]
+ *   inside   input=<path> [transformations] point=x,y,z...
+ *   stats
+ *   shutdown
+ *
+ * responses:
+ *   ok [values...]
+ *   error <message>
+ *
+ * a connection sending a longer line than DAEMON_MAX_LINE_SIZE_IN_BYTES gets an error and is closed
+ */
+constexpr char DAEMON_FIELD_SEPARATOR = '\t';
+constexpr size_t DAEMON_MAX_LINE_SIZE_IN_BYTES = 1u << 20u;
+
+/* settings of the daemon */
+struct DaemonOptions {
+  std::string socketPath;
+
+  /* number of meshes kept loaded, the least recently used one is dropped first */
+  size_t maxNumOfMeshes = 16u;
+};
+
+/* counters of the mesh cache of the daemon */
+struct DaemonStatistics {
+  uint64_t hits = 0u;
+  uint64_t misses = 0u;
+  size_t numOfMeshes = 0u;
+};
+
+/* mesh loaded by the daemon, with its acceleration structures built (shared by concurrent requests) */
+struct LoadedMesh {
+  std::shared_ptr<const FileConverter> converter;
+
+  /* state of the file when it was loaded, a changed file is loaded again */
+  std::filesystem::file_time_type modified;
+  uintmax_t size = 0u;
+};
+
+/* least recently used cache of the loaded meshes, concurrent requests of the same file load it once */
+class LoadedMeshCache {
+public:
+  explicit LoadedMeshCache(size_t capacity) : capacity_(std::max<size_t>(capacity, 1u)) {}
+
+  /* function to get the loaded mesh of the file, loading it if needed */
+  std::shared_ptr<const LoadedMesh> get(const std::string& pathToFile);
+
+  DaemonStatistics statistics() const;
+
+private:
+  using Entry = std::shared_future<std::shared_ptr<const LoadedMesh>>;
+
+  /* function to load the file and build its acceleration structures */
+  static std::shared_ptr<const LoadedMesh> load(const std::string& pathToFile);
+
+  /* function to mark the key as the most recently used one */
+  void touch(const std::string& key);
+
+
+  const size_t capacity_;
+  mutable std::mutex mutex_;
+
+  /* keys from the most recently to the least recently used */
+  std::list<std::string> order_;
+  std::unordered_map<std::string, std::pair<Entry, std::list<std::string>::iterator>> entries_;
+
+  uint64_t hits_ = 0u;
+  uint64_t misses_ = 0u;
+};
+
+/*
+ * conversion daemon listening on a Unix domain socket
+ * every connection is served by a thread of its own (blocking on the socket), which also processes its
+ * requests (loads, queries and conversions)
+ */
+class ConversionDaemon {
+public:
+  explicit ConversionDaemon(const DaemonOptions& options);
+  ~ConversionDaemon();
+
+  ConversionDaemon(const ConversionDaemon&) = delete;
+  ConversionDaemon& operator= (const ConversionDaemon&) = delete;
+
+  /* function to serve the connections until stop() or a shutdown request, throws if accepting fails for good */
+  void run();
+
+  /* function to stop serving (can be called from any thread) */
+  void stop();
+
+  /* function to process one request line and get its response line (without the line breaks) */
+  std::string process(const std::string& request);
+
+private:
+  void serve(int connection);
+
+
+  DaemonOptions options_;
+  LoadedMeshCache meshes_;
+
+  int listener_ = -1;
+  std::atomic<bool> stopped_{false};
+
+  /* sockets of the open connections, the destructor waits until every connection is closed */
+  std::mutex connectionsMutex_;
+  std::condition_variable connectionClosed_;
+  std::unordered_set<int> connections_;
+};
+
+/* client of the conversion daemon, failed requests throw std::runtime_error with the message of the daemon */
+class DaemonClient {
+public:
+  explicit DaemonClient(const std::string& socketPath);
+  ~DaemonClient();
+
+  DaemonClient(const DaemonClient&) = delete;
+  DaemonClient& operator= (const DaemonClient&) = delete;
+
+  /* function to convert the file (to the named output format, or by the output extension), returns the number of written triangles */
+  size_t convert(const std::string& inputPath, const std::string& outputPath,
+                 const std::vector<Transform>& transforms = {}, const std::string& format = "");
+
+  double volume(const std::string& inputPath, const std::vector<Transform>& transforms = {});
+  double surface(const std::string& inputPath, const std::vector<Transform>& transforms = {});
+
+  std::vector<bool> isPointInside(const std::string& inputPath, const std::vector<glm::dvec3>& points,
+                                  const std::vector<Transform>& transforms = {});
+
+  DaemonStatistics statistics();
+
+  /* function to ask the daemon to stop */
+  void shutdown();
+
+  /* function to send a request line and get the fields of the response after "ok" */
+  std::vector<std::string> request(const std::string& line);
+
+private:
+  int socket_ = -1;
+
+  /* received bytes after the last response */
+  std::string buffer_;
+};
+
+} // namespace conv
+
+
+#endif // DAEMON_H
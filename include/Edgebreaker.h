@@ -0,0 +1,70 @@
+#ifndef EDGEBREAKER_H
+#define EDGEBREAKER_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+namespace conv {
+
+/*
+ * .3dfe files: the header, the entropy coded symbols, indices (see encodeConnectivity) and positions
+ * (x, y, z as doubles in the order of the decoded vertices)
+ */
+constexpr char EDGEBREAKER_MAGIC[8] = {'3', 'D', 'F', 'C', 'E', 'D', 'G', 'E'};
+constexpr uint32_t EDGEBREAKER_VERSION = 2u;
+constexpr uint32_t EDGEBREAKER_BYTE_ORDER_MARK = 0x01020304u;
+
+/* header at the start of a .3dfe file */
+struct EdgebreakerHeader {
+  char magic[8] = {};
+  uint32_t version = 0u;
+  uint32_t byteOrderMark = 0u;
+  uint64_t numOfVertices = 0u;
+  uint64_t numOfTriangles = 0u;
+  uint64_t numOfSymbols = 0u;
+  uint64_t sizeOfIndices = 0u;
+
+  /* sizes of the entropy coded sections */
+  uint64_t encodedSymbolsSize = 0u;
+  uint64_t encodedIndicesSize = 0u;
+  uint64_t encodedPositionsSize = 0u;
+};
+
+/* connectivity of a triangle mesh encoded by encodeConnectivity */
+struct EncodedConnectivity {
+  /* one symbol per byte (C, L, R, E, S, J, B, N, D) */
+  std::vector<uint8_t> symbols;
+
+  /* variable-length integers of the symbols that need them (offsets, vertex indices) */
+  std::vector<uint8_t> indices;
+
+  /* original index of every vertex in the order of the decoded vertices (unreferenced vertices at the end) */
+  std::vector<uint32_t> vertexOrder;
+};
+
+/*
+ * function to encode the triangles (indices of vertices, counterclockwise) in the style of Edgebreaker:
+ * the triangles are conquered one by one across the gate of the border of the conquered region and only
+ * the position of the third vertex of a triangle is written:
+ *  - C: new vertex, L / R: the vertex before / after the gate on the border, E: both (the region closes)
+ *  - S: a vertex further along the border (offset), J: any other vertex (index)
+ *  - B: no triangle across the gate (border of the mesh), N: start of a component, D: degenerate triangle
+ * manifold meshes take about 2 bits per triangle after entropy coding, other triangle sets are encoded too
+ * (non-manifold edges and vertices take S, J and N symbols)
+ */
+EncodedConnectivity encodeConnectivity(const std::vector<std::array<uint32_t, 3>>& triangles, size_t numOfVertices);
+
+/*
+ * function to decode the triangles of encodeConnectivity, the vertices are numbered in the order of the decoding
+ * (throws if the streams are invalid)
+ */
+std::vector<std::array<uint32_t, 3>> decodeConnectivity(const uint8_t* symbols, size_t numOfSymbols, const uint8_t* indices,
+                                                        size_t sizeOfIndices, size_t numOfTriangles, size_t numOfVertices);
+
+} // namespace conv
+
+
+#endif // EDGEBREAKER_H
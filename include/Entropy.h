@@ -0,0 +1,62 @@
+#ifndef ENTROPY_H
+#define ENTROPY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+
+namespace conv {
+
+/* function to map a signed value to an unsigned one, small magnitudes to small values */
+inline uint64_t zigzag(int64_t value) {
+  return (static_cast<uint64_t>(value) << 1u) ^ static_cast<uint64_t>(value >> 63);
+}
+
+inline int64_t unzigzag(uint64_t value) {
+  return static_cast<int64_t>(value >> 1u) ^ -static_cast<int64_t>(value & 1u);
+}
+
+/* function to append the value as a variable-length integer (7 bits per byte, least significant first) */
+inline void appendVarint(std::vector<uint8_t>& bytes, uint64_t value) {
+  while (value >= 0x80u) {
+    bytes.push_back(static_cast<uint8_t>(value | 0x80u));
+    value >>= 7u;
+  }
+  bytes.push_back(static_cast<uint8_t>(value));
+}
+
+/* function to read a variable-length integer, position is moved after it */
+inline uint64_t readVarint(const uint8_t*& position, const uint8_t* end) {
+  uint64_t value = 0u;
+  for (uint32_t shift = 0u; shift < 64u; shift += 7u) {
+    if (position == end) {
+      throw std::runtime_error("Truncated variable-length integer");
+    }
+
+    const uint8_t byte = *position++;
+    value |= static_cast<uint64_t>(byte & 0x7Fu) << shift;
+    if (byte < 0x80u) {
+      return value;
+    }
+  }
+  throw std::runtime_error("Invalid variable-length integer");
+}
+
+/*
+ * function to compress the bytes with an order-0 range asymmetric numeral system coder
+ * the frequencies are scaled to 12 bits and stored before the stream, bytes that do not compress are stored as they are
+ */
+std::vector<uint8_t> entropyEncode(const std::vector<uint8_t>& bytes);
+
+/* function to get the largest number of bytes a stream of encodedSize bytes can decode to */
+uint64_t entropyMaxDecodedSize(uint64_t encodedSize);
+
+/* function to decompress the output of entropyEncode, at most maxSize bytes (throws if it is invalid) */
+std::vector<uint8_t> entropyDecode(const uint8_t* bytes, size_t size, size_t maxSize);
+
+} // namespace conv
+
+
+#endif // ENTROPY_H
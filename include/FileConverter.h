@@ -1,37 +1,138 @@
 #ifndef FILE_CONVERTER_H
 #define FILE_CONVERTER_H
 
+#include "Bvh.h"
+#include "FormatRegistry.h"
+#include "MappedFile.h"
+#include "NativeMesh.h"
+#include "Octree.h"
+#include "ReadEdgebreaker.h"
+#include "ReadNative.h"
 #include "ReadObj.h"
+#include "ReadOff.h"
+#include "ReadPacked.h"
+#include "ReadPly.h"
+#include "ReadStl.h"
+#include "ReadStlAscii.h"
+#include "VertexCache.h"
+#include "Write3mf.h"
+#include "WriteEdgebreaker.h"
+#include "WriteGlb.h"
+#include "WriteNative.h"
+#include "WriteObj.h"
+#include "WriteOff.h"
+#include "WritePacked.h"
+#include "WritePly.h"
 #include "WriteStl.h"
+#include "WriteStlAscii.h"
+
+#include <future>
 
 
 namespace conv {
 
+/* relation of a probe segment and a triangle */
+enum class SegmentCrossing : uint8_t {
+  CROSSING_NONE = 0u,
+  CROSSING_PROPER,
+  CROSSING_DEGENERATE,
+  CROSSING_START_ON_TRIANGLE
+};
+
+/* settings of an asynchronous operation */
+struct AsyncOptions {
+  /* token to cancel the operation, checked between its blocks of work */
+  CancellationToken cancellation;
+
+  /* called with the done fraction [0, 1] of the operation */
+  ProgressCallback progress;
+
+  /* called when the operation is finished, with its exception (null on success), before the future is ready */
+  std::function<void(std::exception_ptr)> completion;
+};
+
+/*
+ * converter session: owns its mesh, reader and writer
+ * independent sessions share no state, so they can convert concurrently on separate threads
+ * (a single session must not be used from several threads at the same time)
+ */
 class FileConverter {
 public:
-  /* singleton lazy initialization (thread-safe) */
+  /* default session shared by the whole process (lazy initialization, thread-safe) */
   static FileConverter& getInstance() {
     static FileConverter instance;
     return instance;
   }
 
-  /* no need for constructors because of singleton */
+  FileConverter() = default;
+  ~FileConverter() = default;
+
+  /* a session owns its mesh, it can be moved but not copied */
   FileConverter(const FileConverter&) = delete;
   FileConverter& operator= (const FileConverter&) = delete;
-  FileConverter& operator= (FileConverter&&) = delete;
-  FileConverter(FileConverter&&) = delete;
+  FileConverter& operator= (FileConverter&&) = default;
+  FileConverter(FileConverter&&) = default;
 
-  /* function to set input converter type */
+  /* function to set input converter type (INPUT_TYPE_AUTO detects the format of every read file) */
   void setInputFormat(InputType input);
 
-  /* function to set output converter type */
+  /* function to set output converter type (OUTPUT_TYPE_AUTO chooses it by the extension of every written path) */
   void setOutputFormat(OutputType output);
 
+  /* functions to set a configured reader or writer object (for example a welding ReadStl) */
+  void setReader(std::unique_ptr<Reader> reader);
+  void setWriter(std::unique_ptr<Writer> writer);
+
+  /* function to get the format of the last read file (nullptr before the first read in automatic mode and for a reader set directly) */
+  const ReaderFormat* inputFormat() const {
+    return inputFormat_;
+  }
+
   /* function to read 3D polygon data from file */
-  void read(const std::string& pathToFile);
+  void read(const std::string& pathToFile, const Progress& progress = Progress());
+
+  /* function to read 3D polygon data from the bytes of a whole file in memory (the bytes are not kept) */
+  void read(const uint8_t* bytes, size_t size, const Progress& progress = Progress());
+
+  /*
+   * function to read 3D polygon data from the mapping of the file at the path (for callers that already mapped it),
+   * readers that cannot parse from memory read the file at the path themselves
+   */
+  void read(const MappedFile& file, const std::string& pathToFile, const Progress& progress = Progress());
 
   /* function to write 3D polygon data to file */
-  void write(const std::string& pathToFile);
+  void write(const std::string& pathToFile, const Progress& progress = Progress());
+
+  /*
+   * functions to write 3D polygon data to a stream or append it to a buffer, without touching the filesystem
+   * (the output format must be set, OUTPUT_TYPE_AUTO has no extension to choose it by)
+   */
+  void write(std::ostream& stream, const Progress& progress = Progress());
+  void write(std::vector<uint8_t>& buffer, const Progress& progress = Progress());
+
+  /*
+   * asynchronous variants of read and write, and of a read followed by a write
+   * the operations run as tasks of the library's scheduler, a cancelled operation throws OperationCancelled
+   * the session must stay alive and must not be used otherwise until the future is ready
+   */
+  std::future<void> readAsync(const std::string& pathToFile, const AsyncOptions& options = AsyncOptions());
+  std::future<void> writeAsync(const std::string& pathToFile, const AsyncOptions& options = AsyncOptions());
+  std::future<void> convertAsync(const std::string& inputPath, const std::string& outputPath,
+                                 const AsyncOptions& options = AsyncOptions());
+
+  /* function to get the internally stored 3D polygon */
+  const MeshData& mesh() const {
+    return data_;
+  }
+
+  /* function to replace the internally stored 3D polygon (its derived data is kept if it is still valid) */
+  void setMesh(MeshData data);
+
+  /*
+   * function to build the acceleration structures and properties of the queries ahead of time,
+   * afterwards the const queries (except the vertex queries) only read the session and can run concurrently
+   */
+  void buildQueryStructures() const;
 
   /* function to rotate the internally stored 3D polygon */
   void rotate(const glm::dvec3& rotate);
@@ -42,8 +143,29 @@ public:
   /* function to translate the internally stored 3D polygon */
   void translate(const glm::dvec3& translate);
 
+  /* function to reorder the triangles and vertices of the 3D polygon for the vertex cache of GPUs, returns the ACMR before and after */
+  VertexCacheStatistics optimizeVertexCache();
+
   /* function to check whether the given point is inside the 3D polygon */
-  bool isPointInside(const glm::dvec3& point);
+  bool isPointInside(const glm::dvec3& point) const;
+  std::vector<bool> isPointInside(const std::vector<glm::dvec3>& points) const;
+
+  /* function to find the closest intersection of every ray with the 3D polygon */
+  std::vector<RayHit> firstHits(const std::vector<Ray>& rays) const;
+
+  /* function to find an arbitrary intersection of every ray with the 3D polygon (occlusion test) */
+  std::vector<RayHit> anyHits(const std::vector<Ray>& rays) const;
+
+  /* function to find every intersection of every ray with the 3D polygon, ordered along the ray */
+  std::vector<std::vector<RayHit>> allHits(const std::vector<Ray>& rays) const;
+
+  /* function to find every vertex within the radius of the point, ordered by distance */
+  std::vector<VertexNeighbour> verticesWithinRadius(const glm::dvec3& point, double radius) const;
+  std::vector<std::vector<VertexNeighbour>> verticesWithinRadius(const std::vector<glm::dvec3>& points, double radius) const;
+
+  /* function to find the k nearest vertices of the point, ordered by distance */
+  std::vector<VertexNeighbour> nearestVertices(const glm::dvec3& point, size_t k) const;
+  std::vector<std::vector<VertexNeighbour>> nearestVertices(const std::vector<glm::dvec3>& points, size_t k) const;
 
   /* function to calculate the volume of the 3D polygon */
   double volume() const;
@@ -51,43 +173,48 @@ public:
   /* function to calculate the surface of the 3D polygon */
   double surface() const;
 
+  /* function to get volume, surface, centroid, inertia tensor and bounding box of the 3D polygon (cached) */
+  const MeshProperties& properties() const;
+
 private:
-  explicit FileConverter() {
-    data_ = MeshData();
-    data_.clear();
-  }
-  ~FileConverter() = default;
+  /* function to detect the format of the bytes of a whole file in automatic mode and create its reader */
+  void detectInput(const uint8_t* bytes, size_t size, const std::string& name);
+
+  /* function to run the operation on the scheduler */
+  std::future<void> runAsync(std::function<void(const Progress&)> operation, const AsyncOptions& options);
 
-  /* function to summarize the operations and transform every vertex and normal with it */
-  void transform();
+  /* function to summarize the operations, transform every vertex and normal with it and return the matrix */
+  glm::dmat4 transform();
 
-  /* function to calculate the boundary points of the 3D polygon */
-  void calculateBoundaryPoints();
+  /* function to get the acceleration structure over the triangles (built on first use) */
+  const Bvh& bvh() const;
 
-  /* function to check whether the given point is outside of the 3D polygon */
-  bool isPointOutsideOfBoundaries(const glm::dvec3& point);
+  /* function to get the spatial index over the vertices (built on first use) */
+  const VertexOctree& vertexOctree() const;
 
-  /* function to calculate the signed volume of a given tetrahedron (A,B,C,D) */
-  double calculateSignedVolume(const glm::dvec3& pointA, const glm::dvec3& pointB,
-                               const glm::dvec3& pointC, const glm::dvec3& pointD) const;
+  /* function to calculate every property of the 3D polygon in one pass over the triangles */
+  MeshProperties calculateProperties() const;
 
-  /* function to check if there is an intersection between the point P and triangle ABC */
-  bool hasIntersection(const glm::dvec3& pointP, const glm::dvec3& pointQ,
-                       const glm::dvec3& pointA, const glm::dvec3& pointB, const glm::dvec3& pointC) const;
+  /* function to move the previously calculated properties along a rigid transformation */
+  void updateRigidProperties(const std::shared_ptr<const MeshProperties>& previous, const glm::dmat4& matrix);
 
-  /* function to calculate the area of a given triangle */
-  double calculateAreaOfTriangle(const glm::dvec3& pointA, const glm::dvec3& pointB, const glm::dvec3& pointC) const;
+  /* function to check whether the given point is outside of the boundary box of the 3D polygon */
+  bool isPointOutsideOfBoundaries(const glm::dvec3& point) const;
 
-  /* function to check whether the given point intersects an arbitrary triangle */
-  bool intersectsTriangle(const glm::dvec3& probePoint, const glm::dvec3& pointA,
-                          const glm::dvec3& pointB, const glm::dvec3& pointC) const;
+  /* function to classify how the segment PQ crosses the triangle ABC */
+  SegmentCrossing classifyCrossing(const glm::dvec3& pointP, const glm::dvec3& pointQ,
+                                   const glm::dvec3& pointA, const glm::dvec3& pointB, const glm::dvec3& pointC) const;
 
 
-  /* private variable to store file reader object */
+  /* private variables to store file reader object and its format */
   std::unique_ptr<Reader> reader_;
+  const ReaderFormat* inputFormat_ = nullptr;
+  bool isInputDetected_ = false;
 
-  /* private variable to store file writer object */
+  /* private variables to store file writer object and its format */
   std::unique_ptr<Writer> writer_;
+  const WriterFormat* outputFormat_ = nullptr;
+  bool isOutputByExtension_ = false;
 
   /* private variable to store 3D polygon information internally */
   MeshData data_;
@@ -0,0 +1,101 @@
+#ifndef FORMAT_REGISTRY_H
+#define FORMAT_REGISTRY_H
+
+#include "Reader.h"
+#include "Writer.h"
+
+#include <functional>
+#include <mutex>
+
+
+namespace conv {
+
+/* number of bytes at the start of a file looked at by the format detection */
+constexpr size_t SNIFF_SIZE_IN_BYTES = 4096u;
+
+/* capabilities of a reader, the converter picks the fastest way of reading with them */
+enum ReaderCapability : uint32_t {
+  READER_CAPABILITY_NONE = 0u,
+
+  /* parses the file from memory, so it is memory mapped instead of read into a buffer */
+  READER_CAPABILITY_MMAP = 1u << 0u
+};
+
+/*
+ * function to rate the start of a file (at most SNIFF_SIZE_IN_BYTES bytes) and the size of the whole file
+ * returns 0 if the bytes cannot start a file of the format, higher values for more certain matches
+ * (100 for magic bytes, less for keywords of text formats)
+ */
+using Sniffer = std::function<int(const uint8_t* bytes, size_t size, uint64_t fileSize)>;
+
+/* input format known by the registry */
+struct ReaderFormat {
+  InputType type = InputType::INPUT_TYPE_UNKNOWN;
+  std::string name;
+  uint32_t capabilities = READER_CAPABILITY_NONE;
+  Sniffer sniff;
+  std::function<std::unique_ptr<Reader>()> create;
+};
+
+/* output format known by the registry */
+struct WriterFormat {
+  OutputType type = OutputType::OUTPUT_TYPE_UNKNOWN;
+  std::string name;
+
+  /* file extensions of the format (lower case, with the dot) */
+  std::vector<std::string> extensions;
+  std::function<std::unique_ptr<Writer>()> create;
+};
+
+/*
+ * registry of the reader and writer factories
+ * input formats are detected from the first bytes of the file (magic bytes, keywords), never from the
+ * extension, output formats are chosen by type, name or the extension of the output path
+ */
+class FormatRegistry {
+public:
+  /* function to get the registry of the process with the built-in formats */
+  static FormatRegistry& instance();
+
+  FormatRegistry() = default;
+  ~FormatRegistry() = default;
+
+  FormatRegistry(const FormatRegistry&) = delete;
+  FormatRegistry& operator= (const FormatRegistry&) = delete;
+
+  /* function to add a format (a format of the same type replaces the registered one) */
+  void registerReader(const ReaderFormat& format);
+  void registerWriter(const WriterFormat& format);
+
+  /* functions to find a format, they return nullptr if there is none */
+  const ReaderFormat* reader(InputType type) const;
+  const WriterFormat* writer(OutputType type) const;
+  const WriterFormat* writer(const std::string& name) const;
+  const WriterFormat* writerForPath(const std::string& pathToFile) const;
+
+  /* function to detect the format of the bytes (the start of a file of the given size) */
+  const ReaderFormat* detect(const uint8_t* bytes, size_t size, uint64_t fileSize) const;
+
+  /* function to detect the format of the file from its first bytes */
+  const ReaderFormat* detect(const std::string& pathToFile) const;
+
+private:
+  /* function to add the formats implemented by the library */
+  void registerBuiltInFormats();
+
+
+  mutable std::mutex mutex_;
+
+  /* every format ever registered, kept alive so the returned pointers stay valid after a replacement */
+  std::vector<std::unique_ptr<ReaderFormat>> storedReaders_;
+  std::vector<std::unique_ptr<WriterFormat>> storedWriters_;
+
+  /* the current format of every type */
+  std::vector<const ReaderFormat*> readers_;
+  std::vector<const WriterFormat*> writers_;
+};
+
+} // namespace conv
+
+
+#endif // FORMAT_REGISTRY_H
@@ -0,0 +1,20 @@
+#ifndef HASH_H
+#define HASH_H
+
+#include <cstddef>
+#include <cstdint>
+
+
+namespace conv {
+
+/*
+ * function to calculate the XXH64 hash of the bytes
+ * four independent lanes consume 32 bytes per step, so the hash runs at about memory bandwidth
+ * (the input is read as little endian words)
+ */
+uint64_t hash64(const void* data, size_t size, uint64_t seed = 0u);
+
+} // namespace conv
+
+
+#endif // HASH_H
@@ -0,0 +1,46 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+
+namespace conv {
+
+/*
+ * read-only memory mapping of a whole file
+ * the pages are loaded by the kernel on first access, without copying them into a buffer
+ */
+class MappedFile {
+public:
+  explicit MappedFile(const std::string& pathToFile);
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator= (const MappedFile&) = delete;
+
+  MappedFile(MappedFile&& other) noexcept;
+  MappedFile& operator= (MappedFile&& other) noexcept;
+
+  /* function to get the bytes of the file (nullptr for an empty file) */
+  const uint8_t* data() const {
+    return data_;
+  }
+
+  size_t size() const {
+    return size_;
+  }
+
+private:
+  void unmap();
+
+
+  const uint8_t* data_ = nullptr;
+  size_t size_ = 0u;
+};
+
+} // namespace conv
+
+
+#endif // MAPPED_FILE_H
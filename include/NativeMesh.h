@@ -0,0 +1,145 @@
+#ifndef NATIVE_MESH_H
+#define NATIVE_MESH_H
+
+#include "Core.h"
+#include "MappedFile.h"
+#include "Progress.h"
+
+#include <optional>
+
+
+namespace conv {
+
+/*
+ * native .3dfc format, a little endian image of the arrays of MeshData:
+ * a header with the counts and the checksums, followed by sections aligned to NATIVE_SECTION_ALIGNMENT bytes
+ * the references of the faces are stored as one array per kind plus the offset of every face in it
+ * (offsets of numOfFaces + 1 entries, or none if no face has references of the kind)
+ */
+constexpr char NATIVE_MAGIC[8] = {'3', 'D', 'F', 'C', 'M', 'E', 'S', 'H'};
+constexpr uint32_t NATIVE_VERSION = 1u;
+constexpr uint32_t NATIVE_BYTE_ORDER_MARK = 0x01020304u;
+constexpr size_t NATIVE_SECTION_ALIGNMENT = 64u;
+
+/* enum for the sections of a .3dfc file, in the order they are stored */
+enum NativeSection : uint32_t {
+  NATIVE_SECTION_GEOMETRIC_VERTICES = 0u,
+  NATIVE_SECTION_TEXTURE_VERTICES,
+  NATIVE_SECTION_VERTEX_NORMALS,
+  NATIVE_SECTION_GEOMETRIC_OFFSETS,
+  NATIVE_SECTION_GEOMETRIC_REFERENCES,
+  NATIVE_SECTION_TEXTURE_OFFSETS,
+  NATIVE_SECTION_TEXTURE_REFERENCES,
+  NATIVE_SECTION_NORMAL_OFFSETS,
+  NATIVE_SECTION_NORMAL_REFERENCES,
+
+  NATIVE_NUM_OF_SECTIONS
+};
+
+/* position, number of elements and XXH64 hash of a section */
+struct NativeSectionEntry {
+  uint64_t offset = 0u;
+  uint64_t count = 0u;
+  uint64_t checksum = 0u;
+};
+
+/* header at the start of a .3dfc file, the checksum covers every byte before it */
+struct NativeHeader {
+  char magic[8] = {};
+  uint32_t version = 0u;
+  uint32_t byteOrderMark = 0u;
+  uint64_t numOfFaces = 0u;
+  NativeSectionEntry sections[NATIVE_NUM_OF_SECTIONS];
+  uint64_t checksum = 0u;
+};
+
+/* read-only array inside the bytes of a .3dfc file */
+template <typename T>
+struct NativeArray {
+  const T* data = nullptr;
+  size_t size = 0u;
+
+  const T* begin() const {
+    return data;
+  }
+
+  const T* end() const {
+    return data + size;
+  }
+
+  const T& operator[] (size_t i) const {
+    return data[i];
+  }
+};
+
+/*
+ * view of a .3dfc file, the arrays point into the mapping of the file (or the given bytes) without copying
+ * opening checks only the header and the bounds of the sections, so it costs the same for any size of mesh,
+ * verify() checks the checksums and the references of the faces
+ * (given bytes that are not aligned to NATIVE_SECTION_ALIGNMENT are copied once, so the arrays are aligned)
+ */
+class NativeMesh {
+public:
+  /* function to map the file, the mapping is owned by the view */
+  explicit NativeMesh(const std::string& pathToFile);
+
+  /* function to view the bytes, which have to outlive the view (unless they are unaligned and copied) */
+  NativeMesh(const uint8_t* bytes, size_t size);
+
+  size_t numOfFaces() const {
+    return static_cast<size_t>(header_.numOfFaces);
+  }
+
+  NativeArray<glm::dvec4> geometricVertices() const {
+    return section<glm::dvec4>(NATIVE_SECTION_GEOMETRIC_VERTICES);
+  }
+
+  NativeArray<glm::dvec3> textureVertices() const {
+    return section<glm::dvec3>(NATIVE_SECTION_TEXTURE_VERTICES);
+  }
+
+  NativeArray<glm::dvec3> vertexNormals() const {
+    return section<glm::dvec3>(NATIVE_SECTION_VERTEX_NORMALS);
+  }
+
+  /* offsets and references of a kind: NATIVE_SECTION_GEOMETRIC_OFFSETS, _TEXTURE_OFFSETS or _NORMAL_OFFSETS */
+  NativeArray<uint64_t> offsets(NativeSection kind) const {
+    return section<uint64_t>(kind);
+  }
+
+  NativeArray<uint32_t> references(NativeSection kind) const {
+    return section<uint32_t>(static_cast<NativeSection>(kind + 1u));
+  }
+
+  /* function to check the checksums of the sections and the references of the faces (throws if they are invalid) */
+  void verify(const Progress& progress = Progress()) const;
+
+  /* function to copy the mesh into the data structure of the converter (the triangles are updated) */
+  void copyTo(MeshData& data, const Progress& progress = Progress()) const;
+
+  /* function to get the size of the elements of a section */
+  static size_t elementSize(NativeSection section);
+
+private:
+  void open(const uint8_t* bytes, size_t size);
+
+  template <typename T>
+  NativeArray<T> section(NativeSection s) const {
+    return {reinterpret_cast<const T*>(bytes_ + header_.sections[s].offset), static_cast<size_t>(header_.sections[s].count)};
+  }
+
+
+  std::optional<MappedFile> file_;
+
+  /* aligned copy of unaligned bytes (the first bytes up to the alignment are unused) */
+  std::vector<uint8_t> copy_;
+
+  const uint8_t* bytes_ = nullptr;
+  size_t size_ = 0u;
+  NativeHeader header_;
+};
+
+} // namespace conv
+
+
+#endif // NATIVE_MESH_H
@@ -0,0 +1,74 @@
+#ifndef OCTREE_H
+#define OCTREE_H
+
+#include "Core.h"
+
+
+namespace conv {
+
+/* vertex found by a neighbourhood query: index into MeshData::geometricVertices and its squared distance */
+struct VertexNeighbour {
+  uint32_t vertex = 0u;
+  double squaredDistance = 0.0;
+};
+
+/* node of the octree, the children of a node are stored next to each other */
+struct OctreeNode {
+  /* tight bounds of the vertices below the node */
+  glm::dvec3 boundsMin;
+  glm::dvec3 boundsMax;
+
+  /* first sorted vertex and number of vertices below the node */
+  uint32_t first = 0u;
+  uint32_t count = 0u;
+
+  /* index of the first child and number of (non-empty) children, 0 for leaves */
+  uint32_t firstChild = 0u;
+  uint32_t numOfChildren = 0u;
+};
+
+/*
+ * octree over the geometric vertices of a mesh
+ * the vertices are sorted by the Morton codes of their quantized positions, so every node covers a
+ * contiguous range of the sorted vertices and the children of a node split its range by the next 3 bits
+ */
+class VertexOctree {
+public:
+  explicit VertexOctree(const std::vector<glm::dvec4>& vertices);
+  ~VertexOctree() = default;
+
+  /* function to find every vertex within the radius of the point, ordered by distance */
+  std::vector<VertexNeighbour> withinRadius(const glm::dvec3& point, double radius) const;
+
+  /* function to find the k nearest vertices of the point, ordered by distance */
+  std::vector<VertexNeighbour> nearest(const glm::dvec3& point, size_t k) const;
+
+  /* batched variants of the queries (the points are processed in parallel) */
+  std::vector<std::vector<VertexNeighbour>> withinRadius(const std::vector<glm::dvec3>& points, double radius) const;
+  std::vector<std::vector<VertexNeighbour>> nearest(const std::vector<glm::dvec3>& points, size_t k) const;
+
+  /* function to get the number of nodes of the tree */
+  size_t nodeCount() const {
+    return nodes_.size();
+  }
+
+private:
+  /* function to build the subtree over the sorted vertices [first, first + count) at the given depth */
+  void build(uint32_t nodeIndex, uint32_t depth);
+
+
+  /* nodes of the tree, the root is nodes_[0] */
+  std::vector<OctreeNode> nodes_;
+
+  /* Morton codes of the sorted vertices */
+  std::vector<uint64_t> codes_;
+
+  /* vertex indices and positions in Morton order */
+  std::vector<uint32_t> vertexIds_;
+  std::vector<glm::dvec3> positions_;
+};
+
+} // namespace conv
+
+
+#endif // OCTREE_H
@@ -0,0 +1,76 @@
+#ifndef OUTPUT_BUFFER_H
+#define OUTPUT_BUFFER_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <streambuf>
+#include <vector>
+
+
+namespace conv {
+
+/*
+ * stream buffer appending the written bytes to a caller-provided byte vector (the vector grows as needed)
+ * positions are counted from the size of the vector at construction, seeking back overwrites the bytes
+ * written before (the .3mf writer fills in its headers that way)
+ */
+class OutputBuffer : public std::streambuf {
+public:
+  explicit OutputBuffer(std::vector<uint8_t>& buffer)
+    : buffer_(buffer), origin_(buffer.size()), position_(buffer.size()) {
+  }
+
+  OutputBuffer(const OutputBuffer&) = delete;
+  OutputBuffer& operator= (const OutputBuffer&) = delete;
+
+protected:
+  std::streamsize xsputn(const char* bytes, std::streamsize count) override {
+    const size_t size = static_cast<size_t>(count);
+    const size_t overwritten = std::min(size, buffer_.size() - position_);
+    std::memcpy(buffer_.data() + position_, bytes, overwritten);
+    buffer_.insert(buffer_.end(), bytes + overwritten, bytes + size);
+    position_ += size;
+    return count;
+  }
+
+  int_type overflow(int_type c) override {
+    if (traits_type::eq_int_type(c, traits_type::eof())) {
+      return traits_type::not_eof(c);
+    }
+
+    const char byte = traits_type::to_char_type(c);
+    xsputn(&byte, 1);
+    return c;
+  }
+
+  pos_type seekoff(off_type offset, std::ios_base::seekdir direction, std::ios_base::openmode which) override {
+    off_type base = 0;
+    if (direction == std::ios_base::cur) {
+      base = static_cast<off_type>(position_ - origin_);
+    } else if (direction == std::ios_base::end) {
+      base = static_cast<off_type>(buffer_.size() - origin_);
+    }
+    return seekpos(pos_type(base + offset), which);
+  }
+
+  pos_type seekpos(pos_type position, std::ios_base::openmode which) override {
+    const off_type offset = position;
+    if (!(which & std::ios_base::out) || offset < 0 || static_cast<size_t>(offset) > buffer_.size() - origin_) {
+      return pos_type(off_type(-1));
+    }
+
+    position_ = origin_ + static_cast<size_t>(offset);
+    return position;
+  }
+
+private:
+  std::vector<uint8_t>& buffer_;
+  const size_t origin_;
+  size_t position_;
+};
+
+} // namespace conv
+
+
+#endif // OUTPUT_BUFFER_H
@@ -0,0 +1,59 @@
+#ifndef PACKED_FORMAT_H
+#define PACKED_FORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+
+
+namespace conv {
+
+/*
+ * compressed .3dfz format for archiving the geometry of meshes (positions and faces, without normals and
+ * texture vertices):
+ * a header followed by the blocks of the vertices and then the blocks of the faces, every block is
+ * entropy coded on its own (see Entropy.h), so the blocks are decoded in parallel or one after the other
+ *  - vertices: positions quantized within the bounding box, as zigzag deltas of the previous vertex of the block
+ *  - faces: number of vertices and the indices, as the distance below the number of vertices referenced
+ *    before the index (the vertices are numbered in the order of their first use, so new vertices are 0)
+ */
+constexpr char PACKED_MAGIC[8] = {'3', 'D', 'F', 'C', 'P', 'A', 'C', 'K'};
+constexpr uint32_t PACKED_VERSION = 2u;
+constexpr uint32_t PACKED_BYTE_ORDER_MARK = 0x01020304u;
+
+/* range of the number of bits of a quantized coordinate */
+constexpr uint32_t PACKED_MIN_QUANTIZATION_BITS = 1u;
+constexpr uint32_t PACKED_MAX_QUANTIZATION_BITS = 30u;
+
+/* number of vertices or faces of a block */
+constexpr size_t PACKED_BLOCK_SIZE = 65536u;
+
+/* header at the start of a .3dfz file */
+struct PackedHeader {
+  char magic[8] = {};
+  uint32_t version = 0u;
+  uint32_t byteOrderMark = 0u;
+  uint32_t quantizationBits = 0u;
+  uint32_t reserved = 0u;
+  uint64_t numOfVertices = 0u;
+  uint64_t numOfFaces = 0u;
+  double boundsMin[3] = {};
+  double boundsMax[3] = {};
+  uint32_t numOfVertexBlocks = 0u;
+  uint32_t numOfFaceBlocks = 0u;
+};
+
+/* header of a block, followed by encodedSize bytes */
+struct PackedBlockHeader {
+  /* number of vertices or faces */
+  uint32_t count = 0u;
+
+  /* number of vertices referenced by the faces before the block (face blocks) */
+  uint32_t watermark = 0u;
+
+  uint32_t encodedSize = 0u;
+};
+
+} // namespace conv
+
+
+#endif // PACKED_FORMAT_H
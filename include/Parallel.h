@@ -0,0 +1,69 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include "Scheduler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
+
+namespace conv {
+
+/*
+ * function to call body(begin, end) for the consecutive blocks [k * grainSize, (k + 1) * grainSize) of [0, count)
+ * the blocks are handed out to runners queued on the work-stealing scheduler, the calling thread is one of them,
+ * so nested calls share the workers of the scheduler instead of starting threads of their own
+ * the first exception thrown by the body is rethrown after every runner has finished
+ */
+template <typename Body>
+void parallelFor(size_t count, size_t grainSize, const Body& body) {
+  grainSize = std::max<size_t>(grainSize, 1u);
+  const size_t numOfBlocks = (count + grainSize - 1u) / grainSize;
+  const size_t numOfRunners = std::min<size_t>(numOfBlocks, Scheduler::instance().concurrency());
+
+  /* not worth queueing tasks */
+  if (numOfRunners <= 1u) {
+    for (size_t begin = 0u; begin < count; begin += grainSize) {
+      body(begin, std::min(count, begin + grainSize));
+    }
+    return;
+  }
+
+  /* runners started late (every worker busy) find no blocks left and return at once */
+  std::atomic<size_t> nextBlock{0u};
+  auto runner = [&]() {
+    try {
+      for (size_t block = nextBlock++; block < numOfBlocks; block = nextBlock++) {
+        body(block * grainSize, std::min(count, (block + 1u) * grainSize));
+      }
+    } catch (...) {
+      /* skip the remaining blocks */
+      nextBlock = numOfBlocks;
+      throw;
+    }
+  };
+
+  TaskGroup group;
+  for (size_t i = 1u; i < numOfRunners; ++i) {
+    group.run(runner);
+  }
+
+  /* the calling thread is a runner too */
+  std::exception_ptr error;
+  try {
+    runner();
+  } catch (...) {
+    error = std::current_exception();
+  }
+  group.wait();
+
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+} // namespace conv
+
+
+#endif // PARALLEL_H
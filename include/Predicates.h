@@ -0,0 +1,22 @@
+#ifndef PREDICATES_H
+#define PREDICATES_H
+
+#include "Core.h"
+
+
+namespace conv {
+
+/*
+ * robust orientation predicate (after Shewchuk, "Adaptive Precision Floating-Point Arithmetic
+ * and Fast Robust Geometric Predicates")
+ * returns the exact sign of dot(cross(b - a, c - a), d - a):
+ * 1 if d lies on the side of the plane (a, b, c) the normal points to, -1 on the other side and 0 if coplanar
+ * the floating-point result is used when a forward error bound proves its sign, otherwise the
+ * determinant is evaluated exactly with floating-point expansions
+ */
+int8_t orient3d(const glm::dvec3& a, const glm::dvec3& b, const glm::dvec3& c, const glm::dvec3& d);
+
+} // namespace conv
+
+
+#endif // PREDICATES_H
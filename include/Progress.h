@@ -0,0 +1,107 @@
+#ifndef PROGRESS_H
+#define PROGRESS_H
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+
+
+namespace conv {
+
+/* exception thrown by an operation that noticed its cancellation */
+class OperationCancelled : public std::runtime_error {
+public:
+  OperationCancelled() : std::runtime_error("Operation cancelled") {}
+};
+
+/*
+ * cooperative cancellation flag, the copies of a token share the flag
+ * the caller keeps a copy to cancel, the running operation checks it between its blocks of work
+ */
+class CancellationToken {
+public:
+  CancellationToken() : cancelled_(std::make_shared<std::atomic<bool>>(false)) {}
+
+  void cancel() const {
+    *cancelled_ = true;
+  }
+
+  bool isCancelled() const {
+    return *cancelled_;
+  }
+
+private:
+  std::shared_ptr<std::atomic<bool>> cancelled_;
+};
+
+/* callback receiving the done fraction [0, 1] of an operation */
+using ProgressCallback = std::function<void(double)>;
+
+/*
+ * progress of a running operation, passed to the readers and writers
+ * the parallel blocks of an operation report from several threads, the callback is called
+ * under a lock and only with increasing fractions, so it does not have to be thread-safe
+ */
+class Progress {
+public:
+  Progress() = default;
+  Progress(const CancellationToken& cancellation, ProgressCallback callback)
+      : cancellation_(cancellation), state_(std::make_shared<State>()) {
+    state_->callback = std::move(callback);
+  }
+
+  /* function to get the progress of a part of the operation, mapping its [0, 1] onto [first, last] */
+  Progress part(double first, double last) const {
+    Progress result(*this);
+    result.offset_ = offset_ + first * scale_;
+    result.scale_ = (last - first) * scale_;
+    return result;
+  }
+
+  /* function to throw OperationCancelled if the operation has been cancelled */
+  void checkCancelled() const {
+    if (cancellation_ && cancellation_->isCancelled()) {
+      throw OperationCancelled();
+    }
+  }
+
+  /* function to report the done fraction of the operation (cancellation point) */
+  void update(double fraction) const {
+    checkCancelled();
+
+    if (!state_ || !state_->callback) {
+      return;
+    }
+
+    fraction = offset_ + fraction * scale_;
+
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    if (fraction > state_->reported) {
+      state_->reported = fraction;
+      state_->callback(fraction);
+    }
+  }
+
+private:
+  struct State {
+    ProgressCallback callback;
+    double reported = -1.0;
+    std::mutex mutex;
+  };
+
+  /* the default progress reports to nobody and cannot be cancelled */
+  std::optional<CancellationToken> cancellation_;
+  std::shared_ptr<State> state_;
+
+  /* mapping of the fractions of a part onto the whole operation */
+  double offset_ = 0.0;
+  double scale_ = 1.0;
+};
+
+} // namespace conv
+
+
+#endif // PROGRESS_H
@@ -0,0 +1,24 @@
+#ifndef READEDGEBREAKER_H
+#define READEDGEBREAKER_H
+
+#include "Reader.h"
+
+namespace conv {
+
+/*
+ * reader of the .3dfe files (see Edgebreaker.h)
+ * the sections are decoded from the mapping of the file, the triangles become faces of three vertices
+ */
+class ReadEdgebreaker : public Reader {
+public:
+  ReadEdgebreaker() = default;
+  virtual ~ReadEdgebreaker() = default;
+
+  using Reader::read;
+  virtual void read(const std::string& pathToFile, MeshData& data, const Progress& progress);
+  virtual void read(const uint8_t* bytes, size_t size, MeshData& data, const Progress& progress);
+};
+
+} // namespace conv
+
+#endif // READEDGEBREAKER_H
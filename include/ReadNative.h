@@ -0,0 +1,24 @@
+#ifndef READNATIVE_H
+#define READNATIVE_H
+
+#include "Reader.h"
+
+namespace conv {
+
+/*
+ * reader of the native .3dfc files (see NativeMesh.h)
+ * the sections are verified and copied from the mapping of the file as whole arrays, without any parsing
+ */
+class ReadNative : public Reader {
+public:
+  ReadNative() = default;
+  virtual ~ReadNative() = default;
+
+  using Reader::read;
+  virtual void read(const std::string& pathToFile, MeshData& data, const Progress& progress);
+  virtual void read(const uint8_t* bytes, size_t size, MeshData& data, const Progress& progress);
+};
+
+} // namespace conv
+
+#endif // READNATIVE_H
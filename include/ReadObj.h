@@ -10,7 +10,9 @@ public:
   ReadObj() = default;
   virtual ~ReadObj() = default;
 
-  virtual void read(const std::string& pathToFile, MeshData& data);
+  using Reader::read;
+  virtual void read(const std::string& pathToFile, MeshData& data, const Progress& progress);
+  virtual void read(const uint8_t* bytes, size_t size, MeshData& data, const Progress& progress);
 };
 
 } // namespace conv
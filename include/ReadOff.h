@@ -0,0 +1,41 @@
+#ifndef READOFF_H
+#define READOFF_H
+
+#include "Reader.h"
+
+#include <string_view>
+
+namespace conv {
+
+/* prefixes of the keyword of an .off file: [ST][C][N][4]OFF */
+struct OffKeyword {
+  bool hasTexture = false;
+  bool hasColor = false;
+  bool hasNormal = false;
+  bool isHomogeneous = false;
+};
+
+/*
+ * reader of ASCII .off files (Geomview Object File Format)
+ * the arrays are sized by the counts of the header up front, then the lines are parsed in parallel blocks
+ * with the tokenizer of the .obj reader: one pass counts the data lines of every block, the second parses
+ * every line straight into its vertex or face
+ * normals (N) and texture vertices (ST) are referenced by the faces with the indices of the positions,
+ * the colors (C) of the vertices and faces are skipped
+ */
+class ReadOff : public Reader {
+public:
+  ReadOff() = default;
+  virtual ~ReadOff() = default;
+
+  using Reader::read;
+  virtual void read(const std::string& pathToFile, MeshData& data, const Progress& progress);
+  virtual void read(const uint8_t* bytes, size_t size, MeshData& data, const Progress& progress);
+
+  /* function to parse the keyword of the file, returns false if it is not an .off keyword */
+  static bool parseKeyword(std::string_view word, OffKeyword& keyword);
+};
+
+} // namespace conv
+
+#endif // READOFF_H
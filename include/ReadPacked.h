@@ -0,0 +1,24 @@
+#ifndef READPACKED_H
+#define READPACKED_H
+
+#include "Reader.h"
+
+namespace conv {
+
+/*
+ * reader of the compressed .3dfz files (see PackedFormat.h)
+ * the blocks are located with one pass over their headers and decoded in parallel from the mapping of the file
+ */
+class ReadPacked : public Reader {
+public:
+  ReadPacked() = default;
+  virtual ~ReadPacked() = default;
+
+  using Reader::read;
+  virtual void read(const std::string& pathToFile, MeshData& data, const Progress& progress);
+  virtual void read(const uint8_t* bytes, size_t size, MeshData& data, const Progress& progress);
+};
+
+} // namespace conv
+
+#endif // READPACKED_H
@@ -0,0 +1,27 @@
+#ifndef READPLY_H
+#define READPLY_H
+
+#include "Reader.h"
+
+namespace conv {
+
+/*
+ * reader of binary .ply files (little or big endian)
+ * after the header the elements are decoded in parallel straight from the mapping of the file: elements of
+ * fixed size by their index, the faces (lists) after one pass that finds the position of every face
+ * x, y, z of the vertices are required, nx, ny, nz and s, t (or u, v) are read as normals and texture
+ * vertices referenced by the same indices as the positions
+ */
+class ReadPly : public Reader {
+public:
+  ReadPly() = default;
+  virtual ~ReadPly() = default;
+
+  using Reader::read;
+  virtual void read(const std::string& pathToFile, MeshData& data, const Progress& progress);
+  virtual void read(const uint8_t* bytes, size_t size, MeshData& data, const Progress& progress);
+};
+
+} // namespace conv
+
+#endif // READPLY_H
@@ -0,0 +1,42 @@
+#ifndef READSTL_H
+#define READSTL_H
+
+#include "Reader.h"
+
+namespace conv {
+
+/*
+ * reader of binary .stl files
+ * the records are decoded in parallel straight from the mapping of the file, every triangle gets its own
+ * three vertices unless welding is enabled, which merges the equal vertices into an indexed mesh
+ */
+class ReadStl : public Reader {
+public:
+  explicit ReadStl(bool isWelding = false) : isWelding_(isWelding) {}
+  virtual ~ReadStl() = default;
+
+  using Reader::read;
+  virtual void read(const std::string& pathToFile, MeshData& data, const Progress& progress);
+  virtual void read(const uint8_t* bytes, size_t size, MeshData& data, const Progress& progress);
+
+  /*
+   * function to get the size of the records of a binary .stl file with the given number of triangles
+   * returns 50 for standard files, 98 for the double precision records written by earlier versions of
+   * the converter and 0 if the size of the file matches neither
+   */
+  static size_t recordSize(uint32_t numOfTriangles, uint64_t fileSize);
+
+private:
+  const bool isWelding_;
+};
+
+/*
+ * function to add the triangles given by three corners each to the mesh (the corners are consumed),
+ * welding the equal corners into shared vertices if requested
+ * the decoding of the corners is expected to be reported up to 40 % with welding and 80 % without
+ */
+void appendTriangles(std::vector<glm::dvec3>& corners, bool isWelding, MeshData& data, const Progress& progress);
+
+} // namespace conv
+
+#endif // READSTL_H
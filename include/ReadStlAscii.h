@@ -0,0 +1,28 @@
+#ifndef READSTLASCII_H
+#define READSTLASCII_H
+
+#include "Reader.h"
+
+namespace conv {
+
+/*
+ * reader of ASCII .stl files
+ * the file is split into chunks of whole facets which are parsed in parallel, only the vertex lines are
+ * parsed (the other lines are skipped by their first character), the numbers with std::from_chars
+ */
+class ReadStlAscii : public Reader {
+public:
+  explicit ReadStlAscii(bool isWelding = false) : isWelding_(isWelding) {}
+  virtual ~ReadStlAscii() = default;
+
+  using Reader::read;
+  virtual void read(const std::string& pathToFile, MeshData& data, const Progress& progress);
+  virtual void read(const uint8_t* bytes, size_t size, MeshData& data, const Progress& progress);
+
+private:
+  const bool isWelding_;
+};
+
+} // namespace conv
+
+#endif // READSTLASCII_H
@@ -2,6 +2,7 @@
 #define READER_H
 
 #include "Core.h"
+#include "Progress.h"
 
 
 namespace conv {
@@ -10,7 +11,25 @@ class Reader {
 public:
   virtual ~Reader() = default;
 
-  virtual void read(const std::string& pathToFile, MeshData& data) = 0;
+  /* function to read the file, reporting to the progress and checking it for cancellation */
+  virtual void read(const std::string& pathToFile, MeshData& data, const Progress& progress) = 0;
+
+  void read(const std::string& pathToFile, MeshData& data) {
+    read(pathToFile, data, Progress());
+  }
+
+  /* function to parse the bytes of a whole file (readers with the READER_CAPABILITY_MMAP capability) */
+  virtual void read(const uint8_t* bytes, size_t size, MeshData& data, const Progress& progress) {
+    (void)bytes;
+    (void)size;
+    (void)data;
+    (void)progress;
+    throw std::runtime_error("The reader cannot read from memory");
+  }
+
+  void read(const uint8_t* bytes, size_t size, MeshData& data) {
+    read(bytes, size, data, Progress());
+  }
 };
 
 } // namespace conv
@@ -0,0 +1,110 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace conv {
+
+/*
+ * work-stealing task scheduler shared by every converter session and batch
+ * every worker thread owns a deque: it pushes and pops its own tasks at the back (newest first),
+ * idle workers steal from the front of the other deques (oldest, usually the largest pieces of work)
+ * tasks submitted from outside the workers are spread over the deques
+ * nested parallel work is pushed to the deque of the worker running it, so a single large file
+ * spreads over every core while many small files never start more threads than there are cores
+ */
+class Scheduler {
+public:
+  using Task = std::function<void()>;
+
+  /* function to get the process wide scheduler (one worker less than the hardware threads) */
+  static Scheduler& instance();
+
+  explicit Scheduler(size_t numOfWorkers);
+  ~Scheduler();
+
+  Scheduler(const Scheduler&) = delete;
+  Scheduler& operator= (const Scheduler&) = delete;
+
+  /* function to get the number of threads working on the tasks (workers and the waiting caller) */
+  size_t concurrency() const {
+    return workers_.size() + 1u;
+  }
+
+  /* function to queue a task (the task must not throw) */
+  void submit(Task task);
+
+  /* function to run one queued task on the calling thread, returns false if there was none */
+  bool runPendingTask();
+
+  /* function to block until the predicate holds, running queued tasks meanwhile */
+  void waitUntil(const std::function<bool()>& predicate);
+
+  /* function to wake up the threads blocked in waitUntil() after their predicate changed */
+  void notifyWaiters();
+
+private:
+  struct Worker {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  /* function to take a task: the own deque first (if any), then steal from the others */
+  bool takeTask(Task& task);
+
+  void workerLoop(size_t index);
+
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::vector<std::thread> threads_;
+
+  /* number of queued tasks, lets idle threads sleep */
+  std::atomic<size_t> numOfQueuedTasks_{0u};
+
+  /* deque for the next task submitted from outside the workers */
+  std::atomic<size_t> nextExternal_{0u};
+
+  std::mutex sleepMutex_;
+  std::condition_variable wakeUp_;
+  bool stop_ = false;
+};
+
+/*
+ * group of tasks that can be waited for
+ * the waiting thread runs queued tasks until the group is done, so nested groups cannot deadlock,
+ * the first exception thrown by a task is rethrown by wait()
+ */
+class TaskGroup {
+public:
+  explicit TaskGroup(Scheduler& scheduler = Scheduler::instance()) : scheduler_(scheduler) {}
+  ~TaskGroup();
+
+  TaskGroup(const TaskGroup&) = delete;
+  TaskGroup& operator= (const TaskGroup&) = delete;
+
+  /* function to queue a task of the group */
+  void run(Scheduler::Task task);
+
+  /* function to wait for every task of the group */
+  void wait();
+
+private:
+  Scheduler& scheduler_;
+  std::atomic<size_t> numOfPendingTasks_{0u};
+  std::exception_ptr error_;
+  std::mutex errorMutex_;
+};
+
+} // namespace conv
+
+
+#endif // SCHEDULER_H
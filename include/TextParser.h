@@ -0,0 +1,102 @@
+#ifndef TEXT_PARSER_H
+#define TEXT_PARSER_H
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+namespace conv {
+
+/*
+ * tokenizer of the text formats (.obj, .off, ASCII .stl): the lines are viewed in the mapping of the file
+ * without copying them, the numbers are parsed with std::from_chars, pos is moved after the parsed word
+ */
+
+/* function to check whether the character separates the words of a line */
+inline bool isBlank(char c) {
+  return c == ' ' || c == '\t' || c == '\r' || c == '\f' || c == '\v';
+}
+
+/* function to move pos over the blanks of the line */
+inline void skipBlanks(std::string_view line, size_t& pos) {
+  while (pos < line.size() && isBlank(line[pos])) {
+    ++pos;
+  }
+}
+
+/* function to check whether the line has no more words after pos (the rest may be a # comment) */
+inline bool isLineEnd(std::string_view line, size_t& pos) {
+  skipBlanks(line, pos);
+  return pos >= line.size() || line[pos] == '#';
+}
+
+/* function to get the next word of the line (empty at its end) */
+inline std::string_view nextWord(std::string_view line, size_t& pos) {
+  skipBlanks(line, pos);
+  const size_t start = pos;
+  while (pos < line.size() && !isBlank(line[pos])) {
+    ++pos;
+  }
+  return line.substr(start, pos - start);
+}
+
+/* function to parse the next number of the line */
+template <typename T>
+T parseValue(std::string_view line, size_t& pos) {
+  skipBlanks(line, pos);
+
+  /* std::from_chars does not take a leading plus sign */
+  if (pos < line.size() && line[pos] == '+') {
+    ++pos;
+  }
+
+  T value = T(0);
+  auto result = std::from_chars(line.data() + pos, line.data() + line.size(), value);
+  if (result.ec != std::errc()) {
+    throw std::runtime_error("Invalid number in line: " + std::string(line));
+  }
+
+  pos = static_cast<size_t>(result.ptr - line.data());
+  return value;
+}
+
+inline double parseNumber(std::string_view line, size_t& pos) {
+  return parseValue<double>(line, pos);
+}
+
+inline int64_t parseInteger(std::string_view line, size_t& pos) {
+  return parseValue<int64_t>(line, pos);
+}
+
+/* function to call body(line) for every line of the text (without its '\n') */
+template <typename Body>
+void forEachLine(std::string_view text, Body body) {
+  size_t lineStart = 0u;
+  while (lineStart < text.size()) {
+    size_t lineEnd = text.find('\n', lineStart);
+    lineEnd = (lineEnd == std::string_view::npos) ? text.size() : lineEnd;
+
+    body(text.substr(lineStart, lineEnd - lineStart));
+    lineStart = lineEnd + 1u;
+  }
+}
+
+/* function to split the text into blocks of about blockSize bytes that end after a '\n' */
+inline std::vector<size_t> lineBlockStarts(std::string_view text, size_t blockSize) {
+  std::vector<size_t> blockStarts{0u};
+  while (blockStarts.back() < text.size()) {
+    size_t next = text.find('\n', std::min(text.size(), blockStarts.back() + blockSize));
+    blockStarts.emplace_back((next == std::string_view::npos) ? text.size() : (next + 1u));
+  }
+  return blockStarts;
+}
+
+} // namespace conv
+
+
+#endif // TEXT_PARSER_H
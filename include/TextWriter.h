@@ -0,0 +1,70 @@
+#ifndef TEXT_WRITER_H
+#define TEXT_WRITER_H
+
+#include "Parallel.h"
+#include "Progress.h"
+
+#include <charconv>
+#include <string>
+#include <vector>
+
+
+namespace conv {
+
+/* number of lines formatted by one task */
+constexpr size_t TEXT_FORMAT_BLOCK_SIZE = 16384u;
+
+/*
+ * formatting of the text formats (.obj, .off, ASCII .stl): the lines are appended to preallocated buffers,
+ * the numbers with std::to_chars (shortest text that reads back to the same double)
+ */
+
+/* function to append the text to the buffer */
+inline char* appendText(char* buffer, const char* text) {
+  while (*text) {
+    *buffer++ = *text++;
+  }
+  return buffer;
+}
+
+/* function to append " value" to the buffer (at most 32 characters) */
+template <typename Value>
+char* appendValue(char* buffer, Value value) {
+  *buffer++ = ' ';
+  return std::to_chars(buffer, buffer + 32, value).ptr;
+}
+
+/*
+ * function to format the lines in parallel blocks, sizeOfBlock(first, last) is the upper bound of the text
+ * of the lines [first, last), format(text, i) appends line i and returns the end of the text
+ */
+template <typename SizeOfBlock, typename Format>
+std::vector<std::string> formatLines(size_t numOfLines, SizeOfBlock sizeOfBlock, Format format, const Progress& progress) {
+  const size_t numOfBlocks = (numOfLines + TEXT_FORMAT_BLOCK_SIZE - 1u) / TEXT_FORMAT_BLOCK_SIZE;
+  std::vector<std::string> blocks(numOfBlocks);
+  std::atomic<size_t> numOfFormatted{0u};
+  parallelFor(numOfBlocks, 1u, [&](size_t begin, size_t end) {
+    for (size_t b = begin; b < end; ++b) {
+      progress.checkCancelled();
+      const size_t first = b * TEXT_FORMAT_BLOCK_SIZE;
+      const size_t last = std::min(numOfLines, first + TEXT_FORMAT_BLOCK_SIZE);
+
+      std::string& block = blocks[b];
+      block.resize(sizeOfBlock(first, last));
+      char* text = block.data();
+      for (size_t i = first; i < last; ++i) {
+        text = format(text, i);
+      }
+      block.resize(static_cast<size_t>(text - block.data()));
+
+      numOfFormatted += last - first;
+      progress.update(static_cast<double>(numOfFormatted) / numOfLines);
+    }
+  });
+  return blocks;
+}
+
+} // namespace conv
+
+
+#endif // TEXT_WRITER_H
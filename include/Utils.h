@@ -52,6 +52,41 @@ inline std::vector<size_t> findPosition(const std::string& str, const char toFin
   return charPositions;
 }
 
+/*
+ * function to check whether the name matches the pattern
+ * '*' matches any sequence of characters, '?' matches a single character
+ */
+inline bool matchesWildcard(const std::string& name, const std::string& pattern) {
+  size_t n = 0u;
+  size_t p = 0u;
+
+  /* position of the last '*' in the pattern and of the name where it started matching */
+  size_t star = std::string::npos;
+  size_t starMatch = 0u;
+
+  while (n < name.size()) {
+    if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == name[n])) {
+      ++n;
+      ++p;
+    } else if (p < pattern.size() && pattern[p] == '*') {
+      star = p++;
+      starMatch = n;
+    } else if (star != std::string::npos) {
+      /* let the last '*' swallow one more character */
+      p = star + 1u;
+      n = ++starMatch;
+    } else {
+      return false;
+    }
+  }
+
+  while (p < pattern.size() && pattern[p] == '*') {
+    ++p;
+  }
+
+  return p == pattern.size();
+}
+
 } // namespace utils
 
 
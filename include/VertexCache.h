@@ -0,0 +1,51 @@
+#ifndef VERTEX_CACHE_H
+#define VERTEX_CACHE_H
+
+#include "Core.h"
+
+
+namespace conv {
+
+/* number of entries of the simulated post-transform vertex cache (FIFO, like the caches of most GPUs) */
+constexpr size_t VERTEX_CACHE_SIZE = 16u;
+
+/* cache misses of the triangles before and after the optimization */
+struct VertexCacheStatistics {
+  uint64_t numOfTriangles = 0u;
+  uint64_t numOfMissesBefore = 0u;
+  uint64_t numOfMissesAfter = 0u;
+
+  /* average cache miss ratio: transformed vertices per triangle (0.5 is the best of large regular meshes, 3 the worst) */
+  double acmrBefore() const {
+    return (0u != numOfTriangles) ? static_cast<double>(numOfMissesBefore) / numOfTriangles : 0.0;
+  }
+
+  double acmrAfter() const {
+    return (0u != numOfTriangles) ? static_cast<double>(numOfMissesAfter) / numOfTriangles : 0.0;
+  }
+
+  void merge(const VertexCacheStatistics& other) {
+    numOfTriangles += other.numOfTriangles;
+    numOfMissesBefore += other.numOfMissesBefore;
+    numOfMissesAfter += other.numOfMissesAfter;
+  }
+};
+
+/*
+ * function to count the misses of a FIFO cache of the given size over the geometric vertices of the triangles
+ * (throws std::runtime_error for a reference to a missing vertex)
+ */
+uint64_t countCacheMisses(const MeshData& data, size_t cacheSize = VERTEX_CACHE_SIZE);
+
+/*
+ * function to reorder the mesh for rendering from an index buffer:
+ * the faces are ordered with Tipsify (linear time, fans around the vertices in the cache) and then the
+ * vertices, texture vertices and normals are renumbered in the order of their first use, so they are
+ * fetched from memory front to back (the triangles are updated)
+ */
+VertexCacheStatistics optimizeVertexCache(MeshData& data, size_t cacheSize = VERTEX_CACHE_SIZE);
+
+} // namespace conv
+
+
+#endif // VERTEX_CACHE_H
@@ -0,0 +1,31 @@
+#ifndef WRITE3MF_H
+#define WRITE3MF_H
+
+#include "Writer.h"
+#include "ZipWriter.h"
+
+
+namespace conv {
+
+/*
+ * writer of 3D Manufacturing Format (.3mf) packages with one mesh object
+ * the XML model (indexed vertices and the triangles of the faces) is formatted in windows of lines and
+ * streamed into the ZIP container (see ZipWriter), so the text of the model is never held as a whole
+ * faces are triangulated as fans, the triangles without three distinct vertices are left out
+ */
+class Write3mf : public Writer {
+public:
+  explicit Write3mf(ZipMethod method = ZipMethod::ZIP_METHOD_DEFLATED);
+  virtual ~Write3mf() = default;
+
+  using Writer::write;
+  virtual void write(std::ostream& stream, const MeshData& data, const Progress& progress);
+
+private:
+  const ZipMethod method_;
+};
+
+} // namespace conv
+
+
+#endif // WRITE3MF_H
@@ -0,0 +1,26 @@
+#ifndef WRITEEDGEBREAKER_H
+#define WRITEEDGEBREAKER_H
+
+#include "Writer.h"
+
+
+namespace conv {
+
+/*
+ * writer of the .3dfe files (see Edgebreaker.h)
+ * the faces are triangulated like the triangles of the mesh, the connectivity of the triangles is encoded
+ * in the style of Edgebreaker and the positions are kept exactly
+ */
+class WriteEdgebreaker : public Writer {
+public:
+  WriteEdgebreaker() = default;
+  virtual ~WriteEdgebreaker() = default;
+
+  using Writer::write;
+  virtual void write(std::ostream& stream, const MeshData& data, const Progress& progress);
+};
+
+} // namespace conv
+
+
+#endif // WRITEEDGEBREAKER_H
@@ -0,0 +1,27 @@
+#ifndef WRITEGLB_H
+#define WRITEGLB_H
+
+#include "Writer.h"
+
+
+namespace conv {
+
+/*
+ * writer of binary glTF 2.0 (.glb) files with one indexed triangle primitive
+ * the corners of the faces are deduplicated by their position, normal and texture vertex references,
+ * normals and texture coordinates are written if every face references them, the indices are 16 bit
+ * whenever the number of vertices allows it
+ */
+class WriteGlb : public Writer {
+public:
+  WriteGlb() = default;
+  virtual ~WriteGlb() = default;
+
+  using Writer::write;
+  virtual void write(std::ostream& stream, const MeshData& data, const Progress& progress);
+};
+
+} // namespace conv
+
+
+#endif // WRITEGLB_H
@@ -0,0 +1,26 @@
+#ifndef WRITENATIVE_H
+#define WRITENATIVE_H
+
+#include "Writer.h"
+
+
+namespace conv {
+
+/*
+ * writer of the native .3dfc files (see NativeMesh.h)
+ * the vertex arrays are written as they are in memory, the references of the faces are gathered
+ * in parallel into one array per kind with the offsets of the faces
+ */
+class WriteNative : public Writer {
+public:
+  WriteNative() = default;
+  virtual ~WriteNative() = default;
+
+  using Writer::write;
+  virtual void write(std::ostream& stream, const MeshData& data, const Progress& progress);
+};
+
+} // namespace conv
+
+
+#endif // WRITENATIVE_H
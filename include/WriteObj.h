@@ -0,0 +1,26 @@
+#ifndef WRITEOBJ_H
+#define WRITEOBJ_H
+
+#include "Writer.h"
+
+
+namespace conv {
+
+/*
+ * writer of Wavefront .obj files
+ * the v, vt, vn and f sections are formatted in parallel blocks with std::to_chars (shortest text that
+ * reads back to the same double), every face keeps its index variant (v, v/vt, v//vn, v/vt/vn)
+ */
+class WriteObj : public Writer {
+public:
+  WriteObj() = default;
+  virtual ~WriteObj() = default;
+
+  using Writer::write;
+  virtual void write(std::ostream& stream, const MeshData& data, const Progress& progress);
+};
+
+} // namespace conv
+
+
+#endif // WRITEOBJ_H
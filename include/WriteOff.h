@@ -0,0 +1,25 @@
+#ifndef WRITEOFF_H
+#define WRITEOFF_H
+
+#include "Writer.h"
+
+
+namespace conv {
+
+/*
+ * writer of ASCII .off files (plain OFF: positions and faces with 0-based indices, the form every tool reads)
+ * the vertex and face lines are formatted in parallel blocks with std::to_chars, like the .obj writer
+ */
+class WriteOff : public Writer {
+public:
+  WriteOff() = default;
+  virtual ~WriteOff() = default;
+
+  using Writer::write;
+  virtual void write(std::ostream& stream, const MeshData& data, const Progress& progress);
+};
+
+} // namespace conv
+
+
+#endif // WRITEOFF_H
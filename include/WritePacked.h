@@ -0,0 +1,31 @@
+#ifndef WRITEPACKED_H
+#define WRITEPACKED_H
+
+#include "PackedFormat.h"
+#include "Writer.h"
+
+
+namespace conv {
+
+/*
+ * writer of the compressed .3dfz files (see PackedFormat.h)
+ * the positions are quantized to the given number of bits per coordinate within the bounding box, vertices
+ * falling onto the same quantized position are merged, the vertices are renumbered in the order of their
+ * first use by the faces and the blocks are encoded in parallel
+ */
+class WritePacked : public Writer {
+public:
+  explicit WritePacked(uint32_t quantizationBits = 16u);
+  virtual ~WritePacked() = default;
+
+  using Writer::write;
+  virtual void write(std::ostream& stream, const MeshData& data, const Progress& progress);
+
+private:
+  const uint32_t quantizationBits_;
+};
+
+} // namespace conv
+
+
+#endif // WRITEPACKED_H
@@ -0,0 +1,26 @@
+#ifndef WRITEPLY_H
+#define WRITEPLY_H
+
+#include "Writer.h"
+
+
+namespace conv {
+
+/*
+ * writer of indexed binary little endian .ply files
+ * every section (vertices, faces) is encoded in parallel into one buffer and written with one call,
+ * normals and texture vertices are written with the vertices if the faces reference them by the vertex indices
+ */
+class WritePly : public Writer {
+public:
+  WritePly() = default;
+  virtual ~WritePly() = default;
+
+  using Writer::write;
+  virtual void write(std::ostream& stream, const MeshData& data, const Progress& progress);
+};
+
+} // namespace conv
+
+
+#endif // WRITEPLY_H
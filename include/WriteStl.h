@@ -11,7 +11,8 @@ public:
   WriteStl() = default;
   virtual ~WriteStl() = default;
 
-  virtual void write(const std::string& pathToFile, const MeshData& data);
+  using Writer::write;
+  virtual void write(std::ostream& stream, const MeshData& data, const Progress& progress);
 };
 
 } // namespace conv
@@ -0,0 +1,31 @@
+#ifndef WRITESTLASCII_H
+#define WRITESTLASCII_H
+
+#include "Writer.h"
+
+
+namespace conv {
+
+/*
+ * writer of ASCII .stl files
+ * the facets are formatted in parallel blocks with std::to_chars (shortest text that reads back to the
+ * same double), the blocks are written in order with one call each
+ */
+class WriteStlAscii : public Writer {
+public:
+  WriteStlAscii() = default;
+  virtual ~WriteStlAscii() = default;
+
+  using Writer::write;
+  virtual void write(const std::string& pathToFile, const MeshData& data, const Progress& progress);
+  virtual void write(std::ostream& stream, const MeshData& data, const Progress& progress);
+
+private:
+  /* function to write the facets as a solid of the name */
+  void writeSolid(std::ostream& stream, const std::string& name, const MeshData& data, const Progress& progress);
+};
+
+} // namespace conv
+
+
+#endif // WRITESTLASCII_H
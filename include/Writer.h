@@ -2,6 +2,11 @@
 #define WRITER_H
 
 #include "Core.h"
+#include "OutputBuffer.h"
+#include "Progress.h"
+
+#include <functional>
+#include <ostream>
 
 
 namespace conv {
@@ -10,7 +15,39 @@ class Writer {
 public:
   virtual ~Writer() = default;
 
-  virtual void write(const std::string& pathToFile, const MeshData& data) = 0;
+  /* function to write the file, reporting to the progress and checking it for cancellation */
+  virtual void write(const std::string& pathToFile, const MeshData& data, const Progress& progress) {
+    writeFile(pathToFile, [&](std::ostream& stream) { write(stream, data, progress); });
+  }
+
+  void write(const std::string& pathToFile, const MeshData& data) {
+    write(pathToFile, data, Progress());
+  }
+
+  /*
+   * function to write the bytes of a whole file from the current position of the stream
+   * (writers of containers with headers to fill in, like .3mf, fall back to a sequential layout if the stream cannot seek)
+   */
+  virtual void write(std::ostream& stream, const MeshData& data, const Progress& progress) {
+    (void)stream;
+    (void)data;
+    (void)progress;
+    throw std::runtime_error("The writer cannot write to a stream");
+  }
+
+  /* function to append the bytes of a whole file to the buffer, without touching the filesystem */
+  void write(std::vector<uint8_t>& buffer, const MeshData& data, const Progress& progress = Progress()) {
+    OutputBuffer output(buffer);
+    std::ostream stream(&output);
+    write(stream, data, progress);
+  }
+
+protected:
+  /*
+   * function to write the file through body(stream): the stream writes a temporary file in the same directory,
+   * which replaces the file only if body succeeds, so a cancelled or failed write leaves no partial output
+   */
+  static void writeFile(const std::string& pathToFile, const std::function<void(std::ostream&)>& body);
 };
 
 } // namespace conv
@@ -0,0 +1,105 @@
+#ifndef ZIP_WRITER_H
+#define ZIP_WRITER_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+namespace conv {
+
+/* compression method of a ZIP entry */
+enum class ZipMethod : uint16_t {
+  ZIP_METHOD_STORED = 0u,
+  ZIP_METHOD_DEFLATED = 8u
+};
+
+/* bytes of an entry compressed as one independent piece (the pieces are compressed in parallel) */
+constexpr size_t ZIP_PIECE_SIZE = 1u << 20u;
+
+/* function to update the CRC-32 (ZIP, gzip) of the bytes */
+uint32_t crc32(uint32_t crc, const uint8_t* bytes, size_t size);
+
+/*
+ * function to compress the bytes as deflate blocks with the fixed Huffman codes (LZ77 matches within the
+ * bytes), the blocks are not final and end on a byte boundary, so the results of independent pieces can
+ * be concatenated into one stream that is closed with deflateEnd
+ */
+void deflatePiece(const uint8_t* bytes, size_t size, std::vector<uint8_t>& compressed);
+
+/* function to append the final empty block of a deflate stream */
+void deflateEnd(std::vector<uint8_t>& compressed);
+
+/*
+ * minimal ZIP writer streaming the entries into an output stream: the data of an entry is compressed in
+ * pieces of ZIP_PIECE_SIZE as it is written, so memory stays bounded by a few pieces whatever the size of the entry
+ * the local header of a streamed entry has a ZIP64 field that is filled in when the entry ends (streams that
+ * cannot seek get a data descriptor after the data instead), the central directory uses ZIP64 only if the
+ * sizes or offsets need it
+ * the entries have a fixed time stamp (1980-01-01), so equal inputs give equal archives
+ */
+class ZipWriter {
+public:
+  /* the archive starts at the current position of the stream */
+  explicit ZipWriter(std::ostream& stream);
+  ~ZipWriter() = default;
+
+  ZipWriter(const ZipWriter&) = delete;
+  ZipWriter& operator= (const ZipWriter&) = delete;
+
+  /* function to start an entry, the previous one must be ended (streams that cannot seek get deflated entries) */
+  void beginEntry(const std::string& name, ZipMethod method);
+
+  /* function to append to the data of the entry (buffered until a piece is full) */
+  void write(std::string_view data);
+
+  /* function to append the blocks of text to the data of the entry, the full pieces are compressed in parallel */
+  void write(const std::vector<std::string>& blocks);
+
+  /* function to end the entry: flush its data and fill in its sizes and checksum */
+  void endEntry();
+
+  /* function to write the central directory, the archive is complete afterwards */
+  void finish();
+
+private:
+  /* central directory record of a written entry */
+  struct Entry {
+    std::string name;
+    ZipMethod method = ZipMethod::ZIP_METHOD_STORED;
+    uint32_t crc = 0u;
+    uint64_t compressedSize = 0u;
+    uint64_t uncompressedSize = 0u;
+    uint64_t localHeaderOffset = 0u;
+  };
+
+  /* function to compress and write the pieces in order */
+  void writePieces(const std::vector<std::string_view>& pieces);
+
+  /* function to overwrite the written bytes at the offset of the archive */
+  void patchBytes(uint64_t offset, const std::vector<uint8_t>& bytes);
+
+  /* function to get the general purpose flags of the entries */
+  uint16_t flags() const;
+
+  /* function to write the bytes to the stream, checking it */
+  void writeBytes(const uint8_t* bytes, size_t size);
+
+  std::ostream& stream_;
+  std::streampos start_;
+  bool isSeekable_ = false;
+
+  /* number of bytes of the archive written so far */
+  uint64_t position_ = 0u;
+
+  std::vector<Entry> entries_;
+  bool isEntryOpen_ = false;
+  std::string pending_;
+};
+
+} // namespace conv
+
+
+#endif // ZIP_WRITER_H
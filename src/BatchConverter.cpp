@@ -0,0 +1,272 @@
+#include "BatchConverter.h"
+#include "BoundedQueue.h"
+#include "Scheduler.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+
+namespace conv {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/* function to get the elapsed seconds since the given time */
+double secondsSince(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+/* counter of the meshes in memory, readers wait while it is at its limit */
+class MeshLimit {
+public:
+  explicit MeshLimit(size_t limit) : limit_(std::max<size_t>(limit, 1u)) {}
+
+  void acquire() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    released_.wait(lock, [this]() { return count_ < limit_; });
+    count_++;
+  }
+
+  void release() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      count_--;
+    }
+    released_.notify_one();
+  }
+
+private:
+  const size_t limit_;
+  size_t count_ = 0u;
+  std::mutex mutex_;
+  std::condition_variable released_;
+};
+
+} // namespace
+
+uint64_t residentBytes() {
+#ifdef __linux__
+  /* second field of statm: resident pages */
+  std::ifstream statm("/proc/self/statm");
+  uint64_t size = 0u;
+  uint64_t resident = 0u;
+  if (statm >> size >> resident) {
+    return resident * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+  }
+#endif
+
+  return 0u;
+}
+
+void applyTransform(FileConverter& converter, const Transform& transform, VertexCacheStatistics* vertexCache) {
+  switch (transform.type) {
+  case TransformType::TRANSFORM_TYPE_ROTATE:
+    converter.rotate(transform.value);
+    break;
+  case TransformType::TRANSFORM_TYPE_SCALE:
+    converter.scale(transform.value);
+    break;
+  case TransformType::TRANSFORM_TYPE_TRANSLATE:
+    converter.translate(transform.value);
+    break;
+  case TransformType::TRANSFORM_TYPE_OPTIMIZE_VERTEX_CACHE: {
+    const VertexCacheStatistics statistics = converter.optimizeVertexCache();
+    if (vertexCache) {
+      vertexCache->merge(statistics);
+    }
+    break;
+  }
+  default:
+    throw std::invalid_argument("Not supported transformation type");
+  }
+}
+
+BatchConverter::BatchConverter(const BatchOptions& options) : options_(options) {
+}
+
+BatchReport BatchConverter::run(const std::vector<BatchJob>& jobs) const {
+  BatchReport report;
+  std::mutex reportMutex;
+  const Clock::time_point batchStart = Clock::now();
+
+  auto fail = [&](size_t job, const std::string& message) {
+    std::lock_guard<std::mutex> lock(reportMutex);
+    report.failures.push_back({job, message});
+  };
+
+  /* output format of a job, automatic outputs are keyed by the format of their extension */
+  auto outputTypeOf = [&](const std::string& outputPath) {
+    if (options_.output != OutputType::OUTPUT_TYPE_AUTO) {
+      return options_.output;
+    }
+    const WriterFormat* format = FormatRegistry::instance().writerForPath(outputPath);
+    return format ? format->type : OutputType::OUTPUT_TYPE_UNKNOWN;
+  };
+
+  /* session of every job between its read and its write */
+  std::vector<std::unique_ptr<FileConverter>> sessions(jobs.size());
+
+  /* cache keys of the jobs, the outputs are stored after they are written */
+  std::vector<uint64_t> cacheKeys(jobs.size(), 0u);
+  MeshLimit meshLimit(options_.maxNumOfMeshes);
+
+  /* transformed jobs waiting for a writer (never more than the meshes in memory) */
+  BoundedQueue<size_t> writeQueue(options_.maxNumOfMeshes);
+  TaskGroup transforms;
+  std::atomic<size_t> nextJob{0u};
+
+  /* transform stage: a task of the scheduler per job */
+  auto transform = [&](size_t job) {
+    const Clock::time_point start = Clock::now();
+    VertexCacheStatistics vertexCache;
+    try {
+      for (const auto& t : jobs[job].transforms) {
+        applyTransform(*sessions[job], t, &vertexCache);
+      }
+    } catch (const std::exception& e) {
+      fail(job, e.what());
+      sessions[job].reset();
+      meshLimit.release();
+      return;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(reportMutex);
+      report.transform.numOfJobs++;
+      report.transform.numOfTriangles += sessions[job]->mesh().triangles.size();
+      report.transform.busySeconds += secondsSince(start);
+      report.transform.maxResidentBytes = std::max(report.transform.maxResidentBytes, residentBytes());
+      report.vertexCache.merge(vertexCache);
+    }
+
+    writeQueue.push(job);
+  };
+
+  /* read stage: every reader takes the next job and hands the mesh over to the transform stage */
+  auto reader = [&]() {
+    StageStatistics stats;
+    for (size_t job = nextJob++; job < jobs.size(); job = nextJob++) {
+      /* a cached output replaces the whole conversion, on a miss the mapping hashed for the key is parsed */
+      std::optional<MappedFile> file;
+      if (options_.cache) {
+        try {
+          file.emplace(jobs[job].inputPath);
+          cacheKeys[job] = ConversionCache::key(file->data(), file->size(), options_.input,
+                                                outputTypeOf(jobs[job].outputPath), jobs[job].transforms);
+          if (options_.cache->fetch(cacheKeys[job], jobs[job].outputPath)) {
+            std::lock_guard<std::mutex> lock(reportMutex);
+            report.numOfCacheHits++;
+            continue;
+          }
+        } catch (const std::exception& e) {
+          fail(job, e.what());
+          continue;
+        }
+      }
+
+      meshLimit.acquire();
+
+      const Clock::time_point start = Clock::now();
+      try {
+        auto session = std::make_unique<FileConverter>();
+        session->setInputFormat(options_.input);
+        session->setOutputFormat(options_.output);
+        if (file) {
+          session->read(*file, jobs[job].inputPath);
+          file.reset();
+        } else {
+          session->read(jobs[job].inputPath);
+        }
+        const uint64_t numOfBytes = std::filesystem::file_size(jobs[job].inputPath);
+
+        /* the job is counted only after the last step that can fail */
+        stats.numOfJobs++;
+        stats.numOfBytes += numOfBytes;
+        stats.numOfTriangles += session->mesh().triangles.size();
+        sessions[job] = std::move(session);
+        stats.maxResidentBytes = std::max(stats.maxResidentBytes, residentBytes());
+      } catch (const std::exception& e) {
+        fail(job, e.what());
+        meshLimit.release();
+        continue;
+      }
+      stats.busySeconds += secondsSince(start);
+
+      transforms.run([&transform, job]() { transform(job); });
+    }
+
+    std::lock_guard<std::mutex> lock(reportMutex);
+    report.read.merge(stats);
+  };
+
+  /* write stage: the mesh is released as soon as it is written */
+  auto writer = [&]() {
+    StageStatistics stats;
+    size_t job = 0u;
+    while (writeQueue.pop(job)) {
+      const Clock::time_point start = Clock::now();
+      try {
+        sessions[job]->write(jobs[job].outputPath);
+
+        /* a failed store only loses the cache entry, the output is written */
+        if (options_.cache) {
+          try {
+            options_.cache->store(cacheKeys[job], jobs[job].outputPath);
+          } catch (const std::exception&) {
+          }
+        }
+
+        const uint64_t numOfBytes = std::filesystem::file_size(jobs[job].outputPath);
+        stats.numOfJobs++;
+        stats.numOfBytes += numOfBytes;
+        stats.numOfTriangles += sessions[job]->mesh().triangles.size();
+        stats.maxResidentBytes = std::max(stats.maxResidentBytes, residentBytes());
+      } catch (const std::exception& e) {
+        fail(job, e.what());
+      }
+      sessions[job].reset();
+      meshLimit.release();
+      stats.busySeconds += secondsSince(start);
+    }
+
+    std::lock_guard<std::mutex> lock(reportMutex);
+    report.write.merge(stats);
+  };
+
+  /* start the stages, the write queue is closed when every transformation is done */
+  std::vector<std::thread> readers;
+  std::vector<std::thread> writers;
+  for (size_t i = 0u; i < std::max<size_t>(options_.numOfReaders, 1u); ++i) {
+    readers.emplace_back(reader);
+  }
+  for (size_t i = 0u; i < std::max<size_t>(options_.numOfWriters, 1u); ++i) {
+    writers.emplace_back(writer);
+  }
+
+  for (auto& t : readers) {
+    t.join();
+  }
+  transforms.wait();
+  writeQueue.close();
+  for (auto& t : writers) {
+    t.join();
+  }
+
+  std::sort(report.failures.begin(), report.failures.end(),
+            [](const BatchFailure& a, const BatchFailure& b) { return a.job < b.job; });
+  report.wallSeconds = secondsSince(batchStart);
+
+  return report;
+}
+
+} // namespace conv
@@ -0,0 +1,438 @@
+#include "Bvh.h"
+
+
+namespace conv {
+
+constexpr uint32_t BVH_LEAF_SIZE = 4u;
+constexpr uint32_t BVH_MAX_LEAF_SIZE = 16u;
+constexpr uint32_t BVH_BIN_COUNT = 16u;
+
+/*
+ * relative padding of the exit distance in the slab test
+ * makes the box test conservative against the rounding of the slab distances (3 ulps each)
+ */
+constexpr double BOUNDS_PADDING = 1.0 + 2.0 * (3.0 * std::numeric_limits<double>::epsilon()) /
+                                        (1.0 - 3.0 * std::numeric_limits<double>::epsilon());
+
+namespace {
+
+/* function to calculate the half of the surface area of a box (enough for the SAH cost comparison) */
+double halfArea(const glm::dvec3& boundsMin, const glm::dvec3& boundsMax) {
+  glm::dvec3 extent = boundsMax - boundsMin;
+  return (extent.x * extent.y) + (extent.y * extent.z) + (extent.z * extent.x);
+}
+
+/* function to invert the ray direction, zero components are replaced to avoid 0 * inf in the slab test */
+glm::dvec3 safeInverse(const glm::dvec3& direction) {
+  glm::dvec3 inverse;
+  for (glm::length_t i = 0; i < 3; ++i) {
+    double d = (0.0 != direction[i]) ? direction[i] : std::numeric_limits<double>::min();
+    inverse[i] = 1.0 / d;
+  }
+
+  return inverse;
+}
+
+} // namespace
+
+struct Bvh::RayPacket {
+  double originX[RAY_PACKET_SIZE];
+  double originY[RAY_PACKET_SIZE];
+  double originZ[RAY_PACKET_SIZE];
+  double directionX[RAY_PACKET_SIZE];
+  double directionY[RAY_PACKET_SIZE];
+  double directionZ[RAY_PACKET_SIZE];
+  double inverseX[RAY_PACKET_SIZE];
+  double inverseY[RAY_PACKET_SIZE];
+  double inverseZ[RAY_PACKET_SIZE];
+  double tMin[RAY_PACKET_SIZE];
+  double tMax[RAY_PACKET_SIZE];
+
+  /* number of valid lanes (the last packet of a batch may be partial) */
+  size_t size = 0u;
+
+  /* scratch space of the traversal */
+  std::vector<uint32_t> stack;
+};
+
+Bvh::Bvh(const std::vector<Triangle>& triangles) {
+  if (triangles.empty()) {
+    return;
+  }
+
+  if (triangles.size() >= std::numeric_limits<uint32_t>::max()) {
+    throw std::length_error("Too many triangles for the acceleration structure");
+  }
+
+  /* bounds and centroids of every triangle */
+  std::vector<glm::dvec3> boundsMin(triangles.size());
+  std::vector<glm::dvec3> boundsMax(triangles.size());
+  std::vector<glm::dvec3> centroids(triangles.size());
+  std::vector<uint32_t> order(triangles.size());
+
+  for (size_t i = 0u; i < triangles.size(); ++i) {
+    const auto& v = triangles[i].vertices;
+    boundsMin[i] = glm::min(v[0], glm::min(v[1], v[2]));
+    boundsMax[i] = glm::max(v[0], glm::max(v[1], v[2]));
+    centroids[i] = 0.5 * (boundsMin[i] + boundsMax[i]);
+    order[i] = static_cast<uint32_t>(i);
+  }
+
+  nodes_.reserve(2u * triangles.size() / BVH_LEAF_SIZE + 1u);
+  build(order, boundsMin, boundsMax, centroids, 0u, static_cast<uint32_t>(triangles.size()));
+
+  /* store the triangles in leaf order */
+  triangleIds_ = std::move(order);
+  vertices0_.resize(triangleIds_.size());
+  edges1_.resize(triangleIds_.size());
+  edges2_.resize(triangleIds_.size());
+  for (size_t i = 0u; i < triangleIds_.size(); ++i) {
+    const auto& v = triangles[triangleIds_[i]].vertices;
+    vertices0_[i] = v[0];
+    edges1_[i] = v[1] - v[0];
+    edges2_[i] = v[2] - v[0];
+  }
+}
+
+uint32_t Bvh::build(std::vector<uint32_t>& order, const std::vector<glm::dvec3>& boundsMin,
+                    const std::vector<glm::dvec3>& boundsMax, const std::vector<glm::dvec3>& centroids,
+                    uint32_t begin, uint32_t end) {
+  const uint32_t nodeIndex = static_cast<uint32_t>(nodes_.size());
+  nodes_.emplace_back();
+
+  /* bounds of the node and of the centroids */
+  BvhNode node;
+  node.boundsMin = boundsMin[order[begin]];
+  node.boundsMax = boundsMax[order[begin]];
+  glm::dvec3 centroidMin = centroids[order[begin]];
+  glm::dvec3 centroidMax = centroids[order[begin]];
+  for (uint32_t i = begin + 1u; i < end; ++i) {
+    node.boundsMin = glm::min(node.boundsMin, boundsMin[order[i]]);
+    node.boundsMax = glm::max(node.boundsMax, boundsMax[order[i]]);
+    centroidMin = glm::min(centroidMin, centroids[order[i]]);
+    centroidMax = glm::max(centroidMax, centroids[order[i]]);
+  }
+
+  const uint32_t count = end - begin;
+  if (count <= BVH_LEAF_SIZE) {
+    node.offset = begin;
+    node.count = static_cast<uint16_t>(count);
+    nodes_[nodeIndex] = node;
+    return nodeIndex;
+  }
+
+  /* split along the axis with the largest centroid extent */
+  glm::dvec3 extent = centroidMax - centroidMin;
+  glm::length_t axis = 0;
+  if (extent.y > extent[axis]) {
+    axis = 1;
+  }
+  if (extent.z > extent[axis]) {
+    axis = 2;
+  }
+
+  uint32_t middle = begin;
+  if (extent[axis] > 0.0) {
+    /* bin the centroids and evaluate the surface area heuristic at every bin border */
+    std::array<uint32_t, BVH_BIN_COUNT> binCounts{};
+    std::array<glm::dvec3, BVH_BIN_COUNT> binMin;
+    std::array<glm::dvec3, BVH_BIN_COUNT> binMax;
+    binMin.fill(glm::dvec3(std::numeric_limits<double>::max()));
+    binMax.fill(glm::dvec3(std::numeric_limits<double>::lowest()));
+
+    const double scale = BVH_BIN_COUNT / extent[axis];
+    auto binOf = [&](uint32_t triangle) {
+      auto bin = static_cast<uint32_t>((centroids[triangle][axis] - centroidMin[axis]) * scale);
+      return std::min(bin, BVH_BIN_COUNT - 1u);
+    };
+
+    for (uint32_t i = begin; i < end; ++i) {
+      uint32_t bin = binOf(order[i]);
+      ++binCounts[bin];
+      binMin[bin] = glm::min(binMin[bin], boundsMin[order[i]]);
+      binMax[bin] = glm::max(binMax[bin], boundsMax[order[i]]);
+    }
+
+    /* sweep from the right to get the cost of the right sides */
+    std::array<double, BVH_BIN_COUNT> rightCosts{};
+    glm::dvec3 sweepMin(std::numeric_limits<double>::max());
+    glm::dvec3 sweepMax(std::numeric_limits<double>::lowest());
+    uint32_t sweepCount = 0u;
+    for (uint32_t bin = BVH_BIN_COUNT - 1u; bin > 0u; --bin) {
+      sweepMin = glm::min(sweepMin, binMin[bin]);
+      sweepMax = glm::max(sweepMax, binMax[bin]);
+      sweepCount += binCounts[bin];
+      rightCosts[bin] = (0u == sweepCount) ? 0.0 : sweepCount * halfArea(sweepMin, sweepMax);
+    }
+
+    /* sweep from the left and pick the cheapest split */
+    double bestCost = std::numeric_limits<double>::max();
+    uint32_t bestSplit = 0u;
+    sweepMin = glm::dvec3(std::numeric_limits<double>::max());
+    sweepMax = glm::dvec3(std::numeric_limits<double>::lowest());
+    sweepCount = 0u;
+    for (uint32_t bin = 1u; bin < BVH_BIN_COUNT; ++bin) {
+      sweepMin = glm::min(sweepMin, binMin[bin - 1u]);
+      sweepMax = glm::max(sweepMax, binMax[bin - 1u]);
+      sweepCount += binCounts[bin - 1u];
+      if (0u == sweepCount || count == sweepCount) {
+        continue;
+      }
+
+      double cost = sweepCount * halfArea(sweepMin, sweepMax) + rightCosts[bin];
+      if (cost < bestCost) {
+        bestCost = cost;
+        bestSplit = bin;
+      }
+    }
+
+    /* a leaf is cheaper than any split */
+    double leafCost = count * halfArea(node.boundsMin, node.boundsMax);
+    if (count <= BVH_MAX_LEAF_SIZE && bestCost >= leafCost) {
+      node.offset = begin;
+      node.count = static_cast<uint16_t>(count);
+      nodes_[nodeIndex] = node;
+      return nodeIndex;
+    }
+
+    if (0u != bestSplit) {
+      auto it = std::partition(order.begin() + begin, order.begin() + end,
+                               [&](uint32_t triangle) { return binOf(triangle) < bestSplit; });
+      middle = static_cast<uint32_t>(it - order.begin());
+    }
+  }
+
+  /* all centroids are in one bin: split in the middle */
+  if (middle == begin || middle == end) {
+    middle = begin + (count / 2u);
+    std::nth_element(order.begin() + begin, order.begin() + middle, order.begin() + end,
+                     [&](uint32_t a, uint32_t b) { return centroids[a][axis] < centroids[b][axis]; });
+  }
+
+  build(order, boundsMin, boundsMax, centroids, begin, middle);
+  node.offset = build(order, boundsMin, boundsMax, centroids, middle, end);
+  node.axis = static_cast<uint16_t>(axis);
+  nodes_[nodeIndex] = node;
+
+  return nodeIndex;
+}
+
+void Bvh::traverse(RayPacket& packet, Query query, RayHit* hits, std::vector<RayHit>* allHits) const {
+  auto& stack = packet.stack;
+  stack.clear();
+  stack.emplace_back(0u);
+
+  /* direction of the first lane decides the front to back order of the children */
+  const bool negative[3] = {packet.directionX[0] < 0.0, packet.directionY[0] < 0.0, packet.directionZ[0] < 0.0};
+
+  while (!stack.empty()) {
+    const uint32_t nodeIndex = stack.back();
+    const BvhNode& node = nodes_[nodeIndex];
+    stack.pop_back();
+
+    /* slab test of every lane against the node bounds */
+    bool anyLane = false;
+    for (size_t l = 0u; l < RAY_PACKET_SIZE; ++l) {
+      double tx0 = (node.boundsMin.x - packet.originX[l]) * packet.inverseX[l];
+      double tx1 = (node.boundsMax.x - packet.originX[l]) * packet.inverseX[l];
+      double ty0 = (node.boundsMin.y - packet.originY[l]) * packet.inverseY[l];
+      double ty1 = (node.boundsMax.y - packet.originY[l]) * packet.inverseY[l];
+      double tz0 = (node.boundsMin.z - packet.originZ[l]) * packet.inverseZ[l];
+      double tz1 = (node.boundsMax.z - packet.originZ[l]) * packet.inverseZ[l];
+
+      double tNear = std::max(std::max(std::min(tx0, tx1), std::min(ty0, ty1)),
+                              std::max(std::min(tz0, tz1), packet.tMin[l]));
+      double tFar = std::min(std::min(std::max(tx0, tx1), std::max(ty0, ty1)),
+                             std::min(std::max(tz0, tz1), packet.tMax[l]));
+
+      anyLane |= (tNear <= tFar * BOUNDS_PADDING);
+    }
+
+    if (!anyLane) {
+      continue;
+    }
+
+    /* inner node: visit the near child first */
+    if (0u == node.count) {
+      if (negative[node.axis]) {
+        stack.emplace_back(nodeIndex + 1u);
+        stack.emplace_back(node.offset);
+      } else {
+        stack.emplace_back(node.offset);
+        stack.emplace_back(nodeIndex + 1u);
+      }
+      continue;
+    }
+
+    /* leaf: intersect its triangles with every lane (Moller-Trumbore) */
+    for (uint32_t i = node.offset; i < node.offset + node.count; ++i) {
+      const glm::dvec3& v0 = vertices0_[i];
+      const glm::dvec3& e1 = edges1_[i];
+      const glm::dvec3& e2 = edges2_[i];
+
+      double laneT[RAY_PACKET_SIZE];
+      double laneU[RAY_PACKET_SIZE];
+      double laneV[RAY_PACKET_SIZE];
+      bool laneHit[RAY_PACKET_SIZE];
+      bool anyHit = false;
+
+      for (size_t l = 0u; l < RAY_PACKET_SIZE; ++l) {
+        /* p = cross(direction, e2) */
+        double px = packet.directionY[l] * e2.z - packet.directionZ[l] * e2.y;
+        double py = packet.directionZ[l] * e2.x - packet.directionX[l] * e2.z;
+        double pz = packet.directionX[l] * e2.y - packet.directionY[l] * e2.x;
+        double inverseDet = 1.0 / (e1.x * px + e1.y * py + e1.z * pz);
+
+        /* s = origin - v0, q = cross(s, e1) */
+        double sx = packet.originX[l] - v0.x;
+        double sy = packet.originY[l] - v0.y;
+        double sz = packet.originZ[l] - v0.z;
+        double qx = sy * e1.z - sz * e1.y;
+        double qy = sz * e1.x - sx * e1.z;
+        double qz = sx * e1.y - sy * e1.x;
+
+        laneU[l] = (sx * px + sy * py + sz * pz) * inverseDet;
+        laneV[l] = (packet.directionX[l] * qx + packet.directionY[l] * qy + packet.directionZ[l] * qz) * inverseDet;
+        laneT[l] = (e2.x * qx + e2.y * qy + e2.z * qz) * inverseDet;
+
+        /* written positively, so a parallel ray (NaN) never counts as a hit */
+        laneHit[l] = (laneU[l] >= 0.0) && (laneV[l] >= 0.0) && (laneU[l] + laneV[l] <= 1.0) &&
+                     (laneT[l] >= packet.tMin[l]) && (laneT[l] <= packet.tMax[l]);
+        anyHit |= laneHit[l];
+      }
+
+      if (!anyHit) {
+        continue;
+      }
+
+      for (size_t l = 0u; l < packet.size; ++l) {
+        if (!laneHit[l]) {
+          continue;
+        }
+
+        RayHit hit;
+        hit.triangle = triangleIds_[i];
+        hit.t = laneT[l];
+        hit.u = laneU[l];
+        hit.v = laneV[l];
+
+        switch (query) {
+        case Query::QUERY_FIRST:
+          hits[l] = hit;
+          packet.tMax[l] = hit.t;
+          break;
+        case Query::QUERY_ANY:
+          /* the lane is finished, an empty interval disables it */
+          hits[l] = hit;
+          packet.tMin[l] = std::numeric_limits<double>::infinity();
+          packet.tMax[l] = -std::numeric_limits<double>::infinity();
+          break;
+        case Query::QUERY_ALL:
+          allHits[l].emplace_back(hit);
+          break;
+        }
+      }
+    }
+  }
+}
+
+void Bvh::tracePackets(const std::vector<Ray>& rays, Query query, RayHit* hits, std::vector<RayHit>* allHits) const {
+  if (nodes_.empty()) {
+    return;
+  }
+
+  RayPacket packet;
+  packet.stack.reserve(64u);
+
+  for (size_t first = 0u; first < rays.size(); first += RAY_PACKET_SIZE) {
+    packet.size = std::min(RAY_PACKET_SIZE, rays.size() - first);
+
+    for (size_t l = 0u; l < RAY_PACKET_SIZE; ++l) {
+      /* unused lanes of a partial packet repeat the first ray with an empty interval */
+      const Ray& ray = rays[first + ((l < packet.size) ? l : 0u)];
+      glm::dvec3 inverse = safeInverse(ray.direction);
+
+      packet.originX[l] = ray.origin.x;
+      packet.originY[l] = ray.origin.y;
+      packet.originZ[l] = ray.origin.z;
+      packet.directionX[l] = ray.direction.x;
+      packet.directionY[l] = ray.direction.y;
+      packet.directionZ[l] = ray.direction.z;
+      packet.inverseX[l] = inverse.x;
+      packet.inverseY[l] = inverse.y;
+      packet.inverseZ[l] = inverse.z;
+      packet.tMin[l] = (l < packet.size) ? ray.tMin : std::numeric_limits<double>::infinity();
+      packet.tMax[l] = (l < packet.size) ? ray.tMax : -std::numeric_limits<double>::infinity();
+    }
+
+    traverse(packet, query, (nullptr != hits) ? (hits + first) : nullptr,
+             (nullptr != allHits) ? (allHits + first) : nullptr);
+  }
+}
+
+std::vector<RayHit> Bvh::firstHits(const std::vector<Ray>& rays) const {
+  std::vector<RayHit> hits(rays.size());
+  tracePackets(rays, Query::QUERY_FIRST, hits.data(), nullptr);
+
+  return hits;
+}
+
+std::vector<RayHit> Bvh::anyHits(const std::vector<Ray>& rays) const {
+  std::vector<RayHit> hits(rays.size());
+  tracePackets(rays, Query::QUERY_ANY, hits.data(), nullptr);
+
+  return hits;
+}
+
+std::vector<std::vector<RayHit>> Bvh::allHits(const std::vector<Ray>& rays) const {
+  std::vector<std::vector<RayHit>> hits(rays.size());
+  tracePackets(rays, Query::QUERY_ALL, nullptr, hits.data());
+
+  /* order the hits along every ray */
+  for (auto& h : hits) {
+    std::sort(h.begin(), h.end(), [](const RayHit& a, const RayHit& b) { return a.t < b.t; });
+  }
+
+  return hits;
+}
+
+void Bvh::collectCandidates(const glm::dvec3& from, const glm::dvec3& to, std::vector<uint32_t>& candidates) const {
+  if (nodes_.empty()) {
+    return;
+  }
+
+  glm::dvec3 inverse = safeInverse(to - from);
+
+  std::vector<uint32_t> stack;
+  stack.reserve(64u);
+  stack.emplace_back(0u);
+
+  while (!stack.empty()) {
+    const uint32_t nodeIndex = stack.back();
+    const BvhNode& node = nodes_[nodeIndex];
+    stack.pop_back();
+
+    /* slab test of the segment (t in [0, 1]) against the node bounds */
+    glm::dvec3 t0 = (node.boundsMin - from) * inverse;
+    glm::dvec3 t1 = (node.boundsMax - from) * inverse;
+    glm::dvec3 tNear = glm::min(t0, t1);
+    glm::dvec3 tFar = glm::max(t0, t1);
+    double enter = std::max(std::max(tNear.x, tNear.y), std::max(tNear.z, 0.0));
+    double exit = std::min(std::min(tFar.x, tFar.y), std::min(tFar.z, 1.0));
+    if (enter > exit * BOUNDS_PADDING) {
+      continue;
+    }
+
+    if (0u == node.count) {
+      stack.emplace_back(node.offset);
+      stack.emplace_back(nodeIndex + 1u);
+      continue;
+    }
+
+    for (uint32_t i = node.offset; i < node.offset + node.count; ++i) {
+      candidates.emplace_back(triangleIds_[i]);
+    }
+  }
+}
+
+} // namespace conv
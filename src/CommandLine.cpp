@@ -0,0 +1,377 @@
+#include "CommandLine.h"
+#include "BatchConverter.h"
+#include "Daemon.h"
+#include "Utils.h"
+
+#include <chrono>
+#include <filesystem>
+#include <thread>
+
+
+namespace conv {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr double MEGA = 1e6;
+
+const char* const USAGE =
+  "usage: 3dfc [options] <input>...\n"
+  "       3dfc --daemon <socket>\n"
+  "\n"
+  "Converts 3D files, the input formats are detected from the content of the files.\n"
+  "Inputs may be globs ('*' and '?' in the file name).\n"
+  "\n"
+  "options:\n"
+  "  -o, --output <path>      output file (single input) or directory (default: next to the input)\n"
+  "  -f, --format <name>      output format: stl, stl-ascii, ply, glb, obj, off, 3mf, 3dfc, 3dfz, 3dfe (default: by the extension of -o, else stl)\n"
+  "  -j, --jobs <N>           number of files read and written at the same time (default: 2)\n"
+  "  -r, --rotate <x,y,z>     rotate by the angles in radians\n"
+  "  -s, --scale <x,y,z>      scale by the factors\n"
+  "  -t, --translate <x,y,z>  translate by the offset\n"
+  "      --optimize-cache     reorder the triangles and vertices for the vertex cache of GPUs\n"
+  "      --stats              print throughput statistics of the stages and the process RSS (max sampled)\n"
+  "      --cache <dir>        reuse the outputs of identical conversions stored in the directory\n"
+  "      --cache-size <MB>    size limit of the cache (default: 1024)\n"
+  "      --daemon <socket>    serve conversions on the Unix socket, keeping recently loaded meshes\n"
+  "      --connect <socket>   send the conversions to the daemon listening on the socket\n"
+  "      --shutdown           stop the daemon given by --connect\n"
+  "  -h, --help               print this help\n"
+  "\n"
+  "The transformations are applied in the order given on the command line.\n"
+  "Exit codes: 0 success, 1 some files could not be converted, 2 invalid command line.\n";
+
+/* function to parse a number, the whole text must be used */
+double parseNumber(const std::string& text) {
+  size_t used = 0u;
+  double value = 0.0;
+  try {
+    value = std::stod(text, &used);
+  } catch (const std::exception&) {
+    used = 0u;
+  }
+
+  if (used == 0u || used != text.size()) {
+    throw std::invalid_argument("Not a number: " + text);
+  }
+
+  return value;
+}
+
+/* function to parse a "x,y,z" vector */
+glm::dvec3 parseVector(const std::string& text) {
+  auto parts = utils::split(text, ',');
+  if (parts.size() != 3u) {
+    throw std::invalid_argument("Expected x,y,z instead of: " + text);
+  }
+
+  glm::dvec3 v;
+  for (glm::length_t i = 0; i < 3; ++i) {
+    v[i] = parseNumber(parts[i]);
+  }
+
+  return v;
+}
+
+/* function to expand a glob in the file name of the input (the directories must not contain wildcards) */
+std::vector<std::string> expandInput(const std::string& input) {
+  fs::path path(input);
+  const std::string pattern = path.filename().string();
+  if (pattern.find_first_of("*?") == std::string::npos) {
+    return {input};
+  }
+
+  fs::path directory = path.has_parent_path() ? path.parent_path() : fs::path(".");
+  std::vector<std::string> matches;
+  std::error_code error;
+  for (const auto& entry : fs::directory_iterator(directory, error)) {
+    if (entry.is_regular_file() && utils::matchesWildcard(entry.path().filename().string(), pattern)) {
+      matches.emplace_back((path.has_parent_path() ? entry.path() : entry.path().filename()).string());
+    }
+  }
+  std::sort(matches.begin(), matches.end());
+
+  return matches;
+}
+
+/* function to create the jobs of the inputs */
+std::vector<BatchJob> createJobs(const CommandLine& commandLine, std::ostream& err) {
+  std::vector<std::string> inputs;
+  for (const auto& input : commandLine.inputs) {
+    auto matches = expandInput(input);
+    if (matches.empty()) {
+      err << "*** [WRN] No file matches: " << input << " ***" << std::endl;
+    }
+    inputs.insert(inputs.end(), matches.begin(), matches.end());
+  }
+
+  /* the output is a directory if there are more inputs, or if it is one already */
+  const fs::path output(commandLine.output);
+  const bool isDirectory = !commandLine.output.empty() &&
+                           (inputs.size() > 1u || fs::is_directory(output) ||
+                            commandLine.output.back() == '/' || commandLine.output.back() == '\\');
+  if (isDirectory) {
+    fs::create_directories(output);
+  }
+
+  /* generated output names get the first extension of the output format */
+  const std::string format = commandLine.format.empty() ? std::string("stl") : commandLine.format;
+  const std::string extension = FormatRegistry::instance().writer(format)->extensions.front();
+
+  std::vector<BatchJob> jobs;
+  for (const auto& input : inputs) {
+    BatchJob job;
+    job.inputPath = input;
+    if (commandLine.output.empty()) {
+      job.outputPath = fs::path(input).replace_extension(extension).string();
+    } else if (isDirectory) {
+      job.outputPath = (output / fs::path(input).filename().replace_extension(extension)).string();
+    } else {
+      job.outputPath = commandLine.output;
+    }
+    job.transforms = commandLine.transforms;
+    jobs.emplace_back(job);
+  }
+
+  return jobs;
+}
+
+/* function to print the statistics of a stage */
+void printStage(std::ostream& out, const std::string& name, const StageStatistics& stage) {
+  out << std::left << std::setw(10) << name << std::right
+            << std::setw(8) << stage.numOfJobs
+            << std::setw(12) << std::fixed << std::setprecision(2) << (stage.numOfBytes / MEGA)
+            << std::setw(12) << (stage.bytesPerSecond() / MEGA)
+            << std::setw(14) << (stage.trianglesPerSecond() / MEGA)
+            << std::setw(12) << std::setprecision(3) << stage.busySeconds
+            << std::setw(31) << std::setprecision(1) << (stage.maxResidentBytes / MEGA) << std::endl;
+}
+
+/* function to print the statistics of the batch */
+void printStatistics(std::ostream& out, const BatchReport& report) {
+  out << std::left << std::setw(10) << "stage" << std::right
+            << std::setw(8) << "jobs"
+            << std::setw(12) << "MB"
+            << std::setw(12) << "MB/s"
+            << std::setw(14) << "Mtri/s"
+            << std::setw(12) << "busy s"
+            << std::setw(31) << "process RSS (max sampled) MB" << std::endl;
+  printStage(out, "read", report.read);
+  printStage(out, "transform", report.transform);
+  printStage(out, "write", report.write);
+
+  const uint64_t numOfTriangles = report.write.numOfTriangles;
+  out << "wall time: " << std::fixed << std::setprecision(3) << report.wallSeconds << " s, "
+            << std::setprecision(2) << ((report.wallSeconds > 0.0) ? (numOfTriangles / report.wallSeconds / MEGA) : 0.0)
+            << " Mtri/s end to end" << std::endl;
+  if (0u != report.numOfCacheHits) {
+    out << "cache hits: " << report.numOfCacheHits << std::endl;
+  }
+  if (0u != report.vertexCache.numOfTriangles) {
+    out << "vertex cache: ACMR " << std::setprecision(3) << report.vertexCache.acmrBefore() << " -> "
+              << report.vertexCache.acmrAfter() << " (" << VERTEX_CACHE_SIZE << " entries)" << std::endl;
+  }
+}
+
+/* function to convert the jobs on the daemon, numOfJobs connections send their requests at the same time */
+BatchReport runOnDaemon(const CommandLine& commandLine, const std::vector<BatchJob>& jobs) {
+  BatchReport report;
+  std::mutex reportMutex;
+  std::atomic<size_t> nextJob{0u};
+  const auto start = std::chrono::steady_clock::now();
+
+  auto connection = [&]() {
+    DaemonClient client(commandLine.connectSocket);
+    for (size_t job = nextJob++; job < jobs.size(); job = nextJob++) {
+      /* the daemon does not share the working directory */
+      const std::string input = fs::absolute(jobs[job].inputPath).string();
+      const std::string output = fs::absolute(jobs[job].outputPath).string();
+      try {
+        const auto requestStart = std::chrono::steady_clock::now();
+        size_t numOfTriangles = client.convert(input, output, jobs[job].transforms, commandLine.format);
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - requestStart).count();
+
+        std::lock_guard<std::mutex> lock(reportMutex);
+        report.write.numOfJobs++;
+        report.write.numOfTriangles += numOfTriangles;
+        report.write.numOfBytes += fs::file_size(output);
+        report.write.busySeconds += seconds;
+      } catch (const std::exception& e) {
+        std::lock_guard<std::mutex> lock(reportMutex);
+        report.failures.push_back({job, e.what()});
+      }
+    }
+  };
+
+  std::vector<std::thread> connections;
+  for (size_t i = 1u; i < std::min(commandLine.numOfJobs, jobs.size()); ++i) {
+    connections.emplace_back(connection);
+  }
+  connection();
+  for (auto& t : connections) {
+    t.join();
+  }
+
+  report.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  std::sort(report.failures.begin(), report.failures.end(),
+            [](const BatchFailure& a, const BatchFailure& b) { return a.job < b.job; });
+
+  return report;
+}
+
+} // namespace
+
+CommandLine parseCommandLine(int argc, const char* const* argv) {
+  CommandLine commandLine;
+
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+
+    /* value of the option */
+    auto value = [&]() {
+      if (i + 1 >= argc) {
+        throw std::invalid_argument("Missing value of option: " + arg);
+      }
+      return std::string(argv[++i]);
+    };
+
+    if (arg == "-h" || arg == "--help") {
+      commandLine.help = true;
+    } else if (arg == "-o" || arg == "--output") {
+      commandLine.output = value();
+    } else if (arg == "-f" || arg == "--format") {
+      commandLine.format = value();
+      if (!FormatRegistry::instance().writer(commandLine.format)) {
+        throw std::invalid_argument("Unknown output format: " + commandLine.format);
+      }
+    } else if (arg == "-j" || arg == "--jobs") {
+      std::string jobs = value();
+      double numOfJobs = parseNumber(jobs);
+      if (numOfJobs < 1.0 || numOfJobs != std::floor(numOfJobs) || numOfJobs > 1024.0) {
+        throw std::invalid_argument("Invalid number of jobs: " + jobs);
+      }
+      commandLine.numOfJobs = static_cast<size_t>(numOfJobs);
+    } else if (arg == "-r" || arg == "--rotate") {
+      commandLine.transforms.push_back({TransformType::TRANSFORM_TYPE_ROTATE, parseVector(value())});
+    } else if (arg == "-s" || arg == "--scale") {
+      commandLine.transforms.push_back({TransformType::TRANSFORM_TYPE_SCALE, parseVector(value())});
+    } else if (arg == "-t" || arg == "--translate") {
+      commandLine.transforms.push_back({TransformType::TRANSFORM_TYPE_TRANSLATE, parseVector(value())});
+    } else if (arg == "--optimize-cache") {
+      commandLine.transforms.push_back({TransformType::TRANSFORM_TYPE_OPTIMIZE_VERTEX_CACHE, glm::dvec3(0.0)});
+    } else if (arg == "--stats") {
+      commandLine.stats = true;
+    } else if (arg == "--cache") {
+      commandLine.cacheDirectory = value();
+    } else if (arg == "--cache-size") {
+      std::string size = value();
+      commandLine.cacheSizeInMegabytes = parseNumber(size);
+      if (commandLine.cacheSizeInMegabytes < 0.0) {
+        throw std::invalid_argument("Invalid cache size: " + size);
+      }
+    } else if (arg == "--daemon") {
+      commandLine.daemonSocket = value();
+    } else if (arg == "--connect") {
+      commandLine.connectSocket = value();
+    } else if (arg == "--shutdown") {
+      commandLine.shutdown = true;
+    } else if (arg.size() > 1u && arg[0] == '-') {
+      throw std::invalid_argument("Unknown option: " + arg);
+    } else {
+      commandLine.inputs.emplace_back(arg);
+    }
+  }
+
+  /* the conversions run in the daemon, which does not use the cache */
+  if (!commandLine.connectSocket.empty() && !commandLine.cacheDirectory.empty()) {
+    throw std::invalid_argument("--cache cannot be used with --connect");
+  }
+
+  return commandLine;
+}
+
+int runCommandLine(int argc, const char* const* argv, std::ostream& out, std::ostream& err) {
+  /* catch exceptions of the command line and the batch */
+  try {
+    CommandLine commandLine = parseCommandLine(argc, argv);
+    if (commandLine.help) {
+      out << USAGE;
+      return EXIT_CODE_SUCCESS;
+    }
+
+    /* daemon mode: serve until a shutdown request */
+    if (!commandLine.daemonSocket.empty()) {
+      DaemonOptions options;
+      options.socketPath = commandLine.daemonSocket;
+      ConversionDaemon daemon(options);
+      daemon.run();
+      return EXIT_CODE_SUCCESS;
+    }
+
+    if (commandLine.shutdown) {
+      if (commandLine.connectSocket.empty()) {
+        throw std::invalid_argument("--shutdown needs --connect");
+      }
+      DaemonClient(commandLine.connectSocket).shutdown();
+      return EXIT_CODE_SUCCESS;
+    }
+
+    if (commandLine.inputs.empty()) {
+      err << USAGE;
+      return EXIT_CODE_USAGE;
+    }
+
+    std::vector<BatchJob> jobs = createJobs(commandLine, err);
+    if (jobs.empty()) {
+      err << "*** [ERR] No input files ***" << std::endl;
+      return EXIT_CODE_FAILED_JOBS;
+    }
+
+    BatchReport report;
+    if (!commandLine.connectSocket.empty()) {
+      report = runOnDaemon(commandLine, jobs);
+    } else {
+      BatchOptions options;
+      options.numOfReaders = commandLine.numOfJobs;
+      options.numOfWriters = commandLine.numOfJobs;
+      options.maxNumOfMeshes = 2u * commandLine.numOfJobs;
+      if (!commandLine.format.empty()) {
+        options.output = FormatRegistry::instance().writer(commandLine.format)->type;
+      }
+      if (!commandLine.cacheDirectory.empty()) {
+        options.cache = std::make_shared<ConversionCache>(commandLine.cacheDirectory,
+                                                          static_cast<uint64_t>(commandLine.cacheSizeInMegabytes * MEGA));
+      }
+
+      report = BatchConverter(options).run(jobs);
+    }
+
+    for (const auto& failure : report.failures) {
+      err << "*** [ERR] " << jobs[failure.job].inputPath << ": " << failure.message << " ***" << std::endl;
+    }
+    if (commandLine.stats && commandLine.connectSocket.empty()) {
+      printStatistics(out, report);
+    } else if (commandLine.stats) {
+      /* the stages run in the daemon, only the requests are measured */
+      out << report.write.numOfJobs << " files converted by the daemon, " << report.write.numOfTriangles
+                << " triangles in " << std::fixed << std::setprecision(3) << report.wallSeconds << " s" << std::endl;
+    }
+
+    return report.failures.empty() ? EXIT_CODE_SUCCESS : EXIT_CODE_FAILED_JOBS;
+
+  /* error handling */
+  } catch (const std::invalid_argument& ia) {
+    err << "*** [ERR] Invalid argument: " << ia.what() << " ***" << std::endl;
+    err << USAGE;
+    return EXIT_CODE_USAGE;
+  } catch (const std::exception& e) {
+    err << "*** [ERR] Exception occurred: " << e.what() << " ***" << std::endl;
+  } catch (...) {
+    err << "*** [ERR] Unknown error occurred ***" << std::endl;
+  }
+
+  return EXIT_CODE_FAILED_JOBS;
+}
+
+} // namespace conv
@@ -0,0 +1,221 @@
+#include "ConversionCache.h"
+#include "Hash.h"
+#include "MappedFile.h"
+
+#include <atomic>
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#endif
+
+
+namespace conv {
+
+namespace fs = std::filesystem;
+
+/* stored outputs are named by the 16 hexadecimal digits of their key */
+constexpr size_t KEY_DIGITS = 16u;
+const char* const ENTRY_EXTENSION = ".bin";
+
+namespace {
+
+/* function to append the bytes of the value to the buffer */
+template <typename T>
+void append(std::vector<uint8_t>& buffer, const T& value) {
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+  buffer.insert(buffer.end(), bytes, bytes + sizeof(value));
+}
+
+/* function to format the key as hexadecimal digits */
+std::string formatKey(uint64_t key) {
+  std::ostringstream stream;
+  stream << std::hex << std::setw(KEY_DIGITS) << std::setfill('0') << key;
+  return stream.str();
+}
+
+/* function to clone or copy the file under the temporary name and rename it over the target, so a reader
+ * never sees a partial target */
+void cloneOrCopyAndRename(const fs::path& source, const fs::path& target, const fs::path& temporary) {
+  try {
+    cloneOrCopyFile(source, temporary);
+    fs::rename(temporary, target);
+  } catch (const std::exception&) {
+    std::error_code error;
+    fs::remove(temporary, error);
+    throw;
+  }
+}
+
+} // namespace
+
+void cloneOrCopyFile(const fs::path& source, const fs::path& target) {
+#ifdef __linux__
+  /* a clone shares the blocks of the source until one of them is written */
+  int sourceFile = ::open(source.c_str(), O_RDONLY);
+  if (sourceFile >= 0) {
+    int targetFile = ::open(target.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    bool isCloned = (targetFile >= 0) && (::ioctl(targetFile, FICLONE, sourceFile) == 0);
+    if (targetFile >= 0) {
+      ::close(targetFile);
+    }
+    ::close(sourceFile);
+
+    if (isCloned) {
+      return;
+    }
+  }
+#endif
+
+  fs::copy_file(source, target, fs::copy_options::overwrite_existing);
+}
+
+ConversionCache::ConversionCache(const std::string& directory, uint64_t maxSizeInBytes)
+    : directory_(directory), maxSizeInBytes_(maxSizeInBytes) {
+  fs::create_directories(directory_);
+
+  /* outputs stored by earlier runs, ordered by their last use */
+  std::vector<std::pair<fs::file_time_type, uint64_t>> stored;
+  for (const auto& file : fs::directory_iterator(directory_)) {
+    const std::string name = file.path().filename().string();
+    if (!file.is_regular_file() || name.size() != KEY_DIGITS + std::strlen(ENTRY_EXTENSION) ||
+        file.path().extension() != ENTRY_EXTENSION) {
+      continue;
+    }
+
+    uint64_t key = 0u;
+    try {
+      size_t used = 0u;
+      key = std::stoull(name.substr(0u, KEY_DIGITS), &used, 16);
+      if (used != KEY_DIGITS) {
+        continue;
+      }
+    } catch (const std::exception&) {
+      continue;
+    }
+
+    stored.emplace_back(file.last_write_time(), key);
+    entries_[key].size = file.file_size();
+    sizeInBytes_ += entries_[key].size;
+  }
+
+  std::sort(stored.begin(), stored.end(), std::greater<std::pair<fs::file_time_type, uint64_t>>());
+  for (const auto& s : stored) {
+    order_.push_back(s.second);
+    entries_[s.second].position = std::prev(order_.end());
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  evict();
+}
+
+uint64_t ConversionCache::key(const std::string& inputPath, InputType input, OutputType output,
+                              const std::vector<Transform>& transforms) {
+  MappedFile file(inputPath);
+  return key(file.data(), file.size(), input, output, transforms);
+}
+
+uint64_t ConversionCache::key(const uint8_t* bytes, size_t size, InputType input, OutputType output,
+                              const std::vector<Transform>& transforms) {
+  std::vector<uint8_t> description;
+  append(description, CONVERSION_CACHE_VERSION);
+  append(description, hash64(bytes, size));
+  append(description, static_cast<uint64_t>(size));
+  append(description, input);
+  append(description, output);
+  for (const auto& t : transforms) {
+    append(description, t.type);
+    append(description, t.value.x);
+    append(description, t.value.y);
+    append(description, t.value.z);
+  }
+
+  return hash64(description.data(), description.size());
+}
+
+fs::path ConversionCache::entryPath(uint64_t key) const {
+  return directory_ / (formatKey(key) + ENTRY_EXTENSION);
+}
+
+bool ConversionCache::fetch(uint64_t key, const std::string& outputPath) {
+  static std::atomic<uint64_t> numOfFetches{0u};
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    if (it == entries_.end()) {
+      return false;
+    }
+
+    order_.splice(order_.begin(), order_, it->second.position);
+    it->second.position = order_.begin();
+  }
+
+  try {
+    /* an existing output stays untouched until the whole fetched output replaces it */
+    cloneOrCopyAndRename(entryPath(key), outputPath,
+                         outputPath + ".tmp" + std::to_string(::getpid()) + "_" + std::to_string(numOfFetches++));
+  } catch (const std::exception&) {
+    /* removed in the meantime (by another process) */
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+      sizeInBytes_ -= it->second.size;
+      order_.erase(it->second.position);
+      entries_.erase(it);
+    }
+    return false;
+  }
+
+  /* the modification time keeps the use for the next runs */
+  std::error_code error;
+  fs::last_write_time(entryPath(key), fs::file_time_type::clock::now(), error);
+
+  return true;
+}
+
+void ConversionCache::store(uint64_t key, const std::string& outputPath) {
+  static std::atomic<uint64_t> numOfStores{0u};
+
+  /* written under a temporary name first, so a reader never sees a partial output */
+  const fs::path entry = entryPath(key);
+  const fs::path temporary = directory_ / (formatKey(key) + ".tmp" + std::to_string(::getpid()) + "_" +
+                                           std::to_string(numOfStores++));
+  cloneOrCopyAndRename(outputPath, entry, temporary);
+  const uint64_t size = fs::file_size(entry);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entries_.find(key);
+  if (it != entries_.end()) {
+    sizeInBytes_ -= it->second.size;
+    order_.erase(it->second.position);
+  }
+
+  order_.push_front(key);
+  entries_[key] = {size, order_.begin()};
+  sizeInBytes_ += size;
+
+  evict();
+}
+
+uint64_t ConversionCache::sizeInBytes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return sizeInBytes_;
+}
+
+void ConversionCache::evict() {
+  while (sizeInBytes_ > maxSizeInBytes_ && !order_.empty()) {
+    const uint64_t key = order_.back();
+    std::error_code error;
+    fs::remove(entryPath(key), error);
+
+    sizeInBytes_ -= entries_[key].size;
+    entries_.erase(key);
+    order_.pop_back();
+  }
+}
+
+} // namespace conv
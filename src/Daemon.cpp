@@ -0,0 +1,587 @@
+#include "Daemon.h"
+#include "Utils.h"
+
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+
+namespace conv {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+/* size of the receive buffer of the sockets */
+constexpr size_t RECEIVE_SIZE_IN_BYTES = 65536u;
+
+/* waiting time before accepting again when the process is out of descriptors or memory */
+constexpr auto ACCEPT_BACKOFF = std::chrono::milliseconds(100);
+
+/* function to fill the address of the socket file */
+sockaddr_un socketAddress(const std::string& socketPath) {
+  sockaddr_un address;
+  std::memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+
+  if (socketPath.empty() || socketPath.size() >= sizeof(address.sun_path)) {
+    throw std::invalid_argument(std::string("Invalid socket path: ") + socketPath);
+  }
+  std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size());
+
+  return address;
+}
+
+/*
+ * function to remove the socket file left behind by a previous daemon
+ * throws if the path is not a socket or a daemon still answers on it
+ */
+void removeStaleSocket(const std::string& socketPath, const sockaddr_un& address) {
+  struct stat status;
+  if (::lstat(socketPath.c_str(), &status) < 0) {
+    if (errno == ENOENT) {
+      return;
+    }
+    throw std::runtime_error("Cannot check socket " + socketPath + ": " + std::strerror(errno));
+  }
+  if (!S_ISSOCK(status.st_mode)) {
+    throw std::runtime_error("Not a socket, refusing to replace: " + socketPath);
+  }
+
+  int probe = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (probe < 0) {
+    throw std::runtime_error(std::string("Cannot create socket: ") + std::strerror(errno));
+  }
+  int result = ::connect(probe, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+  int error = errno;
+  ::close(probe);
+
+  if (result == 0) {
+    throw std::runtime_error("A daemon is already listening on socket: " + socketPath);
+  }
+  if (error != ECONNREFUSED) {
+    throw std::runtime_error("Cannot check socket " + socketPath + ": " + std::strerror(error));
+  }
+  ::unlink(socketPath.c_str());
+}
+
+/* function to send every byte of the data */
+void sendAll(int socket, const std::string& data) {
+  size_t sent = 0u;
+  while (sent < data.size()) {
+    ssize_t result = ::send(socket, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+    if (result < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::runtime_error(std::string("Cannot send on socket: ") + std::strerror(errno));
+    }
+    sent += static_cast<size_t>(result);
+  }
+}
+
+/*
+ * function to receive the next line (without the line break), returns false if the peer closed the connection
+ * throws std::length_error if the line exceeds DAEMON_MAX_LINE_SIZE_IN_BYTES
+ */
+bool receiveLine(int socket, std::string& buffer, std::string& line) {
+  size_t end = buffer.find('\n');
+  while (end == std::string::npos) {
+    char received[RECEIVE_SIZE_IN_BYTES];
+    ssize_t result = ::recv(socket, received, sizeof(received), 0);
+    if (result < 0 && errno == EINTR) {
+      continue;
+    }
+    if (result <= 0) {
+      return false;
+    }
+
+    size_t searchFrom = buffer.size();
+    buffer.append(received, static_cast<size_t>(result));
+    end = buffer.find('\n', searchFrom);
+    if (end == std::string::npos && buffer.size() > DAEMON_MAX_LINE_SIZE_IN_BYTES) {
+      throw std::length_error("Line longer than " + std::to_string(DAEMON_MAX_LINE_SIZE_IN_BYTES) + " bytes");
+    }
+  }
+
+  line = buffer.substr(0u, end);
+  buffer.erase(0u, end + 1u);
+
+  return true;
+}
+
+/* function to format a number without losing precision */
+std::string formatNumber(double value) {
+  std::ostringstream stream;
+  stream << std::setprecision(17) << value;
+  return stream.str();
+}
+
+/* function to format a vector as x,y,z */
+std::string formatVector(const glm::dvec3& v) {
+  return formatNumber(v.x) + "," + formatNumber(v.y) + "," + formatNumber(v.z);
+}
+
+/* function to parse a vector from x,y,z */
+glm::dvec3 parseVector(const std::string& text) {
+  auto parts = utils::split(text, ',');
+  if (parts.size() != 3u) {
+    throw std::invalid_argument("Expected x,y,z instead of: " + text);
+  }
+
+  return glm::dvec3(std::stod(parts[0]), std::stod(parts[1]), std::stod(parts[2]));
+}
+
+/* function to encode the transformations as request fields */
+std::string formatTransforms(const std::vector<Transform>& transforms) {
+  std::string fields;
+  for (const auto& t : transforms) {
+    switch (t.type) {
+    case TransformType::TRANSFORM_TYPE_ROTATE:
+      fields += DAEMON_FIELD_SEPARATOR + std::string("rotate=");
+      break;
+    case TransformType::TRANSFORM_TYPE_SCALE:
+      fields += DAEMON_FIELD_SEPARATOR + std::string("scale=");
+      break;
+    case TransformType::TRANSFORM_TYPE_TRANSLATE:
+      fields += DAEMON_FIELD_SEPARATOR + std::string("translate=");
+      break;
+    case TransformType::TRANSFORM_TYPE_OPTIMIZE_VERTEX_CACHE:
+      fields += DAEMON_FIELD_SEPARATOR + std::string("optimize-cache=");
+      break;
+    }
+    fields += formatVector(t.value);
+  }
+
+  return fields;
+}
+
+/* parameters of a request */
+struct DaemonRequest {
+  std::string command;
+  std::string input;
+  std::string output;
+  std::string format;
+  std::vector<Transform> transforms;
+  std::vector<glm::dvec3> points;
+};
+
+/* function to decode a request line */
+DaemonRequest parseRequest(const std::string& line) {
+  auto fields = utils::split(line, DAEMON_FIELD_SEPARATOR);
+  if (fields.empty()) {
+    throw std::invalid_argument("Empty request");
+  }
+
+  DaemonRequest request;
+  request.command = fields[0];
+  for (size_t i = 1u; i < fields.size(); ++i) {
+    size_t separator = fields[i].find('=');
+    if (separator == std::string::npos) {
+      throw std::invalid_argument("Expected key=value instead of: " + fields[i]);
+    }
+
+    const std::string key = fields[i].substr(0u, separator);
+    const std::string value = fields[i].substr(separator + 1u);
+    if (key == "input") {
+      request.input = value;
+    } else if (key == "output") {
+      request.output = value;
+    } else if (key == "format") {
+      request.format = value;
+    } else if (key == "rotate") {
+      request.transforms.push_back({TransformType::TRANSFORM_TYPE_ROTATE, parseVector(value)});
+    } else if (key == "scale") {
+      request.transforms.push_back({TransformType::TRANSFORM_TYPE_SCALE, parseVector(value)});
+    } else if (key == "translate") {
+      request.transforms.push_back({TransformType::TRANSFORM_TYPE_TRANSLATE, parseVector(value)});
+    } else if (key == "optimize-cache") {
+      request.transforms.push_back({TransformType::TRANSFORM_TYPE_OPTIMIZE_VERTEX_CACHE, parseVector(value)});
+    } else if (key == "point") {
+      request.points.emplace_back(parseVector(value));
+    } else {
+      throw std::invalid_argument("Unknown request field: " + key);
+    }
+  }
+
+  return request;
+}
+
+/* function to check whether the load of the entry has finished with an exception */
+template <typename Entry>
+bool isFailed(const Entry& entry) {
+  if (entry.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+    return false;
+  }
+
+  try {
+    entry.get();
+  } catch (...) {
+    return true;
+  }
+  return false;
+}
+
+/* function to get a session with the transformed copy of the loaded mesh */
+std::unique_ptr<FileConverter> transformedCopy(const LoadedMesh& mesh, const std::vector<Transform>& transforms) {
+  auto session = std::make_unique<FileConverter>();
+  session->setMesh(mesh.converter->mesh());
+  for (const auto& t : transforms) {
+    applyTransform(*session, t);
+  }
+
+  return session;
+}
+
+} // namespace
+
+std::shared_ptr<const LoadedMesh> LoadedMeshCache::load(const std::string& pathToFile) {
+  auto loaded = std::make_shared<LoadedMesh>();
+  loaded->modified = fs::last_write_time(pathToFile);
+  loaded->size = fs::file_size(pathToFile);
+
+  auto converter = std::make_shared<FileConverter>();
+  converter->setInputFormat(InputType::INPUT_TYPE_AUTO);
+  converter->read(pathToFile);
+
+  /* concurrent requests only read the mesh and its structures */
+  converter->buildQueryStructures();
+  loaded->converter = converter;
+
+  return loaded;
+}
+
+void LoadedMeshCache::touch(const std::string& key) {
+  auto& position = entries_.at(key).second;
+  order_.splice(order_.begin(), order_, position);
+  position = order_.begin();
+}
+
+std::shared_ptr<const LoadedMesh> LoadedMeshCache::get(const std::string& pathToFile) {
+  const std::string key = fs::absolute(pathToFile).lexically_normal().string();
+
+  std::error_code timeError;
+  std::error_code sizeError;
+  const auto modified = fs::last_write_time(key, timeError);
+  const auto size = fs::file_size(key, sizeError);
+  if (timeError || sizeError) {
+    throw std::runtime_error(std::string("Cannot open file for read: ") + pathToFile);
+  }
+
+  std::promise<std::shared_ptr<const LoadedMesh>> promise;
+  Entry entry;
+  bool isLoader = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key);
+
+    /* a failed load or a loaded mesh of a changed file is dropped (a load in progress is waited for) */
+    if (it != entries_.end()) {
+      const Entry& cached = it->second.first;
+      const bool isReady = (cached.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+      if (isFailed(cached) ||
+          (isReady && (cached.get()->modified != modified || cached.get()->size != size))) {
+        order_.erase(it->second.second);
+        entries_.erase(it);
+      } else {
+        hits_++;
+        touch(key);
+        entry = cached;
+      }
+    }
+
+    if (!entry.valid()) {
+      misses_++;
+      isLoader = true;
+      entry = promise.get_future().share();
+      order_.push_front(key);
+      entries_[key] = {entry, order_.begin()};
+
+      /* the waiters of a dropped entry keep it alive */
+      while (entries_.size() > capacity_) {
+        entries_.erase(order_.back());
+        order_.pop_back();
+      }
+    }
+  }
+
+  if (isLoader) {
+    try {
+      promise.set_value(load(key));
+    } catch (...) {
+      promise.set_exception(std::current_exception());
+    }
+  }
+
+  return entry.get();
+}
+
+DaemonStatistics LoadedMeshCache::statistics() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return {hits_, misses_, entries_.size()};
+}
+
+ConversionDaemon::ConversionDaemon(const DaemonOptions& options)
+    : options_(options), meshes_(options.maxNumOfMeshes) {
+  sockaddr_un address = socketAddress(options_.socketPath);
+  removeStaleSocket(options_.socketPath, address);
+
+  listener_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (listener_ < 0) {
+    throw std::runtime_error(std::string("Cannot create socket: ") + std::strerror(errno));
+  }
+
+  if (::bind(listener_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 ||
+      ::listen(listener_, SOMAXCONN) < 0) {
+    std::string message = std::strerror(errno);
+    ::close(listener_);
+    throw std::runtime_error("Cannot listen on socket " + options_.socketPath + ": " + message);
+  }
+}
+
+ConversionDaemon::~ConversionDaemon() {
+  stop();
+
+  {
+    std::unique_lock<std::mutex> lock(connectionsMutex_);
+    connectionClosed_.wait(lock, [this]() { return connections_.empty(); });
+  }
+
+  ::close(listener_);
+  ::unlink(options_.socketPath.c_str());
+}
+
+void ConversionDaemon::run() {
+  while (!stopped_) {
+    int connection = ::accept(listener_, nullptr, nullptr);
+    if (connection < 0) {
+      if (stopped_) {
+        break;
+      }
+      /* the connection failed before it was accepted, or a signal interrupted the call */
+      if (errno == EINTR || errno == ECONNABORTED || errno == EPROTO) {
+        continue;
+      }
+      /* out of descriptors or memory until some connections are closed */
+      if (errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM) {
+        std::this_thread::sleep_for(ACCEPT_BACKOFF);
+        continue;
+      }
+      throw std::runtime_error("Cannot accept on socket " + options_.socketPath + ": " + std::strerror(errno));
+    }
+
+    std::lock_guard<std::mutex> lock(connectionsMutex_);
+    if (stopped_) {
+      ::close(connection);
+      break;
+    }
+    connections_.insert(connection);
+    std::thread(&ConversionDaemon::serve, this, connection).detach();
+  }
+}
+
+void ConversionDaemon::stop() {
+  stopped_ = true;
+
+  /* wake up the blocked accept() and the blocked reads, the pending responses are still sent */
+  ::shutdown(listener_, SHUT_RDWR);
+  std::lock_guard<std::mutex> lock(connectionsMutex_);
+  for (int connection : connections_) {
+    ::shutdown(connection, SHUT_RD);
+  }
+}
+
+void ConversionDaemon::serve(int connection) {
+  std::string buffer;
+  std::string line;
+  try {
+    while (receiveLine(connection, buffer, line)) {
+      sendAll(connection, process(line) + "\n");
+    }
+  } catch (const std::length_error& e) {
+    /* the connection is dropped instead of buffering without bound */
+    try {
+      sendAll(connection, std::string("error") + DAEMON_FIELD_SEPARATOR + e.what() + "\n");
+    } catch (const std::exception&) {
+      /* the client went away */
+    }
+  } catch (const std::exception&) {
+    /* the client went away */
+  }
+
+  /* closed under the lock, so stop() never shuts down a reused descriptor */
+  std::lock_guard<std::mutex> lock(connectionsMutex_);
+  connections_.erase(connection);
+  ::close(connection);
+  connectionClosed_.notify_all();
+}
+
+std::string ConversionDaemon::process(const std::string& line) {
+  std::ostringstream response;
+  response << "ok";
+
+  try {
+    DaemonRequest request = parseRequest(line);
+
+    if (request.command == "convert") {
+      auto mesh = meshes_.get(request.input);
+      if (request.output.empty()) {
+        throw std::invalid_argument("No path to the output file");
+      }
+
+      /* the output format is named by the request or chosen by the extension of the output path */
+      const WriterFormat* format = request.format.empty() ? FormatRegistry::instance().writerForPath(request.output) :
+                                                            FormatRegistry::instance().writer(request.format);
+      if (!format) {
+        throw std::invalid_argument("Unknown output format: " + (request.format.empty() ? request.output : request.format));
+      }
+
+      /* the loaded mesh is written as it is, only transformed meshes are copied */
+      if (request.transforms.empty()) {
+        format->create()->write(request.output, mesh->converter->mesh());
+        response << DAEMON_FIELD_SEPARATOR << mesh->converter->mesh().triangles.size();
+      } else {
+        auto session = transformedCopy(*mesh, request.transforms);
+        format->create()->write(request.output, session->mesh());
+        response << DAEMON_FIELD_SEPARATOR << session->mesh().triangles.size();
+      }
+    } else if (request.command == "volume" || request.command == "surface") {
+      auto mesh = meshes_.get(request.input);
+      const bool isVolume = (request.command == "volume");
+
+      double value = 0.0;
+      if (request.transforms.empty()) {
+        value = isVolume ? mesh->converter->volume() : mesh->converter->surface();
+      } else {
+        auto session = transformedCopy(*mesh, request.transforms);
+        value = isVolume ? session->volume() : session->surface();
+      }
+      response << DAEMON_FIELD_SEPARATOR << formatNumber(value);
+    } else if (request.command == "inside") {
+      auto mesh = meshes_.get(request.input);
+
+      std::vector<bool> inside;
+      if (request.transforms.empty()) {
+        inside = mesh->converter->isPointInside(request.points);
+      } else {
+        inside = transformedCopy(*mesh, request.transforms)->isPointInside(request.points);
+      }
+      for (bool isInside : inside) {
+        response << DAEMON_FIELD_SEPARATOR << (isInside ? '1' : '0');
+      }
+    } else if (request.command == "stats") {
+      DaemonStatistics statistics = meshes_.statistics();
+      response << DAEMON_FIELD_SEPARATOR << statistics.hits << DAEMON_FIELD_SEPARATOR << statistics.misses
+               << DAEMON_FIELD_SEPARATOR << statistics.numOfMeshes;
+    } else if (request.command == "shutdown") {
+      stop();
+    } else {
+      throw std::invalid_argument("Unknown request: " + request.command);
+    }
+  } catch (const std::exception& e) {
+    /* the message must stay a single field */
+    std::string message = e.what();
+    std::replace(message.begin(), message.end(), '\n', ' ');
+    std::replace(message.begin(), message.end(), DAEMON_FIELD_SEPARATOR, ' ');
+    return std::string("error") + DAEMON_FIELD_SEPARATOR + message;
+  }
+
+  return response.str();
+}
+
+DaemonClient::DaemonClient(const std::string& socketPath) {
+  sockaddr_un address = socketAddress(socketPath);
+
+  socket_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (socket_ < 0) {
+    throw std::runtime_error(std::string("Cannot create socket: ") + std::strerror(errno));
+  }
+
+  if (::connect(socket_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+    std::string message = std::strerror(errno);
+    ::close(socket_);
+    throw std::runtime_error("Cannot connect to daemon at " + socketPath + ": " + message);
+  }
+}
+
+DaemonClient::~DaemonClient() {
+  ::close(socket_);
+}
+
+std::vector<std::string> DaemonClient::request(const std::string& line) {
+  sendAll(socket_, line + "\n");
+
+  std::string response;
+  if (!receiveLine(socket_, buffer_, response)) {
+    throw std::runtime_error("Connection to the daemon closed");
+  }
+
+  auto fields = utils::split(response, DAEMON_FIELD_SEPARATOR);
+  if (fields.empty() || (fields[0] != "ok" && fields[0] != "error")) {
+    throw std::runtime_error("Invalid response of the daemon: " + response);
+  }
+  if (fields[0] == "error") {
+    throw std::runtime_error((fields.size() > 1u) ? fields[1] : std::string("Request failed"));
+  }
+
+  fields.erase(fields.begin());
+  return fields;
+}
+
+size_t DaemonClient::convert(const std::string& inputPath, const std::string& outputPath,
+                             const std::vector<Transform>& transforms, const std::string& format) {
+  auto fields = request("convert" + (DAEMON_FIELD_SEPARATOR + ("input=" + inputPath)) +
+                        (DAEMON_FIELD_SEPARATOR + ("output=" + outputPath)) +
+                        (format.empty() ? std::string() : (DAEMON_FIELD_SEPARATOR + ("format=" + format))) +
+                        formatTransforms(transforms));
+
+  return fields.empty() ? 0u : std::stoull(fields[0]);
+}
+
+double DaemonClient::volume(const std::string& inputPath, const std::vector<Transform>& transforms) {
+  auto fields = request("volume" + (DAEMON_FIELD_SEPARATOR + ("input=" + inputPath)) + formatTransforms(transforms));
+
+  return fields.empty() ? 0.0 : std::stod(fields[0]);
+}
+
+double DaemonClient::surface(const std::string& inputPath, const std::vector<Transform>& transforms) {
+  auto fields = request("surface" + (DAEMON_FIELD_SEPARATOR + ("input=" + inputPath)) + formatTransforms(transforms));
+
+  return fields.empty() ? 0.0 : std::stod(fields[0]);
+}
+
+std::vector<bool> DaemonClient::isPointInside(const std::string& inputPath, const std::vector<glm::dvec3>& points,
+                                              const std::vector<Transform>& transforms) {
+  std::string line = "inside" + (DAEMON_FIELD_SEPARATOR + ("input=" + inputPath)) + formatTransforms(transforms);
+  for (const auto& p : points) {
+    line += DAEMON_FIELD_SEPARATOR + ("point=" + formatVector(p));
+  }
+
+  auto fields = request(line);
+  std::vector<bool> inside;
+  for (const auto& f : fields) {
+    inside.emplace_back(f == "1");
+  }
+
+  return inside;
+}
+
+DaemonStatistics DaemonClient::statistics() {
+  auto fields = request("stats");
+  if (fields.size() != 3u) {
+    throw std::runtime_error("Invalid statistics of the daemon");
+  }
+
+  return {std::stoull(fields[0]), std::stoull(fields[1]), static_cast<size_t>(std::stoull(fields[2]))};
+}
+
+void DaemonClient::shutdown() {
+  request("shutdown");
+}
+
+} // namespace conv
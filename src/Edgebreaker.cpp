@@ -0,0 +1,467 @@
+#include "Edgebreaker.h"
+#include "Entropy.h"
+
+#include <limits>
+#include <stdexcept>
+
+
+namespace conv {
+
+/* symbols of the connectivity stream */
+enum EdgebreakerSymbol : uint8_t {
+  EDGEBREAKER_SYMBOL_C = 0u,
+  EDGEBREAKER_SYMBOL_L,
+  EDGEBREAKER_SYMBOL_R,
+  EDGEBREAKER_SYMBOL_E,
+  EDGEBREAKER_SYMBOL_S,
+  EDGEBREAKER_SYMBOL_J,
+  EDGEBREAKER_SYMBOL_B,
+  EDGEBREAKER_SYMBOL_N,
+  EDGEBREAKER_SYMBOL_D
+};
+
+/* number of border vertices searched for the third vertex of a triangle before it is given by its index */
+constexpr size_t MAX_SPLIT_OFFSET = 1024u;
+
+constexpr uint32_t NO_VERTEX = std::numeric_limits<uint32_t>::max();
+
+namespace {
+
+/*
+ * border of the conquered region of a component, a cyclic list of vertices with the edges between them
+ * the edges are counterclockwise, the region on their left, so the triangle across the gate (u, v) has the
+ * edge (v, u); the encoder and the decoder make the same changes, so they agree on the border
+ * (a vertex may be on the border more than once)
+ */
+class CutBorder {
+public:
+  /* function to start a component with its first triangle */
+  void start(uint32_t a, uint32_t b, uint32_t c) {
+    nodes_.clear();
+    nodes_.push_back(Node{a, 1u, 2u, true});
+    nodes_.push_back(Node{b, 2u, 0u, true});
+    nodes_.push_back(Node{c, 0u, 1u, true});
+    numOfActiveEdges_ = 3u;
+    gate_ = 0u;
+  }
+
+  bool isDone() const {
+    return 0u == numOfActiveEdges_;
+  }
+
+  /* vertices of the gate (u, v) */
+  uint32_t gateFrom() const {
+    return nodes_[gate_].vertex;
+  }
+
+  uint32_t gateTo() const {
+    return nodes_[nodes_[gate_].next].vertex;
+  }
+
+  /* vertex before the gate (if its edge to the gate is open) */
+  uint32_t leftVertex() const {
+    const Node& left = nodes_[nodes_[gate_].previous];
+    return left.isActive ? left.vertex : NO_VERTEX;
+  }
+
+  /* vertex after the gate (if its edge from the gate is open) */
+  uint32_t rightVertex() const {
+    const Node& to = nodes_[nodes_[gate_].next];
+    return to.isActive ? nodes_[to.next].vertex : NO_VERTEX;
+  }
+
+  /* function to find the vertex along the border after the gate, returns its offset or 0 */
+  size_t find(uint32_t vertex) const {
+    uint32_t node = nodes_[gate_].next;
+    for (size_t offset = 1u; offset <= MAX_SPLIT_OFFSET; ++offset) {
+      node = nodes_[node].next;
+      if (node == gate_) {
+        break;
+      }
+      if (nodes_[node].vertex == vertex) {
+        return offset;
+      }
+    }
+    return 0u;
+  }
+
+  /* function to get the vertex at the offset of find */
+  uint32_t vertexAt(size_t offset) const {
+    if (0u == offset || offset > MAX_SPLIT_OFFSET) {
+      throw std::runtime_error("Invalid border offset in connectivity stream");
+    }
+
+    uint32_t node = nodes_[gate_].next;
+    for (size_t i = 0u; i < offset; ++i) {
+      node = nodes_[node].next;
+      if (node == gate_) {
+        throw std::runtime_error("Invalid border offset in connectivity stream");
+      }
+    }
+    return nodes_[node].vertex;
+  }
+
+  /* C, S, J: the vertex is inserted into the gate, the gate moves to its right edge */
+  void insert(uint32_t vertex) {
+    const uint32_t from = gate_;
+    const uint32_t to = nodes_[from].next;
+    const uint32_t node = static_cast<uint32_t>(nodes_.size());
+    nodes_.push_back(Node{vertex, to, from, true});
+    nodes_[from].next = node;
+    nodes_[to].previous = node;
+    ++numOfActiveEdges_;
+    gate_ = node;
+  }
+
+  /* L: the edge before the gate is conquered, the gate moves to the new edge */
+  void left() {
+    const uint32_t left = nodes_[gate_].previous;
+    unlink(gate_);
+    --numOfActiveEdges_;
+    gate_ = left;
+  }
+
+  /* R: the edge after the gate is conquered, the gate moves to the new edge */
+  void right() {
+    unlink(nodes_[gate_].next);
+    --numOfActiveEdges_;
+  }
+
+  /* E: both edges next to the gate are conquered, their outer vertices (the same vertex) are merged */
+  void end() {
+    const uint32_t left = nodes_[gate_].previous;
+    const uint32_t right = nodes_[nodes_[gate_].next].next;
+    numOfActiveEdges_ -= 3u;
+    if (left == right) {
+      return;
+    }
+
+    unlink(nodes_[gate_].next);
+    unlink(gate_);
+    nodes_[left].isActive = nodes_[right].isActive;
+    unlink(right);
+    gate_ = left;
+    compact(left);
+    advance();
+  }
+
+  /* B: nothing across the gate, the edge is closed */
+  void close() {
+    const uint32_t to = nodes_[gate_].next;
+    nodes_[gate_].isActive = false;
+    --numOfActiveEdges_;
+    gate_ = to;
+    compact(nodes_[to].previous);
+    compact(to);
+    advance();
+  }
+
+private:
+  struct Node {
+    uint32_t vertex;
+    uint32_t next;
+    uint32_t previous;
+
+    /* whether the edge to the next node is open */
+    bool isActive;
+  };
+
+  void unlink(uint32_t node) {
+    nodes_[nodes_[node].previous].next = nodes_[node].next;
+    nodes_[nodes_[node].next].previous = nodes_[node].previous;
+  }
+
+  /* function to drop a node between two closed edges, so closed edges never follow each other */
+  void compact(uint32_t node) {
+    const uint32_t previous = nodes_[node].previous;
+    if (!nodes_[node].isActive && !nodes_[previous].isActive && previous != node) {
+      unlink(node);
+      if (gate_ == node) {
+        gate_ = nodes_[node].next;
+      }
+    }
+  }
+
+  /* function to move the gate to the next open edge */
+  void advance() {
+    while (!isDone() && !nodes_[gate_].isActive) {
+      gate_ = nodes_[gate_].next;
+    }
+  }
+
+
+  std::vector<Node> nodes_;
+  size_t numOfActiveEdges_ = 0u;
+  uint32_t gate_ = 0u;
+};
+
+/* directed edges of the triangles grouped by their first vertex */
+struct EdgeTable {
+  struct Edge {
+    uint32_t to;
+    uint32_t third;
+    uint32_t triangle;
+  };
+
+  EdgeTable(const std::vector<std::array<uint32_t, 3>>& triangles, size_t numOfVertices) : first(numOfVertices + 1u, 0u) {
+    for (const auto& t : triangles) {
+      for (uint32_t k = 0u; k < 3u; ++k) {
+        ++first[t[k] + 1u];
+      }
+    }
+    for (size_t v = 0u; v < numOfVertices; ++v) {
+      first[v + 1u] += first[v];
+    }
+
+    std::vector<size_t> position(first.begin(), first.end() - 1);
+    edges.resize(first.back());
+    for (size_t i = 0u; i < triangles.size(); ++i) {
+      const auto& t = triangles[i];
+      for (uint32_t k = 0u; k < 3u; ++k) {
+        edges[position[t[k]]++] = Edge{t[(k + 1u) % 3u], t[(k + 2u) % 3u], static_cast<uint32_t>(i)};
+      }
+    }
+  }
+
+  std::vector<size_t> first;
+  std::vector<Edge> edges;
+};
+
+/* function to check whether the triangle has a repeated vertex */
+bool isDegenerate(const std::array<uint32_t, 3>& t) {
+  return t[0] == t[1] || t[1] == t[2] || t[2] == t[0];
+}
+
+} // namespace
+
+EncodedConnectivity encodeConnectivity(const std::vector<std::array<uint32_t, 3>>& triangles, size_t numOfVertices) {
+  for (const auto& t : triangles) {
+    if (t[0] >= numOfVertices || t[1] >= numOfVertices || t[2] >= numOfVertices) {
+      throw std::invalid_argument("Invalid vertex index of triangle");
+    }
+  }
+
+  EncodedConnectivity result;
+  result.symbols.reserve(triangles.size() + triangles.size() / 8u);
+  result.vertexOrder.reserve(numOfVertices);
+
+  const EdgeTable table(triangles, numOfVertices);
+  std::vector<bool> isConquered(triangles.size(), false);
+  std::vector<uint32_t> newIndexOf(numOfVertices, NO_VERTEX);
+
+  /* function to write a vertex given by its index (0 for a new vertex) */
+  auto appendVertex = [&](uint32_t vertex) {
+    if (newIndexOf[vertex] == NO_VERTEX) {
+      appendVarint(result.indices, 0u);
+      newIndexOf[vertex] = static_cast<uint32_t>(result.vertexOrder.size());
+      result.vertexOrder.emplace_back(vertex);
+    } else {
+      appendVarint(result.indices, newIndexOf[vertex] + 1u);
+    }
+  };
+
+  /* function to find a triangle with the edge (from, to) that is not conquered yet */
+  auto findTriangle = [&](uint32_t from, uint32_t to) -> const EdgeTable::Edge* {
+    for (size_t e = table.first[from]; e < table.first[from + 1u]; ++e) {
+      const EdgeTable::Edge& edge = table.edges[e];
+      if (edge.to == to && !isConquered[edge.triangle]) {
+        return &edge;
+      }
+    }
+    return nullptr;
+  };
+
+  CutBorder border;
+  for (size_t t = 0u; t < triangles.size(); ++t) {
+    if (isConquered[t]) {
+      continue;
+    }
+    isConquered[t] = true;
+
+    const auto& triangle = triangles[t];
+    if (isDegenerate(triangle)) {
+      result.symbols.push_back(EDGEBREAKER_SYMBOL_D);
+      for (uint32_t vertex : triangle) {
+        appendVertex(vertex);
+      }
+      continue;
+    }
+
+    result.symbols.push_back(EDGEBREAKER_SYMBOL_N);
+    for (uint32_t vertex : triangle) {
+      appendVertex(vertex);
+    }
+
+    border.start(triangle[0], triangle[1], triangle[2]);
+    while (!border.isDone()) {
+      const uint32_t u = border.gateFrom();
+      const uint32_t v = border.gateTo();
+      const EdgeTable::Edge* across = findTriangle(v, u);
+      if (!across || isDegenerate(triangles[across->triangle])) {
+        result.symbols.push_back(EDGEBREAKER_SYMBOL_B);
+        border.close();
+        continue;
+      }
+
+      isConquered[across->triangle] = true;
+      const uint32_t x = across->third;
+      const bool isLeft = (border.leftVertex() == x);
+      const bool isRight = (border.rightVertex() == x);
+      if (isLeft && isRight) {
+        result.symbols.push_back(EDGEBREAKER_SYMBOL_E);
+        border.end();
+      } else if (isLeft) {
+        result.symbols.push_back(EDGEBREAKER_SYMBOL_L);
+        border.left();
+      } else if (isRight) {
+        result.symbols.push_back(EDGEBREAKER_SYMBOL_R);
+        border.right();
+      } else if (newIndexOf[x] == NO_VERTEX) {
+        result.symbols.push_back(EDGEBREAKER_SYMBOL_C);
+        newIndexOf[x] = static_cast<uint32_t>(result.vertexOrder.size());
+        result.vertexOrder.emplace_back(x);
+        border.insert(x);
+      } else if (const size_t offset = border.find(x)) {
+        result.symbols.push_back(EDGEBREAKER_SYMBOL_S);
+        appendVarint(result.indices, offset);
+        border.insert(x);
+      } else {
+        result.symbols.push_back(EDGEBREAKER_SYMBOL_J);
+        appendVarint(result.indices, newIndexOf[x]);
+        border.insert(x);
+      }
+    }
+  }
+
+  /* vertices of no triangle keep their order at the end */
+  for (uint32_t vertex = 0u; vertex < numOfVertices; ++vertex) {
+    if (newIndexOf[vertex] == NO_VERTEX) {
+      newIndexOf[vertex] = static_cast<uint32_t>(result.vertexOrder.size());
+      result.vertexOrder.emplace_back(vertex);
+    }
+  }
+  return result;
+}
+
+std::vector<std::array<uint32_t, 3>> decodeConnectivity(const uint8_t* symbols, size_t numOfSymbols, const uint8_t* indices,
+                                                        size_t sizeOfIndices, size_t numOfTriangles, size_t numOfVertices) {
+  std::vector<std::array<uint32_t, 3>> triangles;
+  triangles.reserve(numOfTriangles);
+
+  const uint8_t* index = indices;
+  const uint8_t* indicesEnd = indices + sizeOfIndices;
+  uint32_t numOfDecodedVertices = 0u;
+
+  /* function to get a new vertex, checking the number of vertices */
+  auto newVertex = [&]() {
+    if (numOfDecodedVertices >= numOfVertices) {
+      throw std::runtime_error("Too many vertices in connectivity stream");
+    }
+    return numOfDecodedVertices++;
+  };
+
+  /* function to read a vertex given by its index (0 for a new vertex) */
+  auto readVertex = [&]() {
+    const uint64_t code = readVarint(index, indicesEnd);
+    if (0u == code) {
+      return newVertex();
+    }
+    if (code > numOfDecodedVertices) {
+      throw std::runtime_error("Invalid vertex index in connectivity stream");
+    }
+    return static_cast<uint32_t>(code - 1u);
+  };
+
+  /* function to add a triangle, checking the number of triangles */
+  auto addTriangle = [&](uint32_t a, uint32_t b, uint32_t c) {
+    if (triangles.size() >= numOfTriangles) {
+      throw std::runtime_error("Too many triangles in connectivity stream");
+    }
+    triangles.push_back({a, b, c});
+  };
+
+  CutBorder border;
+  size_t s = 0u;
+  while (s < numOfSymbols) {
+    const uint8_t symbol = symbols[s++];
+    if (symbol != EDGEBREAKER_SYMBOL_N && symbol != EDGEBREAKER_SYMBOL_D) {
+      throw std::runtime_error("Connectivity stream does not start a component");
+    }
+
+    const uint32_t a = readVertex();
+    const uint32_t b = readVertex();
+    const uint32_t c = readVertex();
+    addTriangle(a, b, c);
+    if (symbol == EDGEBREAKER_SYMBOL_D) {
+      continue;
+    }
+    if (isDegenerate({a, b, c})) {
+      throw std::runtime_error("Degenerate start of component in connectivity stream");
+    }
+
+    border.start(a, b, c);
+    while (!border.isDone()) {
+      if (s == numOfSymbols) {
+        throw std::runtime_error("Truncated connectivity stream");
+      }
+
+      const uint32_t u = border.gateFrom();
+      const uint32_t v = border.gateTo();
+      const uint8_t symbol = symbols[s++];
+      if (symbol == EDGEBREAKER_SYMBOL_B) {
+        border.close();
+        continue;
+      }
+
+      /* third vertex of the triangle across the gate */
+      uint32_t x = NO_VERTEX;
+      switch (symbol) {
+        case EDGEBREAKER_SYMBOL_C:
+          x = newVertex();
+          break;
+        case EDGEBREAKER_SYMBOL_L:
+          x = border.leftVertex();
+          break;
+        case EDGEBREAKER_SYMBOL_R:
+          x = border.rightVertex();
+          break;
+        case EDGEBREAKER_SYMBOL_E:
+          x = (border.leftVertex() == border.rightVertex()) ? border.leftVertex() : NO_VERTEX;
+          break;
+        case EDGEBREAKER_SYMBOL_S:
+          x = border.vertexAt(static_cast<size_t>(readVarint(index, indicesEnd)));
+          break;
+        case EDGEBREAKER_SYMBOL_J: {
+          const uint64_t vertex = readVarint(index, indicesEnd);
+          x = (vertex < numOfDecodedVertices) ? static_cast<uint32_t>(vertex) : NO_VERTEX;
+          break;
+        }
+        default:
+          throw std::runtime_error("Invalid symbol in connectivity stream");
+      }
+
+      /* the encoder writes no degenerate triangles across the gate, so the border stays valid */
+      if (x == NO_VERTEX || x == u || x == v) {
+        throw std::runtime_error("Invalid triangle in connectivity stream");
+      }
+      addTriangle(v, u, x);
+
+      if (symbol == EDGEBREAKER_SYMBOL_L) {
+        border.left();
+      } else if (symbol == EDGEBREAKER_SYMBOL_R) {
+        border.right();
+      } else if (symbol == EDGEBREAKER_SYMBOL_E) {
+        border.end();
+      } else {
+        border.insert(x);
+      }
+    }
+  }
+
+  if (triangles.size() != numOfTriangles || index != indicesEnd) {
+    throw std::runtime_error("Invalid size of connectivity stream");
+  }
+  return triangles;
+}
+
+} // namespace conv
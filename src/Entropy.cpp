@@ -0,0 +1,190 @@
+#include "Entropy.h"
+
+#include <algorithm>
+#include <array>
+
+
+namespace conv {
+
+/* the frequencies of the symbols sum up to 2^RANS_PROBABILITY_BITS */
+constexpr uint32_t RANS_PROBABILITY_BITS = 12u;
+constexpr uint32_t RANS_PROBABILITY_SCALE = 1u << RANS_PROBABILITY_BITS;
+
+/* lower bound of the normalized states, which are renormalized a byte at a time */
+constexpr uint32_t RANS_LOWER_BOUND = 1u << 23u;
+
+/*
+ * no symbol gets the whole probability range, so decoding a byte shrinks a normalized state by a factor of
+ * at least 1 - 1 / 4098, which takes more than 1 / 2841 of a bit of the states and the stream
+ */
+constexpr uint64_t RANS_MAX_BYTES_PER_BIT = 2841u;
+
+/* modes of an encoded stream */
+constexpr uint8_t ENTROPY_MODE_STORED = 0u;
+constexpr uint8_t ENTROPY_MODE_RANS = 1u;
+
+namespace {
+
+/* function to scale the counts of the symbols to frequencies summing up to RANS_PROBABILITY_SCALE */
+std::array<uint32_t, 256> normalize(const std::array<uint64_t, 256>& counts, uint64_t total) {
+  std::array<uint32_t, 256> frequencies{};
+  uint32_t sum = 0u;
+  for (size_t s = 0u; s < 256u; ++s) {
+    if (0u != counts[s]) {
+      frequencies[s] = std::max<uint32_t>(1u, static_cast<uint32_t>(counts[s] * RANS_PROBABILITY_SCALE / total));
+      sum += frequencies[s];
+    }
+  }
+
+  /* the rounding error goes to the most frequent symbols (every present symbol keeps at least 1) */
+  while (sum != RANS_PROBABILITY_SCALE) {
+    auto largest = std::max_element(frequencies.begin(), frequencies.end());
+    if (sum < RANS_PROBABILITY_SCALE) {
+      *largest += RANS_PROBABILITY_SCALE - sum;
+      sum = RANS_PROBABILITY_SCALE;
+    } else {
+      --*largest;
+      --sum;
+    }
+  }
+
+  /* a single present symbol leaves a slot to the next one, so its bytes are not free to decode */
+  auto largest = std::max_element(frequencies.begin(), frequencies.end());
+  if (*largest == RANS_PROBABILITY_SCALE) {
+    --*largest;
+    ++frequencies[(static_cast<size_t>(largest - frequencies.begin()) + 1u) % 256u];
+  }
+  return frequencies;
+}
+
+} // namespace
+
+std::vector<uint8_t> entropyEncode(const std::vector<uint8_t>& bytes) {
+  std::vector<uint8_t> result;
+  appendVarint(result, bytes.size());
+
+  std::array<uint64_t, 256> counts{};
+  for (uint8_t b : bytes) {
+    ++counts[b];
+  }
+
+  if (!bytes.empty()) {
+    const std::array<uint32_t, 256> frequencies = normalize(counts, bytes.size());
+    std::array<uint32_t, 256> starts{};
+    for (size_t s = 1u; s < 256u; ++s) {
+      starts[s] = starts[s - 1u] + frequencies[s - 1u];
+    }
+
+    /* rANS is last in first out, so the bytes are encoded backwards into the end of the buffer (two interleaved states) */
+    std::vector<uint8_t> stream(2u * bytes.size() + 16u);
+    uint8_t* position = stream.data() + stream.size();
+    uint32_t states[2] = {RANS_LOWER_BOUND, RANS_LOWER_BOUND};
+    for (size_t i = bytes.size(); i-- > 0u;) {
+      uint32_t& state = states[i & 1u];
+      const uint32_t frequency = frequencies[bytes[i]];
+      const uint32_t maxState = ((RANS_LOWER_BOUND >> RANS_PROBABILITY_BITS) << 8u) * frequency;
+      while (state >= maxState) {
+        *--position = static_cast<uint8_t>(state & 0xFFu);
+        state >>= 8u;
+      }
+      state = ((state / frequency) << RANS_PROBABILITY_BITS) + (state % frequency) + starts[bytes[i]];
+    }
+
+    /* the states are read first by the decoder (little endian) */
+    for (size_t k = 2u; k-- > 0u;) {
+      for (uint32_t b = 4u; b-- > 0u;) {
+        *--position = static_cast<uint8_t>(states[k] >> (8u * b));
+      }
+    }
+
+    const size_t streamSize = static_cast<size_t>(stream.data() + stream.size() - position);
+    std::vector<uint8_t> table;
+    for (uint32_t frequency : frequencies) {
+      appendVarint(table, frequency);
+    }
+
+    if (table.size() + streamSize < bytes.size()) {
+      result.push_back(ENTROPY_MODE_RANS);
+      result.insert(result.end(), table.begin(), table.end());
+      result.insert(result.end(), position, stream.data() + stream.size());
+      return result;
+    }
+  }
+
+  result.push_back(ENTROPY_MODE_STORED);
+  result.insert(result.end(), bytes.begin(), bytes.end());
+  return result;
+}
+
+uint64_t entropyMaxDecodedSize(uint64_t encodedSize) {
+  /* the stored bytes, or the bits of the states and the stream (8 bytes of states at least) */
+  return RANS_MAX_BYTES_PER_BIT * 8u * encodedSize;
+}
+
+std::vector<uint8_t> entropyDecode(const uint8_t* bytes, size_t size, size_t maxSize) {
+  const uint8_t* position = bytes;
+  const uint8_t* end = bytes + size;
+  const uint64_t rawSize = readVarint(position, end);
+  if (rawSize > maxSize || rawSize > entropyMaxDecodedSize(size) || position == end) {
+    throw std::runtime_error("Invalid size of entropy coded stream");
+  }
+
+  const uint8_t mode = *position++;
+  if (mode == ENTROPY_MODE_STORED) {
+    if (static_cast<size_t>(end - position) != rawSize) {
+      throw std::runtime_error("Invalid size of stored stream");
+    }
+    return std::vector<uint8_t>(position, end);
+  }
+  if (mode != ENTROPY_MODE_RANS) {
+    throw std::runtime_error("Unknown entropy coding mode");
+  }
+
+  /* frequencies, the start of every symbol and the symbol of every slot */
+  std::array<uint32_t, 256> frequencies{};
+  std::array<uint32_t, 256> starts{};
+  std::vector<uint8_t> symbols(RANS_PROBABILITY_SCALE);
+  uint32_t sum = 0u;
+  for (size_t s = 0u; s < 256u; ++s) {
+    const uint64_t frequency = readVarint(position, end);
+    if (frequency > RANS_PROBABILITY_SCALE - sum || frequency == RANS_PROBABILITY_SCALE) {
+      throw std::runtime_error("Invalid frequencies of entropy coded stream");
+    }
+
+    frequencies[s] = static_cast<uint32_t>(frequency);
+    starts[s] = sum;
+    std::fill(symbols.begin() + sum, symbols.begin() + sum + frequency, static_cast<uint8_t>(s));
+    sum += static_cast<uint32_t>(frequency);
+  }
+  if (sum != RANS_PROBABILITY_SCALE || end - position < 8) {
+    throw std::runtime_error("Invalid frequencies of entropy coded stream");
+  }
+
+  uint32_t states[2];
+  for (uint32_t& state : states) {
+    state = static_cast<uint32_t>(position[0]) | (static_cast<uint32_t>(position[1]) << 8u) |
+            (static_cast<uint32_t>(position[2]) << 16u) | (static_cast<uint32_t>(position[3]) << 24u);
+    position += 4u;
+    if (state < RANS_LOWER_BOUND) {
+      throw std::runtime_error("Invalid states of entropy coded stream");
+    }
+  }
+
+  std::vector<uint8_t> result(rawSize);
+  for (size_t i = 0u; i < result.size(); ++i) {
+    uint32_t& state = states[i & 1u];
+    const uint32_t slot = state & (RANS_PROBABILITY_SCALE - 1u);
+    const uint8_t symbol = symbols[slot];
+    state = frequencies[symbol] * (state >> RANS_PROBABILITY_BITS) + slot - starts[symbol];
+    while (state < RANS_LOWER_BOUND) {
+      if (position == end) {
+        throw std::runtime_error("Truncated entropy coded stream");
+      }
+      state = (state << 8u) | *position++;
+    }
+    result[i] = symbol;
+  }
+  return result;
+}
+
+} // namespace conv
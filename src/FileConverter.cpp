@@ -1,22 +1,189 @@
 #include "FileConverter.h"
-#include "Utils.h"
+#include "Parallel.h"
+#include "Predicates.h"
 
 namespace conv {
 
-constexpr double COORD_VALUE_MIN = std::numeric_limits<double>::min();
-constexpr double COORD_VALUE_MAX = std::numeric_limits<double>::max();
 constexpr double COORD_OFFSET_VALUE = 10.0;
 
+/* number of vertices transformed by one task */
+constexpr size_t TRANSFORM_BLOCK_SIZE = 16384u;
+
+/* number of points tested by one task of the batched inside test */
+constexpr size_t INSIDE_BLOCK_SIZE = 64u;
+
+/* number of triangles summed up by one task of the properties pass */
+constexpr size_t PROPERTIES_BLOCK_SIZE = 4096u;
+
+/* number of triangles processed side by side by the summation kernel */
+constexpr size_t KERNEL_WIDTH = 4u;
+
+/* tolerance of the orthonormality check of rigid transformations */
+constexpr double RIGID_TOLERANCE = 1e-12;
+
+/* integrals summed up over the triangles (the second moment is symmetric) */
+enum Integral : size_t {
+  INTEGRAL_VOLUME = 0u,
+  INTEGRAL_SURFACE,
+  INTEGRAL_FIRST_X,
+  INTEGRAL_FIRST_Y,
+  INTEGRAL_FIRST_Z,
+  INTEGRAL_SECOND_XX,
+  INTEGRAL_SECOND_YY,
+  INTEGRAL_SECOND_ZZ,
+  INTEGRAL_SECOND_XY,
+  INTEGRAL_SECOND_YZ,
+  INTEGRAL_SECOND_XZ,
+  NUM_OF_INTEGRALS
+};
+
+namespace {
+
+/* compensated (Neumaier) sums of the integrals and the bounding box of a range of triangles */
+struct IntegralSums {
+  std::array<double, NUM_OF_INTEGRALS> sums{};
+  std::array<double, NUM_OF_INTEGRALS> compensations{};
+  glm::dvec3 boundsMin{std::numeric_limits<double>::max()};
+  glm::dvec3 boundsMax{std::numeric_limits<double>::lowest()};
+
+  void add(size_t integral, double value) {
+    double sum = sums[integral] + value;
+    compensations[integral] += (std::fabs(sums[integral]) >= std::fabs(value)) ? ((sums[integral] - sum) + value)
+                                                                               : ((value - sum) + sums[integral]);
+    sums[integral] = sum;
+  }
 
-void FileConverter::transform() {
-  /* nothing to do if there were no transformations */
-  if (data_.transformOperations.empty()) {
-    return;
+  void merge(const IntegralSums& other) {
+    for (size_t i = 0u; i < NUM_OF_INTEGRALS; ++i) {
+      add(i, other.sums[i]);
+      compensations[i] += other.compensations[i];
+    }
+    boundsMin = glm::min(boundsMin, other.boundsMin);
+    boundsMax = glm::max(boundsMax, other.boundsMax);
   }
 
+  double value(size_t integral) const {
+    return sums[integral] + compensations[integral];
+  }
+};
+
+/*
+ * summation kernel over the triangles [begin, end), vertices taken relative to the reference point
+ * every triangle (a, b, c) spans a tetrahedron with the reference point, whose signed volume is det(a, b, c) / 6
+ * the integrals over the solid are the sums of the integrals over these tetrahedra:
+ * - volume:                  det / 6
+ * - first moment (x dV):     det * (a + b + c) / 24
+ * - second moment (xx^T dV): det * (aa^T + bb^T + cc^T + (a + b + c)(a + b + c)^T) / 120
+ * - surface:                 |cross(b - a, c - a)| / 2
+ * KERNEL_WIDTH triangles are loaded into structure of arrays lanes, so the arithmetic vectorizes,
+ * every lane is summed up separately and the lanes are merged pairwise at the end
+ */
+IntegralSums sumIntegrals(const std::vector<Triangle>& triangles, const glm::dvec3& reference, size_t begin, size_t end) {
+  std::array<IntegralSums, KERNEL_WIDTH> lanes;
+
+  for (size_t first = begin; first < end; first += KERNEL_WIDTH) {
+    const size_t width = std::min(KERNEL_WIDTH, end - first);
+
+    /* unused lanes of the last group stay zero and contribute nothing */
+    double ax[KERNEL_WIDTH] = {};
+    double ay[KERNEL_WIDTH] = {};
+    double az[KERNEL_WIDTH] = {};
+    double bx[KERNEL_WIDTH] = {};
+    double by[KERNEL_WIDTH] = {};
+    double bz[KERNEL_WIDTH] = {};
+    double cx[KERNEL_WIDTH] = {};
+    double cy[KERNEL_WIDTH] = {};
+    double cz[KERNEL_WIDTH] = {};
+    for (size_t l = 0u; l < width; ++l) {
+      const auto& v = triangles[first + l].vertices;
+      ax[l] = v[0].x - reference.x;
+      ay[l] = v[0].y - reference.y;
+      az[l] = v[0].z - reference.z;
+      bx[l] = v[1].x - reference.x;
+      by[l] = v[1].y - reference.y;
+      bz[l] = v[1].z - reference.z;
+      cx[l] = v[2].x - reference.x;
+      cy[l] = v[2].y - reference.y;
+      cz[l] = v[2].z - reference.z;
+    }
+
+    double terms[NUM_OF_INTEGRALS][KERNEL_WIDTH];
+    for (size_t l = 0u; l < KERNEL_WIDTH; ++l) {
+      /* n = cross(b - a, c - a) */
+      double ux = bx[l] - ax[l];
+      double uy = by[l] - ay[l];
+      double uz = bz[l] - az[l];
+      double wx = cx[l] - ax[l];
+      double wy = cy[l] - ay[l];
+      double wz = cz[l] - az[l];
+      double nx = uy * wz - uz * wy;
+      double ny = uz * wx - ux * wz;
+      double nz = ux * wy - uy * wx;
+
+      double det = ax[l] * (by[l] * cz[l] - bz[l] * cy[l]) +
+                   ay[l] * (bz[l] * cx[l] - bx[l] * cz[l]) +
+                   az[l] * (bx[l] * cy[l] - by[l] * cx[l]);
+      double sx = ax[l] + bx[l] + cx[l];
+      double sy = ay[l] + by[l] + cy[l];
+      double sz = az[l] + bz[l] + cz[l];
+
+      terms[INTEGRAL_VOLUME][l] = det / 6.0;
+      terms[INTEGRAL_SURFACE][l] = 0.5 * std::sqrt(nx * nx + ny * ny + nz * nz);
+      terms[INTEGRAL_FIRST_X][l] = det * sx / 24.0;
+      terms[INTEGRAL_FIRST_Y][l] = det * sy / 24.0;
+      terms[INTEGRAL_FIRST_Z][l] = det * sz / 24.0;
+      terms[INTEGRAL_SECOND_XX][l] = det * (ax[l] * ax[l] + bx[l] * bx[l] + cx[l] * cx[l] + sx * sx) / 120.0;
+      terms[INTEGRAL_SECOND_YY][l] = det * (ay[l] * ay[l] + by[l] * by[l] + cy[l] * cy[l] + sy * sy) / 120.0;
+      terms[INTEGRAL_SECOND_ZZ][l] = det * (az[l] * az[l] + bz[l] * bz[l] + cz[l] * cz[l] + sz * sz) / 120.0;
+      terms[INTEGRAL_SECOND_XY][l] = det * (ax[l] * ay[l] + bx[l] * by[l] + cx[l] * cy[l] + sx * sy) / 120.0;
+      terms[INTEGRAL_SECOND_YZ][l] = det * (ay[l] * az[l] + by[l] * bz[l] + cy[l] * cz[l] + sy * sz) / 120.0;
+      terms[INTEGRAL_SECOND_XZ][l] = det * (ax[l] * az[l] + bx[l] * bz[l] + cx[l] * cz[l] + sx * sz) / 120.0;
+    }
+
+    for (size_t l = 0u; l < width; ++l) {
+      for (size_t i = 0u; i < NUM_OF_INTEGRALS; ++i) {
+        lanes[l].add(i, terms[i][l]);
+      }
+
+      const auto& v = triangles[first + l].vertices;
+      lanes[l].boundsMin = glm::min(lanes[l].boundsMin, glm::min(v[0], glm::min(v[1], v[2])));
+      lanes[l].boundsMax = glm::max(lanes[l].boundsMax, glm::max(v[0], glm::max(v[1], v[2])));
+    }
+  }
+
+  for (size_t stride = 1u; stride < KERNEL_WIDTH; stride *= 2u) {
+    for (size_t l = 0u; l + stride < KERNEL_WIDTH; l += 2u * stride) {
+      lanes[l].merge(lanes[l + stride]);
+    }
+  }
+
+  return lanes[0];
+}
+
+} // namespace
+
+/* directions of the probe segments of the inside test, tried in order until one avoids edges and vertices */
+const std::array<glm::dvec3, 8> PROBE_DIRECTIONS = {
+  glm::dvec3(1.0, 1.0, 1.0),
+  glm::dvec3(1.0, 1.1317, 1.3791),
+  glm::dvec3(1.4142, 1.0, 1.1731),
+  glm::dvec3(1.2361, 1.5709, 1.0),
+  glm::dvec3(1.0, 1.7321, 1.2599),
+  glm::dvec3(1.6180, 1.0, 1.4427),
+  glm::dvec3(1.3027, 1.2221, 1.0),
+  glm::dvec3(1.0, 1.2795, 1.6931)
+};
+
+
+glm::dmat4 FileConverter::transform() {
   /* construct identity matrix */
   glm::dmat4 transformMatrix(1.0);
 
+  /* nothing to do if there were no transformations */
+  if (data_.transformOperations.empty()) {
+    return transformMatrix;
+  }
+
   /*
    * summarize the operations
    * multiply the matrices first and then the vertices is faster,
@@ -33,177 +200,435 @@ void FileConverter::transform() {
    * therefore, to map back into the real plane we must perform perspective divide by
    * dividing each component by 'w'
    */
-  for (auto& v : data_.geometricVertices) {
-    glm::dvec4 helper(v.x, v.y, v.z, 1.0);
-    glm::dvec4 result = helper * transformMatrix;
-    v.x = (result.x / result.w);
-    v.y = (result.y / result.w);
-    v.z = (result.z / result.w);
-  }
+  auto& vertices = data_.geometricVertices;
+  parallelFor(vertices.size(), TRANSFORM_BLOCK_SIZE, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      glm::dvec4& v = vertices[i];
+      glm::dvec4 helper(v.x, v.y, v.z, 1.0);
+      glm::dvec4 result = helper * transformMatrix;
+      v.x = (result.x / result.w);
+      v.y = (result.y / result.w);
+      v.z = (result.z / result.w);
+    }
+  });
 
   /*
    * transform vertex normals
    * multiply vertex normals by the transpose of the inverse of the transformation matrix:
    * N' = N ∗ M−1T
    */
-  transformMatrix = glm::transpose(glm::inverse(transformMatrix));
-  for (auto& n : data_.vertexNormals) {
-    glm::dvec4 helper(n.x, n.y, n.z, 1.0);
-    glm::dvec4 result = helper * transformMatrix;
-    n.x = (result.x / result.w);
-    n.y = (result.y / result.w);
-    n.z = (result.z / result.w);
-  }
+  glm::dmat4 normalMatrix = glm::transpose(glm::inverse(transformMatrix));
+  auto& normals = data_.vertexNormals;
+  parallelFor(normals.size(), TRANSFORM_BLOCK_SIZE, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      glm::dvec3& n = normals[i];
+      glm::dvec4 helper(n.x, n.y, n.z, 1.0);
+      glm::dvec4 result = helper * normalMatrix;
+      n.x = (result.x / result.w);
+      n.y = (result.y / result.w);
+      n.z = (result.z / result.w);
+    }
+  });
+
+  /* the operations are applied, the next transformation must not repeat them */
+  data_.transformOperations.clear();
+
+  return transformMatrix;
 }
 
-void FileConverter::calculateBoundaryPoints() {
-  glm::dvec3 minCoords(COORD_VALUE_MAX, COORD_VALUE_MAX, COORD_VALUE_MAX);
-  glm::dvec3 maxCoords(COORD_VALUE_MIN, COORD_VALUE_MIN, COORD_VALUE_MIN);
+void FileConverter::setMesh(MeshData data) {
+  data_ = std::move(data);
+}
 
-  /* set minimum and maximum coordinates based on the vertices */
-  for (const auto& v : data_.geometricVertices) {
-    minCoords.x = (minCoords.x > v.x) ? v.x : minCoords.x;
-    minCoords.y = (minCoords.y > v.y) ? v.y : minCoords.y;
-    minCoords.z = (minCoords.z > v.z) ? v.z : minCoords.z;
+void FileConverter::buildQueryStructures() const {
+  bvh();
+  properties();
+}
 
-    maxCoords.x = (maxCoords.x < v.x) ? v.x : maxCoords.x;
-    maxCoords.y = (maxCoords.y < v.y) ? v.y : maxCoords.y;
-    maxCoords.z = (maxCoords.z < v.z) ? v.z : maxCoords.z;
+const Bvh& FileConverter::bvh() const {
+  /* build the hierarchy on first use, it is dropped whenever the triangles change */
+  if (!data_.cache.bvh) {
+    data_.cache.bvh = std::make_shared<const Bvh>(data_.triangles);
   }
 
-  data_.polygonBoundaries.emplace_back(minCoords);
-  data_.polygonBoundaries.emplace_back(maxCoords);
+  return *data_.cache.bvh;
 }
 
-bool FileConverter::isPointOutsideOfBoundaries(const glm::dvec3& point) {
-  /* calculate boundary points of the polygon */
-  calculateBoundaryPoints();  
-
-  /* point is outside if one of its coordinates is outside or equal to the min or max coordinates */
-  if (point.x <= data_.polygonBoundaries[0].x || point.x >= data_.polygonBoundaries[1].x ||
-      point.y <= data_.polygonBoundaries[0].y || point.y >= data_.polygonBoundaries[1].y ||
-      point.z <= data_.polygonBoundaries[0].z || point.z >= data_.polygonBoundaries[1].z) {
-    return true;
+const VertexOctree& FileConverter::vertexOctree() const {
+  /* build the tree on first use, it is dropped whenever the mesh changes */
+  if (!data_.cache.vertexOctree) {
+    data_.cache.vertexOctree = std::make_shared<const VertexOctree>(data_.geometricVertices);
   }
 
-  return false;
+  return *data_.cache.vertexOctree;
 }
 
-double FileConverter::calculateSignedVolume(const glm::dvec3& pointA, const glm::dvec3& pointB,
-                                            const glm::dvec3& pointC, const glm::dvec3& pointD) const {
-   /*
-   * Let SignedVolume(a,b,c,d) denote the signed volume of the tetrahedron a, b, c and d.
-   * It can be calculated as follows: SignedVolume(a,b,c,d) = (1.0/6.0)* dot(cross(b-a, c-a), d-a)
-   */
-  glm::dvec3 crossProduct = glm::cross(pointB - pointA, pointC - pointA);
+const MeshProperties& FileConverter::properties() const {
+  /* calculate the properties on first use, they are dropped whenever the triangles change */
+  if (!data_.cache.properties) {
+    data_.cache.properties = std::make_shared<const MeshProperties>(calculateProperties());
+  }
 
-  return (1.0 / 6.0) * glm::dot(crossProduct, pointD - pointA);
+  return *data_.cache.properties;
 }
 
-bool FileConverter::hasIntersection(const glm::dvec3& pointP, const glm::dvec3& pointQ,
-                                    const glm::dvec3& pointA, const glm::dvec3& pointB,
-                                    const glm::dvec3& pointC) const {
-  /*
-   * Let Pa, Pb and Pc denote a given triangle.
-   * Pick two points P and Q on the line very far away in both directions.
-   * Let SignedVolume(a,b,c,d) denote the signed volume of the tetrahedron a, b, c and d.
-   *
-   * If SignedVolume(q1, p1, p2, p3) and SignedVolume(q2, p1, p2, p3) have different signs AND
-   * SignedVolume(q1, q2, p1, p2), SignedVolume(q1, q2, p2, p3) and SignedVolume(q1, q2, p3, p1)
-   * have the same sign, then there is an intersection.
-   */
+MeshProperties FileConverter::calculateProperties() const {
+  const auto& triangles = data_.triangles;
+
+  MeshProperties result;
+  if (triangles.empty()) {
+    return result;
+  }
+
+  /* integrate relative to a vertex of the mesh instead of the origin to avoid cancellation far from the origin */
+  const glm::dvec3 reference = triangles[0].vertices[0];
+
+  /* fixed blocks (not one per thread), so the summation order does not depend on the number of threads */
+  const size_t numOfBlocks = (triangles.size() + PROPERTIES_BLOCK_SIZE - 1u) / PROPERTIES_BLOCK_SIZE;
+  std::vector<IntegralSums> partials(numOfBlocks);
 
-  double signedVolumePABC = calculateSignedVolume(pointP, pointA, pointB, pointC);
-  double signedVolumeQABC = calculateSignedVolume(pointQ, pointA, pointB, pointC);
-  double signedVolumePQAB = calculateSignedVolume(pointP, pointQ, pointA, pointB);
-  double signedVolumePQBC = calculateSignedVolume(pointP, pointQ, pointB, pointC);
-  double signedVolumePQCA = calculateSignedVolume(pointP, pointQ, pointC, pointA);
+  parallelFor(triangles.size(), PROPERTIES_BLOCK_SIZE, [&](size_t begin, size_t end) {
+    partials[begin / PROPERTIES_BLOCK_SIZE] = sumIntegrals(triangles, reference, begin, end);
+  });
 
-  int8_t signOfPABC = utils::getSignValue(signedVolumePABC);
-  int8_t signOfQABC = utils::getSignValue(signedVolumeQABC);
-  int8_t signOfPQAB = utils::getSignValue(signedVolumePQAB);
-  int8_t signOfPQBC = utils::getSignValue(signedVolumePQBC);
-  int8_t signOfPQCA = utils::getSignValue(signedVolumePQCA);
+  /* pairwise reduction of the blocks */
+  for (size_t stride = 1u; stride < numOfBlocks; stride *= 2u) {
+    for (size_t i = 0u; i + stride < numOfBlocks; i += 2u * stride) {
+      partials[i].merge(partials[i + stride]);
+    }
+  }
+  const IntegralSums& total = partials[0];
+
+  result.surface = total.value(INTEGRAL_SURFACE);
+  result.boundsMin = total.boundsMin;
+  result.boundsMax = total.boundsMax;
+
+  /* inward facing triangles give negative volumes, so every integral is flipped */
+  double orientation = (total.value(INTEGRAL_VOLUME) < 0.0) ? -1.0 : 1.0;
+  result.volume = orientation * total.value(INTEGRAL_VOLUME);
+  if (0.0 == result.volume) {
+    result.centroid = reference;
+    return result;
+  }
 
-  return ((signOfPABC != signOfQABC) && (signOfPQAB == signOfPQBC && signOfPQAB == signOfPQCA));
+  glm::dvec3 firstMoment(total.value(INTEGRAL_FIRST_X), total.value(INTEGRAL_FIRST_Y), total.value(INTEGRAL_FIRST_Z));
+  glm::dvec3 offset = (orientation * firstMoment) / result.volume;
+  result.centroid = reference + offset;
+
+  /* move the second moment from the reference point to the centroid, then I = trace(C) * E - C */
+  glm::dmat3 secondMoment(total.value(INTEGRAL_SECOND_XX), total.value(INTEGRAL_SECOND_XY), total.value(INTEGRAL_SECOND_XZ),
+                          total.value(INTEGRAL_SECOND_XY), total.value(INTEGRAL_SECOND_YY), total.value(INTEGRAL_SECOND_YZ),
+                          total.value(INTEGRAL_SECOND_XZ), total.value(INTEGRAL_SECOND_YZ), total.value(INTEGRAL_SECOND_ZZ));
+  secondMoment = orientation * secondMoment - result.volume * glm::outerProduct(offset, offset);
+  double trace = secondMoment[0][0] + secondMoment[1][1] + secondMoment[2][2];
+  result.inertia = trace * glm::dmat3(1.0) - secondMoment;
+
+  return result;
 }
 
-double FileConverter::calculateAreaOfTriangle(const glm::dvec3& pointA, const glm::dvec3& pointB, const glm::dvec3& pointC) const {
-  double area = 0.0;
+void FileConverter::updateRigidProperties(const std::shared_ptr<const MeshProperties>& previous, const glm::dmat4& matrix) {
+  /* nothing was calculated before */
+  if (!previous) {
+    return;
+  }
 
   /*
-   * Calculating the area of a triangle step-by-step:
-   * 1) calculate cross porduct of the two direction vectors (Pb - Pa, Pc - Pa)
-   * 2) calculate the magnitude of the result vector (= area of a parallelogram)
-   * 3) half the magnitude (= area of a triangle)
+   * vertices are transformed as row vectors (v' = v * M),
+   * so the linear part is the transposed upper left 3x3 block and the translation is the last row
    */
+  glm::dmat3 linear = glm::transpose(glm::dmat3(matrix));
+  glm::dvec3 translation(matrix[0][3], matrix[1][3], matrix[2][3]);
+
+  /* only rigid transformations (rotation and translation) keep the properties */
+  glm::dmat3 deviation = glm::transpose(linear) * linear - glm::dmat3(1.0);
+  bool isRigid = (matrix[3] == glm::dvec4(0.0, 0.0, 0.0, 1.0)) && (glm::determinant(linear) > 0.0);
+  for (glm::length_t i = 0; i < 3 && isRigid; ++i) {
+    isRigid = (glm::length(deviation[i]) <= RIGID_TOLERANCE);
+  }
+  if (!isRigid) {
+    return;
+  }
+
+  /* volume and surface do not change, the centroid moves and the inertia tensor rotates */
+  MeshProperties updated = *previous;
+  updated.centroid = linear * previous->centroid + translation;
+  updated.inertia = linear * previous->inertia * glm::transpose(linear);
+
+  /* a translated box is exact, a rotated one has to be measured again */
+  if (linear == glm::dmat3(1.0)) {
+    updated.boundsMin += translation;
+    updated.boundsMax += translation;
+  } else {
+    updated.boundsMin = glm::dvec3(std::numeric_limits<double>::max());
+    updated.boundsMax = glm::dvec3(std::numeric_limits<double>::lowest());
+    for (const auto& t : data_.triangles) {
+      for (const auto& v : t.vertices) {
+        updated.boundsMin = glm::min(updated.boundsMin, v);
+        updated.boundsMax = glm::max(updated.boundsMax, v);
+      }
+    }
+  }
+
+  data_.cache.properties = std::make_shared<const MeshProperties>(updated);
+}
+
+bool FileConverter::isPointOutsideOfBoundaries(const glm::dvec3& point) const {
+  /* boundary points of the polygon */
+  const glm::dvec3& boundsMin = properties().boundsMin;
+  const glm::dvec3& boundsMax = properties().boundsMax;
 
-  glm::dvec3 crossProduct = glm::cross(pointB - pointA, pointC - pointA);
-  area = 0.5f * sqrtf((crossProduct.x * crossProduct.x) +
-                      (crossProduct.y * crossProduct.y) +
-                      (crossProduct.z * crossProduct.z));
+  /* point is outside if one of its coordinates is outside or equal to the min or max coordinates */
+  if (point.x <= boundsMin.x || point.x >= boundsMax.x ||
+      point.y <= boundsMin.y || point.y >= boundsMax.y ||
+      point.z <= boundsMin.z || point.z >= boundsMax.z) {
+    return true;
+  }
 
-  return area;
+  return false;
 }
 
-bool FileConverter::intersectsTriangle(const glm::dvec3& probePoint, const glm::dvec3& pointA,
-                                       const glm::dvec3& pointB, const glm::dvec3& pointC) const {
+SegmentCrossing FileConverter::classifyCrossing(const glm::dvec3& pointP, const glm::dvec3& pointQ,
+                                                const glm::dvec3& pointA, const glm::dvec3& pointB,
+                                                const glm::dvec3& pointC) const {
   /*
-   * The probe point intersects the triangle if the points are coplanar.
-   * They are coplanar if and only if one of the areas of the four triangles has an area equal to the sum
-   * of the other three areas (e.g. P = PA + PB + PC).
+   * Let Pa, Pb and Pc denote a given triangle.
+   * Pick two points P and Q on the line very far away in both directions.
+   * Let SignedVolume(a,b,c,d) denote the signed volume of the tetrahedron a, b, c and d.
+   *
+   * If SignedVolume(q1, p1, p2, p3) and SignedVolume(q2, p1, p2, p3) have different signs AND
+   * SignedVolume(q1, q2, p1, p2), SignedVolume(q1, q2, p2, p3) and SignedVolume(q1, q2, p3, p1)
+   * have the same sign, then there is an intersection.
+   *
+   * The signs are evaluated exactly, so a zero sign reliably means that the segment touches
+   * an edge or a vertex of the triangle (or lies in its plane).
    */
 
-  /* calculate area of (probePoint, A, B) triangle */
-  double areaOfPAB = calculateAreaOfTriangle(probePoint, pointA, pointB);
+  int8_t signOfPABC = orient3d(pointP, pointA, pointB, pointC);
+  int8_t signOfQABC = orient3d(pointQ, pointA, pointB, pointC);
+
+  /* both ends on the same side, or a degenerate triangle / a segment in the plane of the triangle */
+  if (signOfPABC == signOfQABC) {
+    return SegmentCrossing::CROSSING_NONE;
+  }
 
-  /* calculate area of (probePoint, A, C) triangle */
-  double areaOfPAC = calculateAreaOfTriangle(probePoint, pointA, pointC);
+  int8_t signOfPQAB = orient3d(pointP, pointQ, pointA, pointB);
+  int8_t signOfPQBC = orient3d(pointP, pointQ, pointB, pointC);
+  int8_t signOfPQCA = orient3d(pointP, pointQ, pointC, pointA);
 
-  /* calculate area of (probePoint, B, C) triangle */
-  double areaOfPBC = calculateAreaOfTriangle(probePoint, pointB, pointC);
+  /* the line passes outside of an edge */
+  if ((signOfPQAB * signOfPQBC < 0) || (signOfPQBC * signOfPQCA < 0) || (signOfPQCA * signOfPQAB < 0)) {
+    return SegmentCrossing::CROSSING_NONE;
+  }
 
-  /* calculate area of the original triangle */
-  double areaOfABC = calculateAreaOfTriangle(pointA, pointB, pointC);
+  /* the line touches an edge or a vertex */
+  if (0 == signOfPQAB || 0 == signOfPQBC || 0 == signOfPQCA || 0 == signOfQABC) {
+    return SegmentCrossing::CROSSING_DEGENERATE;
+  }
 
-  return areaOfABC == (areaOfPAB + areaOfPAC + areaOfPBC);
+  /* the line passes through the interior of the triangle */
+  return (0 == signOfPABC) ? SegmentCrossing::CROSSING_START_ON_TRIANGLE : SegmentCrossing::CROSSING_PROPER;
 }
 
 void FileConverter::setInputFormat(InputType input) {
+  /* the format is detected at every read */
+  isInputDetected_ = (input == InputType::INPUT_TYPE_AUTO);
+  if (isInputDetected_) {
+    reader_.reset();
+    inputFormat_ = nullptr;
+    return;
+  }
+
   /* set proper read object type */
-  switch (input) {
-  case InputType::INPUT_TYPE_OBJ:
-    reader_ = std::make_unique<ReadObj>();
-    break;
-  default:
+  const ReaderFormat* format = FormatRegistry::instance().reader(input);
+  if (!format) {
     /* Not supported reading converter type */
     throw std::runtime_error("Not supported read object type");
   }
+
+  reader_ = format->create();
+  inputFormat_ = format;
 }
 
 void FileConverter::setOutputFormat(OutputType output) {
+  /* the format is chosen at every write */
+  isOutputByExtension_ = (output == OutputType::OUTPUT_TYPE_AUTO);
+  if (isOutputByExtension_) {
+    writer_.reset();
+    outputFormat_ = nullptr;
+    return;
+  }
+
   /* set proper write object type */
-  switch (output) {
-  case OutputType::OUTPUT_TYPE_STL:
-    writer_ = std::make_unique<WriteStl>();
-    break;
-  default:
+  const WriterFormat* format = FormatRegistry::instance().writer(output);
+  if (!format) {
     /* Not supported writing converter type */
     throw std::runtime_error("Not supported write object type");
   }
+
+  writer_ = format->create();
+  outputFormat_ = format;
 }
 
-void FileConverter::read(const std::string& pathToFile) {
+void FileConverter::setReader(std::unique_ptr<Reader> reader) {
+  /* the reader reads the files itself, its format is not known */
+  reader_ = std::move(reader);
+  inputFormat_ = nullptr;
+  isInputDetected_ = false;
+}
+
+void FileConverter::setWriter(std::unique_ptr<Writer> writer) {
+  writer_ = std::move(writer);
+  outputFormat_ = nullptr;
+  isOutputByExtension_ = false;
+}
+
+void FileConverter::read(const std::string& pathToFile, const Progress& progress) {
+  if (!reader_ && !isInputDetected_) {
+    throw std::runtime_error("No input format set");
+  }
+
+  /* the file is mapped for the detection and for the readers parsing from memory, the others read it themselves */
+  if (isInputDetected_ || (inputFormat_ && (inputFormat_->capabilities & READER_CAPABILITY_MMAP))) {
+    read(MappedFile(pathToFile), pathToFile, progress);
+    return;
+  }
+
+  /* clear data structure */
+  data_.clear();
+
+  reader_->read(pathToFile, data_, progress);
+}
+
+void FileConverter::read(const uint8_t* bytes, size_t size, const Progress& progress) {
+  if (!reader_ && !isInputDetected_) {
+    throw std::runtime_error("No input format set");
+  }
+
+  /* clear data structure */
+  data_.clear();
+
+  if (isInputDetected_) {
+    detectInput(bytes, size, "bytes in memory");
+  }
+
+  /* every built-in reader parses from memory, a reader set directly may not */
+  reader_->read(bytes, size, data_, progress);
+}
+
+void FileConverter::read(const MappedFile& file, const std::string& pathToFile, const Progress& progress) {
+  if (!reader_ && !isInputDetected_) {
+    throw std::runtime_error("No input format set");
+  }
+
   /* clear data structure */
   data_.clear();
 
+  if (isInputDetected_) {
+    detectInput(file.data(), file.size(), pathToFile);
+  }
+
   /* read file and store data internally */
-  reader_->read(pathToFile, data_);
+  if (inputFormat_ && (inputFormat_->capabilities & READER_CAPABILITY_MMAP)) {
+    reader_->read(file.data(), file.size(), data_, progress);
+  } else {
+    reader_->read(pathToFile, data_, progress);
+  }
+}
+
+void FileConverter::detectInput(const uint8_t* bytes, size_t size, const std::string& name) {
+  const ReaderFormat* format = FormatRegistry::instance().detect(bytes, size, size);
+  if (!format) {
+    throw std::runtime_error(std::string("Unknown input format: ") + name);
+  }
+
+  if (format != inputFormat_) {
+    reader_ = format->create();
+    inputFormat_ = format;
+  }
 }
 
-void FileConverter::write(const std::string& pathToFile) {
+void FileConverter::write(const std::string& pathToFile, const Progress& progress) {
+  if (isOutputByExtension_) {
+    const WriterFormat* format = FormatRegistry::instance().writerForPath(pathToFile);
+    if (!format) {
+      throw std::runtime_error(std::string("Unknown output format: ") + pathToFile);
+    }
+
+    if (format != outputFormat_) {
+      writer_ = format->create();
+      outputFormat_ = format;
+    }
+  }
+
+  if (!writer_) {
+    throw std::runtime_error("No output format set");
+  }
+
   /* write internally stored data into file */
-  writer_->write(pathToFile, data_);
+  writer_->write(pathToFile, data_, progress);
+}
+
+void FileConverter::write(std::ostream& stream, const Progress& progress) {
+  if (isOutputByExtension_ || !writer_) {
+    throw std::runtime_error("No output format set");
+  }
+
+  writer_->write(stream, data_, progress);
+}
+
+void FileConverter::write(std::vector<uint8_t>& buffer, const Progress& progress) {
+  OutputBuffer output(buffer);
+  std::ostream stream(&output);
+  write(stream, progress);
+}
+
+std::future<void> FileConverter::runAsync(std::function<void(const Progress&)> operation, const AsyncOptions& options) {
+  auto promise = std::make_shared<std::promise<void>>();
+  std::future<void> future = promise->get_future();
+  Progress progress(options.cancellation, options.progress);
+
+  Scheduler::instance().submit([operation = std::move(operation), promise, progress, completion = options.completion]() {
+    std::exception_ptr error;
+    try {
+      /* cancelled before it could start */
+      progress.checkCancelled();
+      operation(progress);
+    } catch (...) {
+      error = std::current_exception();
+    }
+
+    /* a failing callback must not leave the future unsatisfied */
+    if (completion) {
+      try {
+        completion(error);
+      } catch (...) {
+      }
+    }
+
+    if (error) {
+      promise->set_exception(error);
+    } else {
+      promise->set_value();
+    }
+  });
+
+  return future;
+}
+
+std::future<void> FileConverter::readAsync(const std::string& pathToFile, const AsyncOptions& options) {
+  return runAsync([this, pathToFile](const Progress& progress) { read(pathToFile, progress); }, options);
+}
+
+std::future<void> FileConverter::writeAsync(const std::string& pathToFile, const AsyncOptions& options) {
+  return runAsync([this, pathToFile](const Progress& progress) { write(pathToFile, progress); }, options);
+}
+
+std::future<void> FileConverter::convertAsync(const std::string& inputPath, const std::string& outputPath,
+                                              const AsyncOptions& options) {
+  return runAsync([this, inputPath, outputPath](const Progress& progress) {
+    read(inputPath, progress.part(0.0, 0.5));
+    write(outputPath, progress.part(0.5, 1.0));
+  }, options);
 }
 
 void FileConverter::rotate(const glm::dvec3& rotate) {
@@ -237,11 +662,17 @@ void FileConverter::rotate(const glm::dvec3& rotate) {
     data_.transformOperations.emplace_back(rotateMatrix);
   }
 
+  /* keep the properties, a rotation only moves them */
+  auto previous = data_.cache.properties;
+
   /* transform vertices and normals */
-  transform();
+  glm::dmat4 transformMatrix = transform();
 
   /* update triangles */
   data_.updateTriangles();
+
+  /* update the properties instead of calculating them again */
+  updateRigidProperties(previous, transformMatrix);
 }
 
 void FileConverter::scale(const glm::dvec3& scale) {
@@ -267,92 +698,128 @@ void FileConverter::translate(const glm::dvec3& translate) {
 
   data_.transformOperations.emplace_back(translateMatrix);
 
+  /* keep the properties, a translation only moves them */
+  auto previous = data_.cache.properties;
+
   /* transform vertices and normals */
-  transform();
+  glm::dmat4 transformMatrix = transform();
 
   /* update triangles */
   data_.updateTriangles();
+
+  /* update the properties instead of calculating them again */
+  updateRigidProperties(previous, transformMatrix);
 }
 
-bool FileConverter::isPointInside(const glm::dvec3& point) {
+VertexCacheStatistics FileConverter::optimizeVertexCache() {
+  /* keep the properties, the order of the triangles and vertices does not change them */
+  auto previous = data_.cache.properties;
+
+  /* reorder the faces and vertices, the triangles are updated */
+  VertexCacheStatistics statistics = conv::optimizeVertexCache(data_);
+
+  data_.cache.properties = previous;
+  return statistics;
+}
+
+bool FileConverter::isPointInside(const glm::dvec3& point) const {
   /* check whether the point is outside the boundary box */
   if (isPointOutsideOfBoundaries(point)) {
     return false;
   }
 
-  /* get point outside of the boundary box called infinity */
-  glm::dvec3 infinityPoint(data_.polygonBoundaries[1].x + COORD_OFFSET_VALUE,
-                           data_.polygonBoundaries[1].y + COORD_OFFSET_VALUE,
-                           data_.polygonBoundaries[1].z + COORD_OFFSET_VALUE);
+  /*
+   * use ray casting algoritm to determine whether the point is inside:
+   * the point is inside if the segment to a point outside of the boundary box called infinity
+   * crosses the surface an odd number of times
+   * if the segment touches an edge or a vertex, the crossings cannot be counted reliably,
+   * so the next infinity point is tried
+   */
+  for (const auto& direction : PROBE_DIRECTIONS) {
+    glm::dvec3 infinityPoint = properties().boundsMax + COORD_OFFSET_VALUE * direction;
+
+    /* only the triangles whose bounding boxes are crossed by the segment can intersect it */
+    std::vector<uint32_t> candidates;
+    bvh().collectCandidates(point, infinityPoint, candidates);
+
+    size_t numOfCrossings = 0u;
+    bool isDegenerate = false;
+    for (const auto index : candidates) {
+      const auto& triangle = data_.triangles[index];
+
+      SegmentCrossing crossing = classifyCrossing(point, infinityPoint, triangle.vertices[0],
+                                                  triangle.vertices[1], triangle.vertices[2]);
+      if (SegmentCrossing::CROSSING_PROPER == crossing) {
+        ++numOfCrossings;
+      } else if (SegmentCrossing::CROSSING_START_ON_TRIANGLE == crossing) {
+        /* the point lies on the surface, which counts as outside (as on the boundary box) */
+        return false;
+      } else if (SegmentCrossing::CROSSING_DEGENERATE == crossing) {
+        isDegenerate = true;
+        break;
+      }
+    }
+
+    if (!isDegenerate) {
+      /* the point is inside if the number of intersections is odd */
+      return (numOfCrossings & 1u);
+    }
+  }
 
-  std::vector<glm::dvec3> intersectionPoints;
+  /* no probe segment avoids the edges and vertices: the point lies on the surface */
+  return false;
+}
 
-  /* use ray casting algoritm to determine whether the point is inside */
-  for (const auto& triangle : data_.triangles) {
-    glm::dvec3 vertex1 = triangle.vertices[0];
-    glm::dvec3 vertex2 = triangle.vertices[1];
-    glm::dvec3 vertex3 = triangle.vertices[2];
+std::vector<bool> FileConverter::isPointInside(const std::vector<glm::dvec3>& points) const {
+  /* built before the parallel loop, the points only read them */
+  buildQueryStructures();
 
-    /* check whether there is an intersection */
-    if (!hasIntersection(point, infinityPoint, vertex1, vertex2, vertex3)) {
-      continue;
+  std::vector<uint8_t> inside(points.size(), 0u);
+  parallelFor(points.size(), INSIDE_BLOCK_SIZE, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      inside[i] = isPointInside(points[i]) ? 1u : 0u;
     }
+  });
 
-    /* get normal vector */
-    glm::dvec3 normalVector = glm::cross(vertex2 - vertex1, vertex3 - vertex1);
-
-    /*
-     * equation of the line is: p(t) = point + t * (infinityPoint - point)
-     * equation of the plane is: dot(point - vertex1, normalVector) = 0, where
-     * normalVector = cross(vertex2 - vertex1, vertex3 - vertex1)
-     * t = -dot(point - vertex1, normalVector) / dot(infinityPoint - point, normalVector)
-     * and if 0 < t < 1, then
-     * intersectionPoint = point + t * (infinityPoint - point)
-     */
-    double dotProductPN = glm::dot(point - vertex1, normalVector);
-    double dotProductIN = glm::dot(infinityPoint - point, normalVector);
-    double t = -(dotProductPN / dotProductIN);
-    /* precondition check (0 < t < 1 must be fulfilled) */
-    if (t <= 0.0 || t >= 1.0) {
-      continue;
-    }
+  return std::vector<bool>(inside.begin(), inside.end());
+}
 
-    /* calculate intersection point */
-    glm::dvec3 intersectionPoint = point + t * (infinityPoint - point);
+std::vector<RayHit> FileConverter::firstHits(const std::vector<Ray>& rays) const {
+  return bvh().firstHits(rays);
+}
 
-    /* check if the point is on the plane of the triangle */
-    if (intersectsTriangle(intersectionPoint, vertex1, vertex2, vertex3)) {
-      /* check if the point has not been found before */
-      if (std::find(intersectionPoints.begin(), intersectionPoints.end(), intersectionPoint) == intersectionPoints.end()) {
-        intersectionPoints.emplace_back(intersectionPoint);
-      }
-    }
-  }
+std::vector<RayHit> FileConverter::anyHits(const std::vector<Ray>& rays) const {
+  return bvh().anyHits(rays);
+}
 
-  /* the point is inside if the number of intersections is odd */
-  return (intersectionPoints.size() & 1u);
+std::vector<std::vector<RayHit>> FileConverter::allHits(const std::vector<Ray>& rays) const {
+  return bvh().allHits(rays);
 }
 
-double FileConverter::volume() const {
-  double volume = 0.0;
+std::vector<VertexNeighbour> FileConverter::verticesWithinRadius(const glm::dvec3& point, double radius) const {
+  return vertexOctree().withinRadius(point, radius);
+}
 
-  /* calculate the signed volume of a given tetrahedron based on a given triangle and topped off at the origin */
-  for (const auto& t : data_.triangles) {
-    volume += calculateSignedVolume(glm::dvec3 {0.0, 0.0, 0.0}, t.vertices[0], t.vertices[1], t.vertices[2]);
-  }
+std::vector<std::vector<VertexNeighbour>> FileConverter::verticesWithinRadius(const std::vector<glm::dvec3>& points,
+                                                                              double radius) const {
+  return vertexOctree().withinRadius(points, radius);
+}
 
-  return std::fabs(volume);
+std::vector<VertexNeighbour> FileConverter::nearestVertices(const glm::dvec3& point, size_t k) const {
+  return vertexOctree().nearest(point, k);
 }
 
-double FileConverter::surface() const {
-  double surface = 0.0;
+std::vector<std::vector<VertexNeighbour>> FileConverter::nearestVertices(const std::vector<glm::dvec3>& points,
+                                                                         size_t k) const {
+  return vertexOctree().nearest(points, k);
+}
 
-  /* surface = area of all of the triangles that make up the polygon mesh */
-  for (const auto& t : data_.triangles) {
-    surface += calculateAreaOfTriangle(t.vertices[0], t.vertices[1], t.vertices[2]);
-  }
+double FileConverter::volume() const {
+  return properties().volume;
+}
 
-  return surface;
+double FileConverter::surface() const {
+  return properties().surface;
 }
 
 } // namespace conv
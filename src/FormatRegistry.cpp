@@ -0,0 +1,319 @@
+#include "FormatRegistry.h"
+#include "Edgebreaker.h"
+#include "NativeMesh.h"
+#include "ReadEdgebreaker.h"
+#include "ReadNative.h"
+#include "ReadObj.h"
+#include "ReadOff.h"
+#include "ReadPacked.h"
+#include "ReadPly.h"
+#include "ReadStl.h"
+#include "ReadStlAscii.h"
+#include "Write3mf.h"
+#include "WriteEdgebreaker.h"
+#include "WriteGlb.h"
+#include "WriteNative.h"
+#include "WriteObj.h"
+#include "WriteOff.h"
+#include "WritePacked.h"
+#include "WritePly.h"
+#include "WriteStl.h"
+#include "WriteStlAscii.h"
+
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <string_view>
+
+
+namespace conv {
+
+namespace {
+
+/* function to check whether the bytes look like text (no control characters except white space) */
+bool isText(const uint8_t* bytes, size_t size) {
+  for (size_t i = 0u; i < size; ++i) {
+    if (bytes[i] < 0x20u && bytes[i] != '\n' && bytes[i] != '\r' && bytes[i] != '\t' && bytes[i] != '\f') {
+      return false;
+    }
+  }
+  return true;
+}
+
+/* function to get the keywords of the lines (the first word of every line) */
+std::vector<std::string> lineKeywords(const uint8_t* bytes, size_t size, bool isWholeFile) {
+  std::vector<std::string> keywords;
+  size_t position = 0u;
+  while (position < size) {
+    while (position < size && (bytes[position] == ' ' || bytes[position] == '\t')) {
+      ++position;
+    }
+
+    size_t end = position;
+    while (end < size && !std::isspace(bytes[end])) {
+      ++end;
+    }
+
+    /* the last word may be cut off by the end of the sniffed bytes */
+    if (end < size || isWholeFile) {
+      keywords.emplace_back(reinterpret_cast<const char*>(bytes) + position, end - position);
+    }
+
+    while (end < size && bytes[end] != '\n') {
+      ++end;
+    }
+    position = end + 1u;
+  }
+  return keywords;
+}
+
+/* function to rate the bytes as the start of a Wavefront OBJ file */
+int sniffObj(const uint8_t* bytes, size_t size, uint64_t fileSize) {
+  (void)fileSize;
+  if (!isText(bytes, size)) {
+    return 0;
+  }
+
+  /*
+   * the lines start with statements or comments, at least one of them is a vertex or a face
+   * (rarely used statements are tolerated as long as most of the lines are common ones)
+   */
+  static const std::vector<std::string> GEOMETRY_STATEMENTS{"v", "vt", "vn", "vp", "f", "l", "p"};
+  static const std::vector<std::string> GROUPING_STATEMENTS{"o", "g", "s", "mg", "mtllib", "usemtl"};
+
+  size_t numOfGeometryLines = 0u;
+  size_t numOfOtherLines = 0u;
+  size_t numOfUnknownLines = 0u;
+  for (const auto& keyword : lineKeywords(bytes, size, size == fileSize)) {
+    if (keyword.empty() || keyword[0] == '#') {
+      continue;
+    }
+
+    if (std::find(GEOMETRY_STATEMENTS.begin(), GEOMETRY_STATEMENTS.end(), keyword) != GEOMETRY_STATEMENTS.end()) {
+      ++numOfGeometryLines;
+    } else if (std::find(GROUPING_STATEMENTS.begin(), GROUPING_STATEMENTS.end(), keyword) != GROUPING_STATEMENTS.end()) {
+      ++numOfOtherLines;
+    } else {
+      ++numOfUnknownLines;
+    }
+  }
+
+  /* a file without statements (empty, only comments) is read as an empty mesh, any other format is preferred */
+  const size_t numOfLines = numOfGeometryLines + numOfOtherLines + numOfUnknownLines;
+  if (0u == numOfLines) {
+    return 1;
+  }
+  return (0u != numOfGeometryLines && 4u * numOfUnknownLines <= numOfLines) ? 50 : 0;
+}
+
+/* function to rate the bytes as the start of an ASCII OFF file */
+int sniffOff(const uint8_t* bytes, size_t size, uint64_t fileSize) {
+  if (!isText(bytes, size)) {
+    return 0;
+  }
+
+  /* the first word after the comments is the keyword */
+  const auto keywords = lineKeywords(bytes, size, size == fileSize);
+  auto first = std::find_if(keywords.begin(), keywords.end(), [](const std::string& k) { return !k.empty() && k[0] != '#'; });
+  OffKeyword keyword;
+  return (first != keywords.end() && ReadOff::parseKeyword(*first, keyword)) ? 100 : 0;
+}
+
+/* function to rate the bytes as the start of a binary STL file (the header may start with "solid" too) */
+int sniffBinaryStl(const uint8_t* bytes, size_t size, uint64_t fileSize) {
+  if (size < 84u) {
+    return 0;
+  }
+
+  /* the number of triangles gives the exact size of the file */
+  const uint32_t numOfTriangles = static_cast<uint32_t>(bytes[80]) | (static_cast<uint32_t>(bytes[81]) << 8u) |
+                                  (static_cast<uint32_t>(bytes[82]) << 16u) | (static_cast<uint32_t>(bytes[83]) << 24u);
+  return (0u != ReadStl::recordSize(numOfTriangles, fileSize)) ? 100 : 0;
+}
+
+/* function to rate the bytes as the start of an ASCII STL file */
+int sniffAsciiStl(const uint8_t* bytes, size_t size, uint64_t fileSize) {
+  if (!isText(bytes, size)) {
+    return 0;
+  }
+
+  /* "solid name" followed by a facet (or the end of an empty solid) */
+  const auto keywords = lineKeywords(bytes, size, size == fileSize);
+  auto first = std::find_if(keywords.begin(), keywords.end(), [](const std::string& k) { return !k.empty(); });
+  if (first == keywords.end() || *first != "solid") {
+    return 0;
+  }
+  return std::any_of(first + 1, keywords.end(), [](const std::string& k) { return k == "facet" || k == "endsolid"; }) ? 80 : 0;
+}
+
+/* function to rate the bytes as the start of a binary PLY file */
+int sniffPly(const uint8_t* bytes, size_t size, uint64_t fileSize) {
+  (void)fileSize;
+  const std::string_view start(reinterpret_cast<const char*>(bytes), size);
+  const bool hasMagic = (start.compare(0u, 4u, "ply\n") == 0 || start.compare(0u, 5u, "ply\r\n") == 0);
+  return (hasMagic && start.find("format binary_") != std::string_view::npos) ? 100 : 0;
+}
+
+/* function to rate the bytes as the start of a native .3dfc file */
+int sniffNative(const uint8_t* bytes, size_t size, uint64_t fileSize) {
+  (void)fileSize;
+  return (size >= sizeof(NativeHeader) && std::memcmp(bytes, NATIVE_MAGIC, sizeof(NATIVE_MAGIC)) == 0) ? 100 : 0;
+}
+
+/* function to rate the bytes as the start of a compressed .3dfz file */
+int sniffPacked(const uint8_t* bytes, size_t size, uint64_t fileSize) {
+  (void)fileSize;
+  return (size >= sizeof(PackedHeader) && std::memcmp(bytes, PACKED_MAGIC, sizeof(PACKED_MAGIC)) == 0) ? 100 : 0;
+}
+
+/* function to rate the bytes as the start of a .3dfe file */
+int sniffEdgebreaker(const uint8_t* bytes, size_t size, uint64_t fileSize) {
+  (void)fileSize;
+  return (size >= sizeof(EdgebreakerHeader) && std::memcmp(bytes, EDGEBREAKER_MAGIC, sizeof(EDGEBREAKER_MAGIC)) == 0) ? 100 : 0;
+}
+
+/* function to get the lower case extension of the path */
+std::string extensionOf(const std::string& pathToFile) {
+  std::string extension = std::filesystem::path(pathToFile).extension().string();
+  std::transform(extension.begin(), extension.end(), extension.begin(),
+                 [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+  return extension;
+}
+
+} // namespace
+
+FormatRegistry& FormatRegistry::instance() {
+  static FormatRegistry registry;
+  static const bool isInitialized = (registry.registerBuiltInFormats(), true);
+  (void)isInitialized;
+  return registry;
+}
+
+void FormatRegistry::registerBuiltInFormats() {
+  registerReader({InputType::INPUT_TYPE_OBJ, "obj", READER_CAPABILITY_MMAP,
+                  sniffObj, [] { return std::make_unique<ReadObj>(); }});
+  registerReader({InputType::INPUT_TYPE_STL, "stl", READER_CAPABILITY_MMAP,
+                  sniffBinaryStl, [] { return std::make_unique<ReadStl>(); }});
+  registerReader({InputType::INPUT_TYPE_STL_ASCII, "stl-ascii", READER_CAPABILITY_MMAP,
+                  sniffAsciiStl, [] { return std::make_unique<ReadStlAscii>(); }});
+  registerReader({InputType::INPUT_TYPE_PLY, "ply", READER_CAPABILITY_MMAP,
+                  sniffPly, [] { return std::make_unique<ReadPly>(); }});
+  registerReader({InputType::INPUT_TYPE_NATIVE, "3dfc", READER_CAPABILITY_MMAP,
+                  sniffNative, [] { return std::make_unique<ReadNative>(); }});
+  registerReader({InputType::INPUT_TYPE_PACKED, "3dfz", READER_CAPABILITY_MMAP,
+                  sniffPacked, [] { return std::make_unique<ReadPacked>(); }});
+  registerReader({InputType::INPUT_TYPE_EDGEBREAKER, "3dfe", READER_CAPABILITY_MMAP,
+                  sniffEdgebreaker, [] { return std::make_unique<ReadEdgebreaker>(); }});
+  registerReader({InputType::INPUT_TYPE_OFF, "off", READER_CAPABILITY_MMAP,
+                  sniffOff, [] { return std::make_unique<ReadOff>(); }});
+
+  /* the first registered writer of an extension is chosen by the output path, so binary .stl precedes ASCII */
+  registerWriter({OutputType::OUTPUT_TYPE_STL, "stl", {".stl"}, [] { return std::make_unique<WriteStl>(); }});
+  registerWriter({OutputType::OUTPUT_TYPE_STL_ASCII, "stl-ascii", {".stl"},
+                  [] { return std::make_unique<WriteStlAscii>(); }});
+  registerWriter({OutputType::OUTPUT_TYPE_PLY, "ply", {".ply"}, [] { return std::make_unique<WritePly>(); }});
+  registerWriter({OutputType::OUTPUT_TYPE_GLB, "glb", {".glb"}, [] { return std::make_unique<WriteGlb>(); }});
+  registerWriter({OutputType::OUTPUT_TYPE_NATIVE, "3dfc", {".3dfc"}, [] { return std::make_unique<WriteNative>(); }});
+  registerWriter({OutputType::OUTPUT_TYPE_PACKED, "3dfz", {".3dfz"}, [] { return std::make_unique<WritePacked>(); }});
+  registerWriter({OutputType::OUTPUT_TYPE_EDGEBREAKER, "3dfe", {".3dfe"}, [] { return std::make_unique<WriteEdgebreaker>(); }});
+  registerWriter({OutputType::OUTPUT_TYPE_OBJ, "obj", {".obj"}, [] { return std::make_unique<WriteObj>(); }});
+  registerWriter({OutputType::OUTPUT_TYPE_OFF, "off", {".off"}, [] { return std::make_unique<WriteOff>(); }});
+  registerWriter({OutputType::OUTPUT_TYPE_3MF, "3mf", {".3mf"}, [] { return std::make_unique<Write3mf>(); }});
+}
+
+void FormatRegistry::registerReader(const ReaderFormat& format) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  storedReaders_.emplace_back(std::make_unique<ReaderFormat>(format));
+
+  auto it = std::find_if(readers_.begin(), readers_.end(), [&](const ReaderFormat* r) { return r->type == format.type; });
+  if (it != readers_.end()) {
+    *it = storedReaders_.back().get();
+  } else {
+    readers_.emplace_back(storedReaders_.back().get());
+  }
+}
+
+void FormatRegistry::registerWriter(const WriterFormat& format) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  storedWriters_.emplace_back(std::make_unique<WriterFormat>(format));
+
+  auto it = std::find_if(writers_.begin(), writers_.end(), [&](const WriterFormat* w) { return w->type == format.type; });
+  if (it != writers_.end()) {
+    *it = storedWriters_.back().get();
+  } else {
+    writers_.emplace_back(storedWriters_.back().get());
+  }
+}
+
+const ReaderFormat* FormatRegistry::reader(InputType type) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const ReaderFormat* r : readers_) {
+    if (r->type == type) {
+      return r;
+    }
+  }
+  return nullptr;
+}
+
+const WriterFormat* FormatRegistry::writer(OutputType type) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const WriterFormat* w : writers_) {
+    if (w->type == type) {
+      return w;
+    }
+  }
+  return nullptr;
+}
+
+const WriterFormat* FormatRegistry::writer(const std::string& name) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const WriterFormat* w : writers_) {
+    if (w->name == name) {
+      return w;
+    }
+  }
+  return nullptr;
+}
+
+const WriterFormat* FormatRegistry::writerForPath(const std::string& pathToFile) const {
+  const std::string extension = extensionOf(pathToFile);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const WriterFormat* w : writers_) {
+    if (std::find(w->extensions.begin(), w->extensions.end(), extension) != w->extensions.end()) {
+      return w;
+    }
+  }
+  return nullptr;
+}
+
+const ReaderFormat* FormatRegistry::detect(const uint8_t* bytes, size_t size, uint64_t fileSize) const {
+  size = std::min(size, SNIFF_SIZE_IN_BYTES);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  const ReaderFormat* best = nullptr;
+  int bestScore = 0;
+  for (const ReaderFormat* r : readers_) {
+    const int score = r->sniff ? r->sniff(bytes, size, fileSize) : 0;
+    if (score > bestScore) {
+      best = r;
+      bestScore = score;
+    }
+  }
+  return best;
+}
+
+const ReaderFormat* FormatRegistry::detect(const std::string& pathToFile) const {
+  std::ifstream file(pathToFile, std::ios::in | std::ios::binary);
+  if (!file.is_open()) {
+    throw std::runtime_error(std::string("Cannot open file for read: ") + pathToFile);
+  }
+
+  std::vector<uint8_t> bytes(SNIFF_SIZE_IN_BYTES);
+  file.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+  bytes.resize(static_cast<size_t>(file.gcount()));
+
+  return detect(bytes.data(), bytes.size(), std::filesystem::file_size(pathToFile));
+}
+
+} // namespace conv
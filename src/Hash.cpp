@@ -0,0 +1,106 @@
+#include "Hash.h"
+
+#include <cstring>
+
+
+namespace conv {
+
+constexpr uint64_t PRIME64_1 = 0x9E3779B185EBCA87u;
+constexpr uint64_t PRIME64_2 = 0xC2B2AE3D27D4EB4Fu;
+constexpr uint64_t PRIME64_3 = 0x165667B19E3779F9u;
+constexpr uint64_t PRIME64_4 = 0x85EBCA77C2B2AE63u;
+constexpr uint64_t PRIME64_5 = 0x27D4EB2F165667C5u;
+
+constexpr size_t STRIPE_SIZE_IN_BYTES = 32u;
+
+namespace {
+
+inline uint64_t rotateLeft(uint64_t value, uint32_t bits) {
+  return (value << bits) | (value >> (64u - bits));
+}
+
+inline uint64_t read64(const uint8_t* p) {
+  uint64_t value;
+  std::memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+inline uint32_t read32(const uint8_t* p) {
+  uint32_t value;
+  std::memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+inline uint64_t round(uint64_t accumulator, uint64_t input) {
+  accumulator += input * PRIME64_2;
+  accumulator = rotateLeft(accumulator, 31u);
+  return accumulator * PRIME64_1;
+}
+
+inline uint64_t mergeRound(uint64_t accumulator, uint64_t value) {
+  accumulator ^= round(0u, value);
+  return accumulator * PRIME64_1 + PRIME64_4;
+}
+
+} // namespace
+
+uint64_t hash64(const void* data, size_t size, uint64_t seed) {
+  const uint8_t* p = static_cast<const uint8_t*>(data);
+  const uint8_t* const end = p + size;
+  uint64_t h = 0u;
+
+  if (size >= STRIPE_SIZE_IN_BYTES) {
+    /* lanes of the stripes */
+    uint64_t v1 = seed + PRIME64_1 + PRIME64_2;
+    uint64_t v2 = seed + PRIME64_2;
+    uint64_t v3 = seed;
+    uint64_t v4 = seed - PRIME64_1;
+
+    const uint8_t* const limit = end - STRIPE_SIZE_IN_BYTES;
+    do {
+      v1 = round(v1, read64(p));
+      v2 = round(v2, read64(p + 8u));
+      v3 = round(v3, read64(p + 16u));
+      v4 = round(v4, read64(p + 24u));
+      p += STRIPE_SIZE_IN_BYTES;
+    } while (p <= limit);
+
+    h = rotateLeft(v1, 1u) + rotateLeft(v2, 7u) + rotateLeft(v3, 12u) + rotateLeft(v4, 18u);
+    h = mergeRound(h, v1);
+    h = mergeRound(h, v2);
+    h = mergeRound(h, v3);
+    h = mergeRound(h, v4);
+  } else {
+    h = seed + PRIME64_5;
+  }
+
+  h += static_cast<uint64_t>(size);
+
+  /* remaining bytes */
+  while (p + 8u <= end) {
+    h ^= round(0u, read64(p));
+    h = rotateLeft(h, 27u) * PRIME64_1 + PRIME64_4;
+    p += 8u;
+  }
+  if (p + 4u <= end) {
+    h ^= static_cast<uint64_t>(read32(p)) * PRIME64_1;
+    h = rotateLeft(h, 23u) * PRIME64_2 + PRIME64_3;
+    p += 4u;
+  }
+  while (p < end) {
+    h ^= (*p) * PRIME64_5;
+    h = rotateLeft(h, 11u) * PRIME64_1;
+    ++p;
+  }
+
+  /* avalanche */
+  h ^= h >> 33u;
+  h *= PRIME64_2;
+  h ^= h >> 29u;
+  h *= PRIME64_3;
+  h ^= h >> 32u;
+
+  return h;
+}
+
+} // namespace conv
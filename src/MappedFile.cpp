@@ -0,0 +1,77 @@
+#include "MappedFile.h"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+namespace conv {
+
+MappedFile::MappedFile(const std::string& pathToFile) {
+  if (pathToFile.empty()) {
+    throw std::invalid_argument(std::string("No path to the input file: ") + pathToFile);
+  }
+
+  int file = ::open(pathToFile.c_str(), O_RDONLY);
+  if (file < 0) {
+    throw std::runtime_error(std::string("Cannot open file for read: ") + pathToFile);
+  }
+
+  struct stat status;
+  if (::fstat(file, &status) < 0) {
+    ::close(file);
+    throw std::runtime_error(std::string("Cannot get the size of the file: ") + pathToFile);
+  }
+
+  /* an empty file cannot be mapped */
+  size_ = static_cast<size_t>(status.st_size);
+  if (0u != size_) {
+    void* mapping = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, file, 0);
+    if (mapping == MAP_FAILED) {
+      std::string message = std::strerror(errno);
+      ::close(file);
+      throw std::runtime_error("Cannot map file " + pathToFile + ": " + message);
+    }
+
+    /* the readers go through the file from the start to the end */
+    ::madvise(mapping, size_, MADV_SEQUENTIAL);
+    data_ = static_cast<const uint8_t*>(mapping);
+  }
+
+  /* the mapping stays valid without the descriptor */
+  ::close(file);
+}
+
+MappedFile::~MappedFile() {
+  unmap();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0u)) {
+}
+
+MappedFile& MappedFile::operator= (MappedFile&& other) noexcept {
+  if (this != &other) {
+    unmap();
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0u);
+  }
+
+  return *this;
+}
+
+void MappedFile::unmap() {
+  if (data_) {
+    ::munmap(const_cast<uint8_t*>(data_), size_);
+    data_ = nullptr;
+    size_ = 0u;
+  }
+}
+
+} // namespace conv
@@ -0,0 +1,179 @@
+#include "NativeMesh.h"
+#include "Hash.h"
+#include "Parallel.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+
+namespace conv {
+
+/* number of faces checked or copied by one task */
+constexpr size_t NATIVE_BLOCK_SIZE = 16384u;
+
+static_assert(sizeof(glm::dvec4) == 4u * sizeof(double) && sizeof(glm::dvec3) == 3u * sizeof(double),
+              "the sections of the .3dfc format are images of tightly packed vectors");
+
+NativeMesh::NativeMesh(const std::string& pathToFile) : file_(std::in_place, pathToFile) {
+  open(file_->data(), file_->size());
+}
+
+NativeMesh::NativeMesh(const uint8_t* bytes, size_t size) {
+  open(bytes, size);
+}
+
+size_t NativeMesh::elementSize(NativeSection section) {
+  switch (section) {
+    case NATIVE_SECTION_GEOMETRIC_VERTICES:
+      return sizeof(glm::dvec4);
+    case NATIVE_SECTION_TEXTURE_VERTICES:
+    case NATIVE_SECTION_VERTEX_NORMALS:
+      return sizeof(glm::dvec3);
+    case NATIVE_SECTION_GEOMETRIC_OFFSETS:
+    case NATIVE_SECTION_TEXTURE_OFFSETS:
+    case NATIVE_SECTION_NORMAL_OFFSETS:
+      return sizeof(uint64_t);
+    default:
+      return sizeof(uint32_t);
+  }
+}
+
+void NativeMesh::open(const uint8_t* bytes, size_t size) {
+  /* the sections are aligned within the file, the arrays only if the file starts at an aligned address */
+  const size_t misalignment = reinterpret_cast<uintptr_t>(bytes) % NATIVE_SECTION_ALIGNMENT;
+  if (0u != misalignment) {
+    copy_.resize(size + NATIVE_SECTION_ALIGNMENT);
+    const size_t padding = (NATIVE_SECTION_ALIGNMENT - reinterpret_cast<uintptr_t>(copy_.data()) % NATIVE_SECTION_ALIGNMENT) %
+                           NATIVE_SECTION_ALIGNMENT;
+    std::memcpy(copy_.data() + padding, bytes, size);
+    bytes = copy_.data() + padding;
+  }
+
+  if (size < sizeof(NativeHeader) || std::memcmp(bytes, NATIVE_MAGIC, sizeof(NATIVE_MAGIC)) != 0) {
+    throw std::runtime_error("Not a .3dfc file");
+  }
+
+  std::memcpy(&header_, bytes, sizeof(header_));
+  if (header_.byteOrderMark != NATIVE_BYTE_ORDER_MARK) {
+    throw std::runtime_error(".3dfc file of a different byte order");
+  }
+  if (header_.version != NATIVE_VERSION) {
+    throw std::runtime_error("Unsupported .3dfc version: " + std::to_string(header_.version));
+  }
+  if (header_.checksum != hash64(bytes, offsetof(NativeHeader, checksum))) {
+    throw std::runtime_error("Corrupted .3dfc header");
+  }
+
+  /* every section lies in the file at an aligned position */
+  for (uint32_t s = 0u; s < NATIVE_NUM_OF_SECTIONS; ++s) {
+    const NativeSectionEntry& entry = header_.sections[s];
+    const uint64_t maxCount = (entry.offset <= size) ? (size - entry.offset) / elementSize(static_cast<NativeSection>(s)) : 0u;
+    if (entry.offset % NATIVE_SECTION_ALIGNMENT != 0u || entry.offset < sizeof(NativeHeader) || entry.count > maxCount) {
+      throw std::runtime_error("Truncated .3dfc file");
+    }
+  }
+
+  /* every face has an offset of 8 bytes in the file (checked first, so numOfFaces + 1 cannot wrap around) */
+  if (header_.numOfFaces >= size / sizeof(uint64_t)) {
+    throw std::runtime_error("Invalid number of faces in .3dfc file");
+  }
+
+  /* the geometric references are required, the other kinds are optional */
+  for (NativeSection kind : {NATIVE_SECTION_GEOMETRIC_OFFSETS, NATIVE_SECTION_TEXTURE_OFFSETS, NATIVE_SECTION_NORMAL_OFFSETS}) {
+    const uint64_t count = header_.sections[kind].count;
+    const bool isOptional = (kind != NATIVE_SECTION_GEOMETRIC_OFFSETS);
+    if (count != header_.numOfFaces + 1u && !(isOptional && 0u == count)) {
+      throw std::runtime_error("Invalid number of face offsets in .3dfc file");
+    }
+  }
+
+  bytes_ = bytes;
+  size_ = size;
+}
+
+void NativeMesh::verify(const Progress& progress) const {
+  std::atomic<bool> isValid{true};
+  parallelFor(NATIVE_NUM_OF_SECTIONS, 1u, [&](size_t begin, size_t end) {
+    for (size_t s = begin; s < end; ++s) {
+      progress.checkCancelled();
+      const NativeSectionEntry& entry = header_.sections[s];
+      const size_t sizeInBytes = static_cast<size_t>(entry.count) * elementSize(static_cast<NativeSection>(s));
+      if (hash64(bytes_ + entry.offset, sizeInBytes) != entry.checksum) {
+        isValid = false;
+      }
+    }
+  });
+  if (!isValid) {
+    throw std::runtime_error("Corrupted .3dfc section");
+  }
+  progress.update(0.5);
+
+  /* the offsets grow up to the number of references, which point to existing values (1-based) */
+  const size_t numOfValues[] = {geometricVertices().size, textureVertices().size, vertexNormals().size};
+  const NativeSection kinds[] = {NATIVE_SECTION_GEOMETRIC_OFFSETS, NATIVE_SECTION_TEXTURE_OFFSETS, NATIVE_SECTION_NORMAL_OFFSETS};
+  for (size_t k = 0u; k < 3u; ++k) {
+    const NativeArray<uint64_t> faceOffsets = offsets(kinds[k]);
+    const NativeArray<uint32_t> faceReferences = references(kinds[k]);
+    if (0u == faceOffsets.size) {
+      continue;
+    }
+    if (faceOffsets[0] != 0u || faceOffsets[faceOffsets.size - 1u] != faceReferences.size) {
+      throw std::runtime_error("Invalid face offsets in .3dfc file");
+    }
+
+    parallelFor(numOfFaces(), NATIVE_BLOCK_SIZE, [&](size_t begin, size_t end) {
+      for (size_t f = begin; f < end && isValid; ++f) {
+        if (faceOffsets[f] > faceOffsets[f + 1u]) {
+          isValid = false;
+        }
+      }
+    });
+    parallelFor(faceReferences.size, NATIVE_BLOCK_SIZE, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end && isValid; ++i) {
+        if (0u == faceReferences[i] || faceReferences[i] > numOfValues[k]) {
+          isValid = false;
+        }
+      }
+    });
+    if (!isValid) {
+      throw std::runtime_error("Invalid face references in .3dfc file");
+    }
+  }
+  progress.update(1.0);
+}
+
+void NativeMesh::copyTo(MeshData& data, const Progress& progress) const {
+  data.geometricVertices.assign(geometricVertices().begin(), geometricVertices().end());
+  data.textureVertices.assign(textureVertices().begin(), textureVertices().end());
+  data.vertexNormals.assign(vertexNormals().begin(), vertexNormals().end());
+  progress.checkCancelled();
+
+  const std::pair<NativeSection, std::vector<uint32_t> Face::*> kinds[] = {
+      {NATIVE_SECTION_GEOMETRIC_OFFSETS, &Face::geometricVertexReferences},
+      {NATIVE_SECTION_TEXTURE_OFFSETS, &Face::textureVertexReferences},
+      {NATIVE_SECTION_NORMAL_OFFSETS, &Face::vertexNormalReferences}};
+
+  data.faces.resize(numOfFaces());
+  parallelFor(numOfFaces(), NATIVE_BLOCK_SIZE, [&](size_t begin, size_t end) {
+    progress.checkCancelled();
+    for (const auto& kind : kinds) {
+      const NativeArray<uint64_t> faceOffsets = offsets(kind.first);
+      const NativeArray<uint32_t> faceReferences = references(kind.first);
+      if (0u == faceOffsets.size) {
+        continue;
+      }
+
+      for (size_t f = begin; f < end; ++f) {
+        (data.faces[f].*kind.second).assign(faceReferences.begin() + faceOffsets[f], faceReferences.begin() + faceOffsets[f + 1u]);
+      }
+    }
+  });
+  progress.update(0.5);
+
+  data.updateTriangles();
+  progress.update(1.0);
+}
+
+} // namespace conv
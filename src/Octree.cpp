@@ -0,0 +1,282 @@
+#include "Octree.h"
+#include "Parallel.h"
+
+#include <queue>
+
+
+namespace conv {
+
+/* bits per axis of the quantized positions (3 * 21 bits fit into a 64 bit Morton code) */
+constexpr uint32_t MORTON_BITS = 21u;
+constexpr uint32_t OCTREE_LEAF_SIZE = 16u;
+constexpr size_t OCTREE_BLOCK_SIZE = 16384u;
+constexpr size_t QUERY_BLOCK_SIZE = 64u;
+
+namespace {
+
+/* function to spread the lower 21 bits of the value to every third bit */
+uint64_t spreadBits(uint64_t value) {
+  value &= 0x1FFFFFu;
+  value = (value | (value << 32u)) & 0x001F00000000FFFFu;
+  value = (value | (value << 16u)) & 0x001F0000FF0000FFu;
+  value = (value | (value << 8u)) & 0x100F00F00F00F00Fu;
+  value = (value | (value << 4u)) & 0x10C30C30C30C30C3u;
+  value = (value | (value << 2u)) & 0x1249249249249249u;
+  return value;
+}
+
+/* function to calculate the squared distance of a point from a box (0 inside) */
+double squaredDistanceToBox(const glm::dvec3& point, const glm::dvec3& boundsMin, const glm::dvec3& boundsMax) {
+  glm::dvec3 d = glm::max(glm::max(boundsMin - point, point - boundsMax), glm::dvec3(0.0));
+  return glm::dot(d, d);
+}
+
+/* ordering of the query results: by distance, then by vertex index for equal distances */
+bool closerThan(const VertexNeighbour& a, const VertexNeighbour& b) {
+  return (a.squaredDistance < b.squaredDistance) ||
+         (a.squaredDistance == b.squaredDistance && a.vertex < b.vertex);
+}
+
+} // namespace
+
+VertexOctree::VertexOctree(const std::vector<glm::dvec4>& vertices) {
+  if (vertices.empty()) {
+    return;
+  }
+
+  if (vertices.size() >= std::numeric_limits<uint32_t>::max()) {
+    throw std::length_error("Too many vertices for the octree");
+  }
+
+  /* quantize the positions in the bounding cube of the vertices */
+  glm::dvec3 boundsMin(vertices[0]);
+  glm::dvec3 boundsMax(vertices[0]);
+  for (const auto& v : vertices) {
+    boundsMin = glm::min(boundsMin, glm::dvec3(v));
+    boundsMax = glm::max(boundsMax, glm::dvec3(v));
+  }
+  glm::dvec3 extent = boundsMax - boundsMin;
+  double size = std::max(extent.x, std::max(extent.y, extent.z));
+  const double cells = static_cast<double>(1u << MORTON_BITS);
+  const double scale = (size > 0.0) ? (cells / size) : 0.0;
+
+  /* Morton codes of the vertices, tagged with the vertex index */
+  std::vector<std::pair<uint64_t, uint32_t>> keys(vertices.size());
+  parallelFor(vertices.size(), OCTREE_BLOCK_SIZE, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      glm::dvec3 cell = (glm::dvec3(vertices[i]) - boundsMin) * scale;
+      uint64_t code = 0u;
+      for (glm::length_t axis = 0; axis < 3; ++axis) {
+        uint64_t q = static_cast<uint64_t>(std::min(cell[axis], cells - 1.0));
+        code |= spreadBits(q) << (2u - axis);
+      }
+      keys[i] = {code, static_cast<uint32_t>(i)};
+    }
+  });
+
+  /* sort the blocks in parallel, then merge them pairwise */
+  parallelFor(keys.size(), OCTREE_BLOCK_SIZE, [&](size_t begin, size_t end) {
+    std::sort(keys.begin() + begin, keys.begin() + end);
+  });
+  for (size_t width = OCTREE_BLOCK_SIZE; width < keys.size(); width *= 2u) {
+    const size_t numOfMerges = (keys.size() + 2u * width - 1u) / (2u * width);
+    parallelFor(numOfMerges, 1u, [&](size_t begin, size_t end) {
+      for (size_t m = begin; m < end; ++m) {
+        size_t first = m * 2u * width;
+        size_t middle = std::min(keys.size(), first + width);
+        size_t last = std::min(keys.size(), first + 2u * width);
+        std::inplace_merge(keys.begin() + first, keys.begin() + middle, keys.begin() + last);
+      }
+    });
+  }
+
+  codes_.resize(keys.size());
+  vertexIds_.resize(keys.size());
+  positions_.resize(keys.size());
+  parallelFor(keys.size(), OCTREE_BLOCK_SIZE, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      codes_[i] = keys[i].first;
+      vertexIds_[i] = keys[i].second;
+      positions_[i] = glm::dvec3(vertices[keys[i].second]);
+    }
+  });
+
+  /* build the tree top down over the sorted ranges */
+  OctreeNode root;
+  root.first = 0u;
+  root.count = static_cast<uint32_t>(keys.size());
+  nodes_.emplace_back(root);
+  build(0u, 0u);
+}
+
+void VertexOctree::build(uint32_t nodeIndex, uint32_t depth) {
+  const uint32_t first = nodes_[nodeIndex].first;
+  const uint32_t count = nodes_[nodeIndex].count;
+
+  if (count <= OCTREE_LEAF_SIZE || depth == MORTON_BITS) {
+    glm::dvec3 boundsMin = positions_[first];
+    glm::dvec3 boundsMax = positions_[first];
+    for (uint32_t i = first + 1u; i < first + count; ++i) {
+      boundsMin = glm::min(boundsMin, positions_[i]);
+      boundsMax = glm::max(boundsMax, positions_[i]);
+    }
+    nodes_[nodeIndex].boundsMin = boundsMin;
+    nodes_[nodeIndex].boundsMax = boundsMax;
+    return;
+  }
+
+  /* the codes of the node share their upper 3 * depth bits, the next 3 bits select the child */
+  const uint32_t shift = 3u * (MORTON_BITS - depth - 1u);
+  auto octantOf = [shift](uint64_t code) {
+    return static_cast<uint32_t>((code >> shift) & 7u);
+  };
+
+  std::vector<OctreeNode> children;
+  uint32_t begin = first;
+  while (begin < first + count) {
+    uint32_t octant = octantOf(codes_[begin]);
+    auto end = std::partition_point(codes_.begin() + begin, codes_.begin() + first + count,
+                                    [&](uint64_t code) { return octantOf(code) == octant; });
+
+    OctreeNode child;
+    child.first = begin;
+    child.count = static_cast<uint32_t>(end - codes_.begin()) - begin;
+    children.emplace_back(child);
+    begin += child.count;
+  }
+
+  /* all vertices in one octant: the node gets a single child */
+  const uint32_t firstChild = static_cast<uint32_t>(nodes_.size());
+  nodes_[nodeIndex].firstChild = firstChild;
+  nodes_[nodeIndex].numOfChildren = static_cast<uint32_t>(children.size());
+  nodes_.insert(nodes_.end(), children.begin(), children.end());
+
+  glm::dvec3 boundsMin(std::numeric_limits<double>::max());
+  glm::dvec3 boundsMax(std::numeric_limits<double>::lowest());
+  for (uint32_t c = 0u; c < children.size(); ++c) {
+    build(firstChild + c, depth + 1u);
+    boundsMin = glm::min(boundsMin, nodes_[firstChild + c].boundsMin);
+    boundsMax = glm::max(boundsMax, nodes_[firstChild + c].boundsMax);
+  }
+  nodes_[nodeIndex].boundsMin = boundsMin;
+  nodes_[nodeIndex].boundsMax = boundsMax;
+}
+
+std::vector<VertexNeighbour> VertexOctree::withinRadius(const glm::dvec3& point, double radius) const {
+  std::vector<VertexNeighbour> result;
+  if (nodes_.empty() || radius < 0.0) {
+    return result;
+  }
+
+  const double squaredRadius = radius * radius;
+
+  std::vector<uint32_t> stack;
+  stack.reserve(64u);
+  stack.emplace_back(0u);
+
+  while (!stack.empty()) {
+    const OctreeNode& node = nodes_[stack.back()];
+    stack.pop_back();
+
+    if (squaredDistanceToBox(point, node.boundsMin, node.boundsMax) > squaredRadius) {
+      continue;
+    }
+
+    if (0u != node.numOfChildren) {
+      for (uint32_t c = 0u; c < node.numOfChildren; ++c) {
+        stack.emplace_back(node.firstChild + c);
+      }
+      continue;
+    }
+
+    for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+      glm::dvec3 d = positions_[i] - point;
+      double squaredDistance = glm::dot(d, d);
+      if (squaredDistance <= squaredRadius) {
+        result.push_back({vertexIds_[i], squaredDistance});
+      }
+    }
+  }
+
+  std::sort(result.begin(), result.end(), closerThan);
+
+  return result;
+}
+
+std::vector<VertexNeighbour> VertexOctree::nearest(const glm::dvec3& point, size_t k) const {
+  std::vector<VertexNeighbour> result;
+  if (nodes_.empty() || 0u == k) {
+    return result;
+  }
+
+  /* the k best candidates so far, the worst one on top */
+  std::priority_queue<VertexNeighbour, std::vector<VertexNeighbour>, decltype(&closerThan)> best(closerThan);
+
+  /* nodes to visit, ordered by their distance from the point (closest on top) */
+  using Entry = std::pair<double, uint32_t>;
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+  queue.emplace(squaredDistanceToBox(point, nodes_[0].boundsMin, nodes_[0].boundsMax), 0u);
+
+  while (!queue.empty()) {
+    Entry entry = queue.top();
+    queue.pop();
+
+    /* every remaining node is farther than the k-th candidate */
+    if (best.size() == k && entry.first > best.top().squaredDistance) {
+      break;
+    }
+
+    const OctreeNode& node = nodes_[entry.second];
+    if (0u != node.numOfChildren) {
+      for (uint32_t c = 0u; c < node.numOfChildren; ++c) {
+        const OctreeNode& child = nodes_[node.firstChild + c];
+        queue.emplace(squaredDistanceToBox(point, child.boundsMin, child.boundsMax), node.firstChild + c);
+      }
+      continue;
+    }
+
+    for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+      glm::dvec3 d = positions_[i] - point;
+      VertexNeighbour candidate{vertexIds_[i], glm::dot(d, d)};
+      if (best.size() < k) {
+        best.push(candidate);
+      } else if (closerThan(candidate, best.top())) {
+        best.pop();
+        best.push(candidate);
+      }
+    }
+  }
+
+  result.resize(best.size());
+  for (size_t i = result.size(); i > 0u; --i) {
+    result[i - 1u] = best.top();
+    best.pop();
+  }
+
+  return result;
+}
+
+std::vector<std::vector<VertexNeighbour>> VertexOctree::withinRadius(const std::vector<glm::dvec3>& points,
+                                                                     double radius) const {
+  std::vector<std::vector<VertexNeighbour>> result(points.size());
+  parallelFor(points.size(), QUERY_BLOCK_SIZE, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      result[i] = withinRadius(points[i], radius);
+    }
+  });
+
+  return result;
+}
+
+std::vector<std::vector<VertexNeighbour>> VertexOctree::nearest(const std::vector<glm::dvec3>& points, size_t k) const {
+  std::vector<std::vector<VertexNeighbour>> result(points.size());
+  parallelFor(points.size(), QUERY_BLOCK_SIZE, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      result[i] = nearest(points[i], k);
+    }
+  });
+
+  return result;
+}
+
+} // namespace conv
@@ -0,0 +1,196 @@
+#include "Predicates.h"
+
+
+namespace conv {
+
+/* half an ulp of 1.0 (the relative rounding error of a single operation) */
+constexpr double ROUNDOFF_EPSILON = std::numeric_limits<double>::epsilon() * 0.5;
+
+/* error bound of the floating-point orientation determinant relative to its permanent */
+constexpr double ORIENT3D_ERROR_BOUND = (7.0 + 56.0 * ROUNDOFF_EPSILON) * ROUNDOFF_EPSILON;
+
+namespace {
+
+/*
+ * floating-point expansion: sum of non-overlapping components ordered by increasing magnitude
+ * the most significant (last) component carries the sign of the represented value
+ */
+using Expansion = std::vector<double>;
+
+/* x + y == a + b exactly, x = fl(a + b) */
+inline void twoSum(double a, double b, double& x, double& y) {
+  x = a + b;
+  double bVirtual = x - a;
+  double aVirtual = x - bVirtual;
+  y = (a - aVirtual) + (b - bVirtual);
+}
+
+/* x + y == a - b exactly, x = fl(a - b) */
+inline void twoDiff(double a, double b, double& x, double& y) {
+  x = a - b;
+  double bVirtual = a - x;
+  double aVirtual = x + bVirtual;
+  y = (a - aVirtual) + (bVirtual - b);
+}
+
+/* x + y == a * b exactly, x = fl(a * b) (the fused multiply-add is exact by definition) */
+inline void twoProduct(double a, double b, double& x, double& y) {
+  x = a * b;
+  y = std::fma(a, b, -x);
+}
+
+/* function to add a single value to an expansion (grow-expansion, zero components eliminated) */
+Expansion growExpansion(const Expansion& e, double b) {
+  Expansion h;
+  h.reserve(e.size() + 1u);
+
+  double q = b;
+  for (const auto component : e) {
+    double error = 0.0;
+    twoSum(q, component, q, error);
+    if (0.0 != error) {
+      h.emplace_back(error);
+    }
+  }
+  if (0.0 != q || h.empty()) {
+    h.emplace_back(q);
+  }
+
+  return h;
+}
+
+/* function to add two expansions */
+Expansion sumExpansions(const Expansion& e, const Expansion& f) {
+  Expansion h = e;
+  for (const auto component : f) {
+    h = growExpansion(h, component);
+  }
+
+  return h;
+}
+
+/* function to multiply an expansion by a single value (scale-expansion, zero components eliminated) */
+Expansion scaleExpansion(const Expansion& e, double b) {
+  Expansion h;
+  h.reserve(2u * e.size());
+
+  double q = 0.0;
+  double error = 0.0;
+  twoProduct(e[0], b, q, error);
+  if (0.0 != error) {
+    h.emplace_back(error);
+  }
+
+  for (size_t i = 1u; i < e.size(); ++i) {
+    double productHigh = 0.0;
+    double productLow = 0.0;
+    double sum = 0.0;
+    twoProduct(e[i], b, productHigh, productLow);
+    twoSum(q, productLow, sum, error);
+    if (0.0 != error) {
+      h.emplace_back(error);
+    }
+    /* |productHigh| >= |sum|, so the fast variant of two-sum is exact */
+    q = productHigh + sum;
+    error = sum - (q - productHigh);
+    if (0.0 != error) {
+      h.emplace_back(error);
+    }
+  }
+  if (0.0 != q || h.empty()) {
+    h.emplace_back(q);
+  }
+
+  return h;
+}
+
+/* function to multiply two expansions */
+Expansion multiplyExpansions(const Expansion& e, const Expansion& f) {
+  Expansion h{0.0};
+  for (const auto component : f) {
+    h = sumExpansions(h, scaleExpansion(e, component));
+  }
+
+  return h;
+}
+
+/* function to negate an expansion */
+Expansion negateExpansion(Expansion e) {
+  for (auto& component : e) {
+    component = -component;
+  }
+
+  return e;
+}
+
+/* function to get the exact difference a - b as an expansion */
+Expansion difference(double a, double b) {
+  double x = 0.0;
+  double y = 0.0;
+  twoDiff(a, b, x, y);
+
+  return (0.0 != y) ? Expansion{y, x} : Expansion{x};
+}
+
+/* function to get the sign of an expansion */
+int8_t signOf(const Expansion& e) {
+  for (auto it = e.rbegin(); it != e.rend(); ++it) {
+    if (0.0 != *it) {
+      return (*it > 0.0) ? 1 : -1;
+    }
+  }
+
+  return 0;
+}
+
+/* function to evaluate the orientation determinant with expansions (exact) */
+int8_t orient3dExact(const glm::dvec3& a, const glm::dvec3& b, const glm::dvec3& c, const glm::dvec3& d) {
+  std::array<Expansion, 3> u = {difference(b.x, a.x), difference(b.y, a.y), difference(b.z, a.z)};
+  std::array<Expansion, 3> v = {difference(c.x, a.x), difference(c.y, a.y), difference(c.z, a.z)};
+  std::array<Expansion, 3> w = {difference(d.x, a.x), difference(d.y, a.y), difference(d.z, a.z)};
+
+  /* det = u.x * (v.y * w.z - v.z * w.y) + u.y * (v.z * w.x - v.x * w.z) + u.z * (v.x * w.y - v.y * w.x) */
+  Expansion det{0.0};
+  for (size_t i = 0u; i < 3u; ++i) {
+    size_t j = (i + 1u) % 3u;
+    size_t k = (i + 2u) % 3u;
+    Expansion minor = sumExpansions(multiplyExpansions(v[j], w[k]), negateExpansion(multiplyExpansions(v[k], w[j])));
+    det = sumExpansions(det, multiplyExpansions(u[i], minor));
+  }
+
+  return signOf(det);
+}
+
+} // namespace
+
+int8_t orient3d(const glm::dvec3& a, const glm::dvec3& b, const glm::dvec3& c, const glm::dvec3& d) {
+  glm::dvec3 u = b - a;
+  glm::dvec3 v = c - a;
+  glm::dvec3 w = d - a;
+
+  double vywz = v.y * w.z;
+  double vzwy = v.z * w.y;
+  double vzwx = v.z * w.x;
+  double vxwz = v.x * w.z;
+  double vxwy = v.x * w.y;
+  double vywx = v.y * w.x;
+
+  double det = u.x * (vywz - vzwy) + u.y * (vzwx - vxwz) + u.z * (vxwy - vywx);
+
+  /* fast path: the rounding error cannot change the sign */
+  double permanent = (std::fabs(vywz) + std::fabs(vzwy)) * std::fabs(u.x) +
+                     (std::fabs(vzwx) + std::fabs(vxwz)) * std::fabs(u.y) +
+                     (std::fabs(vxwy) + std::fabs(vywx)) * std::fabs(u.z);
+  double errorBound = ORIENT3D_ERROR_BOUND * permanent;
+  if (det > errorBound) {
+    return 1;
+  }
+  if (-det > errorBound) {
+    return -1;
+  }
+
+  /* nearly degenerate configuration: evaluate exactly */
+  return orient3dExact(a, b, c, d);
+}
+
+} // namespace conv
@@ -0,0 +1,86 @@
+#include "ReadEdgebreaker.h"
+#include "Edgebreaker.h"
+#include "Entropy.h"
+#include "MappedFile.h"
+#include "Parallel.h"
+
+#include <cstring>
+
+
+namespace conv {
+
+/* number of vertices or faces built by one task */
+constexpr size_t EDGEBREAKER_BUILD_BLOCK_SIZE = 16384u;
+
+void ReadEdgebreaker::read(const std::string& pathToFile, MeshData& data, const Progress& progress) {
+  /* the file is decoded straight from its mapping */
+  MappedFile file(pathToFile);
+  read(file.data(), file.size(), data, progress);
+}
+
+void ReadEdgebreaker::read(const uint8_t* bytes, size_t size, MeshData& data, const Progress& progress) {
+  EdgebreakerHeader header;
+  if (size < sizeof(header) || std::memcmp(bytes, EDGEBREAKER_MAGIC, sizeof(EDGEBREAKER_MAGIC)) != 0) {
+    throw std::runtime_error("Not a .3dfe file");
+  }
+
+  std::memcpy(&header, bytes, sizeof(header));
+  if (header.byteOrderMark != EDGEBREAKER_BYTE_ORDER_MARK) {
+    throw std::runtime_error(".3dfe file of a different byte order");
+  }
+  if (header.version != EDGEBREAKER_VERSION) {
+    throw std::runtime_error("Unsupported .3dfe version: " + std::to_string(header.version));
+  }
+
+  /* the sections follow the header */
+  const uint64_t available = size - sizeof(header);
+  if (header.encodedSymbolsSize > available || header.encodedIndicesSize > available - header.encodedSymbolsSize ||
+      header.encodedPositionsSize != available - header.encodedSymbolsSize - header.encodedIndicesSize) {
+    throw std::runtime_error("Invalid size of .3dfe file");
+  }
+  if (header.numOfVertices >= std::numeric_limits<uint32_t>::max() || header.numOfTriangles > header.numOfSymbols) {
+    throw std::runtime_error("Invalid .3dfe header");
+  }
+  progress.update(0.0);
+
+  const uint8_t* section = bytes + sizeof(header);
+  const std::vector<uint8_t> symbols = entropyDecode(section, static_cast<size_t>(header.encodedSymbolsSize),
+                                                     static_cast<size_t>(header.numOfSymbols));
+  section += header.encodedSymbolsSize;
+  const std::vector<uint8_t> indices = entropyDecode(section, static_cast<size_t>(header.encodedIndicesSize),
+                                                     static_cast<size_t>(header.sizeOfIndices));
+  section += header.encodedIndicesSize;
+  const std::vector<uint8_t> positions = entropyDecode(section, static_cast<size_t>(header.encodedPositionsSize),
+                                                       static_cast<size_t>(header.numOfVertices) * 3u * sizeof(double));
+  if (symbols.size() != header.numOfSymbols || positions.size() != header.numOfVertices * 3u * sizeof(double)) {
+    throw std::runtime_error("Invalid sections of .3dfe file");
+  }
+  progress.update(0.3);
+
+  const std::vector<std::array<uint32_t, 3>> triangles =
+      decodeConnectivity(symbols.data(), symbols.size(), indices.data(), indices.size(),
+                         static_cast<size_t>(header.numOfTriangles), static_cast<size_t>(header.numOfVertices));
+  progress.update(0.6);
+
+  data.geometricVertices.resize(static_cast<size_t>(header.numOfVertices));
+  parallelFor(data.geometricVertices.size(), EDGEBREAKER_BUILD_BLOCK_SIZE, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      double position[3];
+      std::memcpy(position, positions.data() + i * sizeof(position), sizeof(position));
+      data.geometricVertices[i] = glm::dvec4(position[0], position[1], position[2], 1.0);
+    }
+  });
+
+  data.faces.resize(triangles.size());
+  parallelFor(triangles.size(), EDGEBREAKER_BUILD_BLOCK_SIZE, [&](size_t begin, size_t end) {
+    progress.checkCancelled();
+    for (size_t i = begin; i < end; ++i) {
+      data.faces[i].geometricVertexReferences = {triangles[i][0] + 1u, triangles[i][1] + 1u, triangles[i][2] + 1u};
+    }
+  });
+
+  data.updateTriangles();
+  progress.update(1.0);
+}
+
+} // namespace conv
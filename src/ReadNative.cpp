@@ -0,0 +1,22 @@
+#include "ReadNative.h"
+#include "MappedFile.h"
+#include "NativeMesh.h"
+
+
+namespace conv {
+
+void ReadNative::read(const std::string& pathToFile, MeshData& data, const Progress& progress) {
+  /* the file is copied straight from its mapping */
+  MappedFile file(pathToFile);
+  read(file.data(), file.size(), data, progress);
+}
+
+void ReadNative::read(const uint8_t* bytes, size_t size, MeshData& data, const Progress& progress) {
+  progress.update(0.0);
+
+  const NativeMesh mesh(bytes, size);
+  mesh.verify(progress.part(0.0, 0.3));
+  mesh.copyTo(data, progress.part(0.3, 1.0));
+}
+
+} // namespace conv
@@ -1,141 +1,224 @@
 #include "ReadObj.h"
-#include "Utils.h"
+#include "MappedFile.h"
+#include "Parallel.h"
+#include "TextParser.h"
 
 namespace conv {
 
-void ReadObj::read(const std::string& pathToFile, MeshData& data) {
-  if (pathToFile.empty()) {
-    throw std::invalid_argument(std::string("No path to the input file: ") + pathToFile);
+/* number of bytes parsed by one task (the blocks are extended to the end of their last line) */
+constexpr size_t PARSE_BLOCK_SIZE = 1u << 20u;
+
+namespace {
+
+/* enum for the reference lists of a face */
+enum ReferenceType : uint8_t {
+  REFERENCE_TYPE_GEOMETRIC_VERTEX = 0u,
+  REFERENCE_TYPE_TEXTURE_VERTEX,
+  REFERENCE_TYPE_VERTEX_NORMAL
+};
+
+/*
+ * negative (or zero) index of a face, counted back from the last vertex read so far
+ * it is stored relative to the start of its block and gets the number of vertices of the
+ * previous blocks added when the blocks are merged (modulo 2^32, so it may point before the block)
+ */
+struct RelativeReference {
+  uint32_t face = 0u;
+  uint32_t slot = 0u;
+  ReferenceType type = REFERENCE_TYPE_GEOMETRIC_VERTEX;
+};
+
+/* data parsed from one block of the file */
+struct ObjBlock {
+  std::vector<glm::dvec4> geometricVertices;
+  std::vector<glm::dvec3> textureVertices;
+  std::vector<glm::dvec3> vertexNormals;
+  std::vector<Face> faces;
+  std::vector<RelativeReference> relativeReferences;
+};
+
+/* function to add a reference of the face, negative indices are resolved within the block */
+void addReference(int index, ReferenceType type, size_t numOfVertices, Face& f, ObjBlock& block) {
+  std::vector<uint32_t>& refs = (type == REFERENCE_TYPE_GEOMETRIC_VERTEX) ? f.geometricVertexReferences :
+                                (type == REFERENCE_TYPE_TEXTURE_VERTEX) ? f.textureVertexReferences :
+                                                                          f.vertexNormalReferences;
+
+  if (index > 0) {
+    refs.emplace_back(index);
+    return;
   }
 
-  std::ifstream file(pathToFile, std::ios::in);
-  if (!file.is_open()) {
-    throw std::runtime_error(std::string("Cannot open file for read: ") + pathToFile);
-  }
+  /* handle negative indices */
+  block.relativeReferences.push_back({static_cast<uint32_t>(block.faces.size()), static_cast<uint32_t>(refs.size()), type});
+  refs.emplace_back(static_cast<uint32_t>(index + numOfVertices + 1));
+}
 
-  /* parsing file line by line */
-  std::string input;
-  while (std::getline(file, input)) {
-    std::istringstream line(input);
-    std::string lineType;
-    line >> lineType;
-
-    /*
-     * geometric vertex
-     * v x y z (w)
-     */
-    if (lineType == "v") {
-      glm::dvec4 v{0.0, 0.0, 0.0, 1.0};
-      line >> v.x >> v.y >> v.z >> v.w;
-      data.geometricVertices.emplace_back(v);
+/* function to parse one line of the file */
+void parseLine(std::string_view line, ObjBlock& block) {
+  size_t pos = 0u;
+  const std::string_view lineType = nextWord(line, pos);
+
+  /*
+   * geometric vertex
+   * v x y z (w)
+   */
+  if (lineType == "v") {
+    glm::dvec4 v{0.0, 0.0, 0.0, 1.0};
+    for (glm::length_t i = 0; i < 4 && !isLineEnd(line, pos); ++i) {
+      v[i] = parseNumber(line, pos);
     }
+    block.geometricVertices.emplace_back(v);
+  }
 
-    /*
-     * texture vertex
-     * vt u v (w)
-     */
-    if (lineType == "vt") {
-      glm::dvec3 vt{0.0, 0.0, 0.0};
-      line >> vt.x >> vt.y >> vt.z;
-      data.textureVertices.emplace_back(vt);
+  /*
+   * texture vertex
+   * vt u v (w)
+   */
+  if (lineType == "vt") {
+    glm::dvec3 vt{0.0, 0.0, 0.0};
+    for (glm::length_t i = 0; i < 3 && !isLineEnd(line, pos); ++i) {
+      vt[i] = parseNumber(line, pos);
     }
+    block.textureVertices.emplace_back(vt);
+  }
 
-    /*
-     * vertex normal
-     * vn i j k
-     */
-    if (lineType == "vn") {
-      glm::dvec3 vn{0.0, 0.0, 0.0};
-      line >> vn.x >> vn.y >> vn.z;
-      data.vertexNormals.emplace_back(vn);
+  /*
+   * vertex normal
+   * vn i j k
+   */
+  if (lineType == "vn") {
+    glm::dvec3 vn{0.0, 0.0, 0.0};
+    for (glm::length_t i = 0; i < 3 && !isLineEnd(line, pos); ++i) {
+      vn[i] = parseNumber(line, pos);
     }
+    block.vertexNormals.emplace_back(vn);
+  }
 
-    /*
-     * face
-     * f v
-     * f v/vt
-     * f v//vn
-     * f v/vt/vn
-     */
-    if (lineType == "f") {
-      std::string faceType;
-      std::string tmp;
-      while (line >> tmp) {
-        faceType += (tmp + " ");
+  /*
+   * face
+   * f v
+   * f v/vt
+   * f v//vn
+   * f v/vt/vn
+   */
+  if (lineType == "f") {
+    Face f;
+    const size_t numOfGeometricVertices = block.geometricVertices.size();
+    const size_t numOfTextureVertices = block.textureVertices.size();
+    const size_t numOfVertexNormals = block.vertexNormals.size();
+
+    while (!isLineEnd(line, pos)) {
+      addReference(static_cast<int>(parseInteger(line, pos)), REFERENCE_TYPE_GEOMETRIC_VERTEX, numOfGeometricVertices, f, block);
+      if (pos < line.size() && line[pos] == '/') {
+        ++pos;
+
+        /* nothing between // */
+        if (pos < line.size() && line[pos] != '/') {
+          addReference(static_cast<int>(parseInteger(line, pos)), REFERENCE_TYPE_TEXTURE_VERTEX, numOfTextureVertices, f, block);
+        }
+        if (pos < line.size() && line[pos] == '/') {
+          ++pos;
+          addReference(static_cast<int>(parseInteger(line, pos)), REFERENCE_TYPE_VERTEX_NORMAL, numOfVertexNormals, f, block);
+        }
       }
 
-      Face f;
-
-      /* split face parameters among spaces */
-      auto parameters = utils::split(faceType, ' ');
-      for (auto p : parameters) {
-        /* get the number of slashes */
-        auto occurrences = utils::findPosition(p, '/');
-        if (occurrences.empty()) {
-          /* case is v1 v2 v3 ... */
-          int v = std::stoi(p);
-
-          /* handle negative indices */
-          v = (v > 0) ? v : (v + data.geometricVertices.size() + 1);
-
-          f.geometricVertexReferences.emplace_back(v);
-
-          /* case is v1/vt1 v2/vt2 v3/vt3 ... */
-        } else if (occurrences.size() == 1u) {
-          auto refs = utils::split(p, '/');
-
-          /* handle negative indices */
-          int v = std::stoi(refs[0]);
-          int vt = std::stoi(refs[1]);
-          v = (v > 0) ? v : (v + data.geometricVertices.size() + 1);
-          vt = (vt > 0) ? vt : (vt + data.textureVertices.size() + 1);
-
-          f.geometricVertexReferences.emplace_back(v);
-          f.textureVertexReferences.emplace_back(vt);
-        } else {
-          /* distance between the positions of the slashes */
-          auto dist = occurrences[1] - occurrences[0];
-
-          /* case is v1//vn1 v2//vn2 v3//vn3 ... */
-          if (dist == 1u) {
-            auto refs = utils::split(p, '/');
-
-            /* handle negative indices */
-            /* refs[1] equals nothing between // */
-            int v = std::stoi(refs[0]);
-            int vn = std::stoi(refs[2]);
-            v = (v > 0) ? v : (v + data.geometricVertices.size() + 1);
-            vn = (vn > 0) ? vn : (vn + data.vertexNormals.size() + 1);
-
-            f.geometricVertexReferences.emplace_back(v);
-            f.vertexNormalReferences.emplace_back(vn);
-
-            /* case is v1/vt1/vn1 v2/vt2/vn2 v3/vt3/vn3 ... */
-          } else {
-            auto refs = utils::split(p, '/');
-
-            /* handle negative indices */
-            int v = std::stoi(refs[0]);
-            int vt = std::stoi(refs[1]);
-            int vn = std::stoi(refs[2]);
-            v = (v > 0) ? v : (v + data.geometricVertices.size() + 1);
-            vt = (vt > 0) ? vt : (vt + data.textureVertices.size() + 1);
-            vn = (vn > 0) ? vn : (vn + data.vertexNormals.size() + 1);
-
-            f.geometricVertexReferences.emplace_back(v);
-            f.textureVertexReferences.emplace_back(vt);
-            f.vertexNormalReferences.emplace_back(vn);
-          }
-        }
+      if (pos < line.size() && !isBlank(line[pos]) && line[pos] != '#') {
+        throw std::runtime_error("Invalid face in line: " + std::string(line));
       }
+    }
+
+    block.faces.emplace_back(f);
+  }
+}
 
-      data.faces.emplace_back(f);
+/* function to append the elements of the blocks to the target, offsets[i] is the position of block i */
+template <typename T, typename Member>
+void mergeBlocks(const std::vector<ObjBlock>& blocks, Member member, const std::vector<size_t>& offsets,
+                 std::vector<T>& target) {
+  target.resize(offsets.back());
+  parallelFor(blocks.size(), 1u, [&](size_t begin, size_t end) {
+    for (size_t b = begin; b < end; ++b) {
+      const std::vector<T>& source = blocks[b].*member;
+      std::copy(source.begin(), source.end(), target.begin() + offsets[b]);
     }
+  });
+}
+
+/* function to get the positions of the blocks' elements after the existing ones */
+template <typename Member>
+std::vector<size_t> blockOffsets(const std::vector<ObjBlock>& blocks, Member member, size_t numOfExisting) {
+  std::vector<size_t> offsets(blocks.size() + 1u, numOfExisting);
+  for (size_t b = 0u; b < blocks.size(); ++b) {
+    offsets[b + 1u] = offsets[b] + (blocks[b].*member).size();
   }
+  return offsets;
+}
+
+} // namespace
+
+void ReadObj::read(const std::string& pathToFile, MeshData& data, const Progress& progress) {
+  /* the file is parsed straight from its mapping, without copying it into a buffer */
+  MappedFile file(pathToFile);
+  read(file.data(), file.size(), data, progress);
+}
+
+void ReadObj::read(const uint8_t* bytes, size_t size, MeshData& data, const Progress& progress) {
+  /* the whole file is parsed in parallel blocks of lines */
+  const std::string_view content(reinterpret_cast<const char*>(bytes), size);
+  progress.update(0.0);
+
+  const std::vector<size_t> blockStarts = lineBlockStarts(content, PARSE_BLOCK_SIZE);
+
+  /* parsing blocks line by line (parsing takes most of the time, it is reported as 90 %) */
+  std::vector<ObjBlock> blocks(blockStarts.size() - 1u);
+  std::atomic<size_t> numOfParsedBytes{0u};
+  parallelFor(blocks.size(), 1u, [&](size_t begin, size_t end) {
+    for (size_t b = begin; b < end; ++b) {
+      progress.checkCancelled();
+
+      forEachLine(content.substr(blockStarts[b], blockStarts[b + 1u] - blockStarts[b]),
+                  [&](std::string_view line) { parseLine(line, blocks[b]); });
+
+      numOfParsedBytes += blockStarts[b + 1u] - blockStarts[b];
+      progress.update(0.9 * numOfParsedBytes / content.size());
+    }
+  });
+
+  /* merge the blocks in file order */
+  auto geometricOffsets = blockOffsets(blocks, &ObjBlock::geometricVertices, data.geometricVertices.size());
+  auto textureOffsets = blockOffsets(blocks, &ObjBlock::textureVertices, data.textureVertices.size());
+  auto normalOffsets = blockOffsets(blocks, &ObjBlock::vertexNormals, data.vertexNormals.size());
+  auto faceOffsets = blockOffsets(blocks, &ObjBlock::faces, data.faces.size());
+
+  mergeBlocks(blocks, &ObjBlock::geometricVertices, geometricOffsets, data.geometricVertices);
+  mergeBlocks(blocks, &ObjBlock::textureVertices, textureOffsets, data.textureVertices);
+  mergeBlocks(blocks, &ObjBlock::vertexNormals, normalOffsets, data.vertexNormals);
+
+  data.faces.resize(faceOffsets.back());
+  parallelFor(blocks.size(), 1u, [&](size_t begin, size_t end) {
+    for (size_t b = begin; b < end; ++b) {
+      for (const auto& r : blocks[b].relativeReferences) {
+        Face& f = blocks[b].faces[r.face];
+        switch (r.type) {
+        case REFERENCE_TYPE_GEOMETRIC_VERTEX:
+          f.geometricVertexReferences[r.slot] += static_cast<uint32_t>(geometricOffsets[b]);
+          break;
+        case REFERENCE_TYPE_TEXTURE_VERTEX:
+          f.textureVertexReferences[r.slot] += static_cast<uint32_t>(textureOffsets[b]);
+          break;
+        case REFERENCE_TYPE_VERTEX_NORMAL:
+          f.vertexNormalReferences[r.slot] += static_cast<uint32_t>(normalOffsets[b]);
+          break;
+        }
+      }
+
+      std::move(blocks[b].faces.begin(), blocks[b].faces.end(), data.faces.begin() + faceOffsets[b]);
+    }
+  });
 
   /* update triangles */
   data.updateTriangles();
+  progress.update(1.0);
 }
 
 } // namespace conv
-
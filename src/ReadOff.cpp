@@ -0,0 +1,235 @@
+#include "ReadOff.h"
+#include "MappedFile.h"
+#include "Parallel.h"
+#include "TextParser.h"
+
+#include <limits>
+
+namespace conv {
+
+/* number of bytes parsed by one task (the blocks are extended to the end of their last line) */
+constexpr size_t OFF_PARSE_BLOCK_SIZE = 1u << 20u;
+
+/* most numbers of a vertex line: x y z w, nx ny nz, r g b a, s t */
+constexpr size_t MAX_OFF_VERTEX_VALUES = 13u;
+
+/* fewest bytes of a vertex line ("0 0 0\n") and of a face line ("0\n"), to check the counts of the header */
+constexpr size_t MIN_OFF_VERTEX_SIZE_IN_BYTES = 6u;
+constexpr size_t MIN_OFF_FACE_SIZE_IN_BYTES = 2u;
+
+namespace {
+
+/* function to check whether the line holds data (it is not empty or a comment) */
+bool isDataLine(std::string_view line) {
+  size_t pos = 0u;
+  return !isLineEnd(line, pos);
+}
+
+} // namespace
+
+bool ReadOff::parseKeyword(std::string_view word, OffKeyword& keyword) {
+  keyword = OffKeyword();
+  if (word.substr(0u, 2u) == "ST") {
+    keyword.hasTexture = true;
+    word.remove_prefix(2u);
+  }
+  if (!word.empty() && word[0] == 'C') {
+    keyword.hasColor = true;
+    word.remove_prefix(1u);
+  }
+  if (!word.empty() && word[0] == 'N') {
+    keyword.hasNormal = true;
+    word.remove_prefix(1u);
+  }
+  if (!word.empty() && word[0] == '4') {
+    keyword.isHomogeneous = true;
+    word.remove_prefix(1u);
+  }
+
+  return word == "OFF";
+}
+
+void ReadOff::read(const std::string& pathToFile, MeshData& data, const Progress& progress) {
+  /* the file is parsed straight from its mapping */
+  MappedFile file(pathToFile);
+  read(file.data(), file.size(), data, progress);
+}
+
+void ReadOff::read(const uint8_t* bytes, size_t size, MeshData& data, const Progress& progress) {
+  const std::string_view content(reinterpret_cast<const char*>(bytes), size);
+  progress.update(0.0);
+
+  /* header: the keyword, then the numbers of vertices, faces and edges on the same or the next data line */
+  size_t lineStart = 0u;
+  auto nextDataLine = [&]() {
+    while (lineStart < content.size()) {
+      size_t lineEnd = content.find('\n', lineStart);
+      lineEnd = (lineEnd == std::string_view::npos) ? content.size() : lineEnd;
+
+      const std::string_view line = content.substr(lineStart, lineEnd - lineStart);
+      lineStart = std::min(content.size(), lineEnd + 1u);
+      if (isDataLine(line)) {
+        return line;
+      }
+    }
+    throw std::runtime_error("Unexpected end of .off header");
+  };
+
+  std::string_view line = nextDataLine();
+  size_t pos = 0u;
+  OffKeyword keyword;
+  if (!parseKeyword(nextWord(line, pos), keyword)) {
+    throw std::runtime_error("Not an .off file");
+  }
+  size_t next = pos;
+  if (nextWord(line, next) == "BINARY") {
+    throw std::runtime_error("Binary .off files are not supported");
+  }
+  if (isLineEnd(line, pos)) {
+    line = nextDataLine();
+    pos = 0u;
+  }
+
+  /* the number of edges is not used */
+  const int64_t numOfVertices = parseInteger(line, pos);
+  const int64_t numOfFaces = parseInteger(line, pos);
+  const std::string_view body = content.substr(lineStart);
+  if (numOfVertices < 0 || numOfFaces < 0 || static_cast<uint64_t>(numOfVertices) > body.size() ||
+      static_cast<uint64_t>(numOfFaces) > body.size() ||
+      numOfVertices * MIN_OFF_VERTEX_SIZE_IN_BYTES + numOfFaces * MIN_OFF_FACE_SIZE_IN_BYTES > body.size() + 1u) {
+    throw std::runtime_error("Invalid counts in .off header: " + std::string(line));
+  }
+  if (data.geometricVertices.size() + numOfVertices >= std::numeric_limits<uint32_t>::max()) {
+    throw std::runtime_error("Too many vertices in .off file");
+  }
+
+  /* count the data lines of every block (reported as 20 %) */
+  const std::vector<size_t> blockStarts = lineBlockStarts(body, OFF_PARSE_BLOCK_SIZE);
+  const size_t numOfBlocks = blockStarts.size() - 1u;
+  auto blockOf = [&](size_t b) { return body.substr(blockStarts[b], blockStarts[b + 1u] - blockStarts[b]); };
+
+  std::vector<size_t> firstLines(numOfBlocks + 1u, 0u);
+  parallelFor(numOfBlocks, 1u, [&](size_t begin, size_t end) {
+    for (size_t b = begin; b < end; ++b) {
+      progress.checkCancelled();
+      forEachLine(blockOf(b), [&](std::string_view l) { firstLines[b + 1u] += isDataLine(l) ? 1u : 0u; });
+    }
+  });
+  for (size_t b = 0u; b < numOfBlocks; ++b) {
+    firstLines[b + 1u] += firstLines[b];
+  }
+  if (firstLines.back() < static_cast<size_t>(numOfVertices + numOfFaces)) {
+    throw std::runtime_error("Unexpected end of .off file");
+  }
+  progress.update(0.2);
+
+  /* the arrays get their final sizes before parsing, the lines are parsed into their elements */
+  const size_t vertexOffset = data.geometricVertices.size();
+  const size_t normalOffset = data.vertexNormals.size();
+  const size_t textureOffset = data.textureVertices.size();
+  const size_t faceOffset = data.faces.size();
+  data.geometricVertices.resize(vertexOffset + numOfVertices);
+  if (keyword.hasNormal) {
+    data.vertexNormals.resize(normalOffset + numOfVertices);
+  }
+  if (keyword.hasTexture) {
+    data.textureVertices.resize(textureOffset + numOfVertices);
+  }
+  data.faces.resize(faceOffset + numOfFaces);
+
+  /* x y z (w) (nx ny nz) (colors) (s t) */
+  auto parseVertex = [&](std::string_view l, size_t i) {
+    double values[MAX_OFF_VERTEX_VALUES];
+    size_t numOfValues = 0u;
+    size_t p = 0u;
+    while (!isLineEnd(l, p)) {
+      if (numOfValues == MAX_OFF_VERTEX_VALUES) {
+        throw std::runtime_error("Invalid .off vertex in line: " + std::string(l));
+      }
+      values[numOfValues++] = parseNumber(l, p);
+    }
+
+    const size_t numOfRequired = 3u + (keyword.isHomogeneous ? 1u : 0u) + (keyword.hasNormal ? 3u : 0u) +
+                                 (keyword.hasTexture ? 2u : 0u);
+    if (numOfValues < numOfRequired) {
+      throw std::runtime_error("Invalid .off vertex in line: " + std::string(l));
+    }
+
+    glm::dvec4 v(values[0], values[1], values[2], 1.0);
+    size_t next = 3u;
+    if (keyword.isHomogeneous) {
+      v /= values[next++];
+      v.w = 1.0;
+    }
+    data.geometricVertices[vertexOffset + i] = v;
+
+    if (keyword.hasNormal) {
+      data.vertexNormals[normalOffset + i] = glm::dvec3(values[next], values[next + 1u], values[next + 2u]);
+    }
+    if (keyword.hasTexture) {
+      data.textureVertices[textureOffset + i] = glm::dvec3(values[numOfValues - 2u], values[numOfValues - 1u], 0.0);
+    }
+  };
+
+  /* n v1 v2 ... vn (color) */
+  auto parseFace = [&](std::string_view l, size_t i) {
+    size_t p = 0u;
+    const int64_t numOfCorners = parseInteger(l, p);
+    if (numOfCorners < 0 || static_cast<uint64_t>(numOfCorners) > l.size()) {
+      throw std::runtime_error("Invalid .off face in line: " + std::string(l));
+    }
+
+    Face& f = data.faces[faceOffset + i];
+    f.geometricVertexReferences.resize(static_cast<size_t>(numOfCorners));
+    for (auto& reference : f.geometricVertexReferences) {
+      const int64_t index = parseInteger(l, p);
+      if (index < 0 || index >= numOfVertices) {
+        throw std::runtime_error("Invalid vertex index in .off face: " + std::to_string(index));
+      }
+      reference = static_cast<uint32_t>(vertexOffset + index + 1);
+    }
+
+    if (keyword.hasNormal) {
+      f.vertexNormalReferences = f.geometricVertexReferences;
+      for (auto& reference : f.vertexNormalReferences) {
+        reference = static_cast<uint32_t>(reference - vertexOffset + normalOffset);
+      }
+    }
+    if (keyword.hasTexture) {
+      f.textureVertexReferences = f.geometricVertexReferences;
+      for (auto& reference : f.textureVertexReferences) {
+        reference = static_cast<uint32_t>(reference - vertexOffset + textureOffset);
+      }
+    }
+  };
+
+  /* the data lines after the vertices and faces (edges) are skipped (parsing is reported as 70 %) */
+  std::atomic<size_t> numOfParsedBytes{0u};
+  parallelFor(numOfBlocks, 1u, [&](size_t begin, size_t end) {
+    for (size_t b = begin; b < end; ++b) {
+      progress.checkCancelled();
+      size_t k = firstLines[b];
+      forEachLine(blockOf(b), [&](std::string_view l) {
+        if (!isDataLine(l)) {
+          return;
+        }
+
+        if (k < static_cast<size_t>(numOfVertices)) {
+          parseVertex(l, k);
+        } else if (k < static_cast<size_t>(numOfVertices + numOfFaces)) {
+          parseFace(l, k - static_cast<size_t>(numOfVertices));
+        }
+        ++k;
+      });
+
+      numOfParsedBytes += blockStarts[b + 1u] - blockStarts[b];
+      progress.update(0.2 + 0.7 * numOfParsedBytes / std::max<size_t>(1u, body.size()));
+    }
+  });
+
+  /* update triangles */
+  data.updateTriangles();
+  progress.update(1.0);
+}
+
+} // namespace conv
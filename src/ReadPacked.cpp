@@ -0,0 +1,149 @@
+#include "ReadPacked.h"
+#include "Entropy.h"
+#include "MappedFile.h"
+#include "PackedFormat.h"
+#include "Parallel.h"
+
+#include <atomic>
+#include <cstring>
+
+
+namespace conv {
+
+/* longest encoding of the three coordinates of a vertex */
+constexpr size_t MAX_PACKED_VERTEX_SIZE_IN_BYTES = 3u * 10u;
+
+namespace {
+
+/* block located in the file, with the first vertex or face it decodes */
+struct PackedBlock {
+  PackedBlockHeader header;
+  const uint8_t* bytes = nullptr;
+  size_t first = 0u;
+};
+
+} // namespace
+
+void ReadPacked::read(const std::string& pathToFile, MeshData& data, const Progress& progress) {
+  /* the file is decoded straight from its mapping */
+  MappedFile file(pathToFile);
+  read(file.data(), file.size(), data, progress);
+}
+
+void ReadPacked::read(const uint8_t* bytes, size_t size, MeshData& data, const Progress& progress) {
+  PackedHeader header;
+  if (size < sizeof(header) || std::memcmp(bytes, PACKED_MAGIC, sizeof(PACKED_MAGIC)) != 0) {
+    throw std::runtime_error("Not a .3dfz file");
+  }
+
+  std::memcpy(&header, bytes, sizeof(header));
+  if (header.byteOrderMark != PACKED_BYTE_ORDER_MARK) {
+    throw std::runtime_error(".3dfz file of a different byte order");
+  }
+  if (header.version != PACKED_VERSION) {
+    throw std::runtime_error("Unsupported .3dfz version: " + std::to_string(header.version));
+  }
+  if (header.quantizationBits < PACKED_MIN_QUANTIZATION_BITS || header.quantizationBits > PACKED_MAX_QUANTIZATION_BITS ||
+      header.numOfVertices >= std::numeric_limits<uint32_t>::max()) {
+    throw std::runtime_error("Invalid .3dfz header");
+  }
+  progress.update(0.0);
+
+  /* one pass over the headers of the blocks (every block takes at least its header in the file) */
+  const uint64_t numOfBlocks = static_cast<uint64_t>(header.numOfVertexBlocks) + header.numOfFaceBlocks;
+  if (numOfBlocks > (size - sizeof(header)) / sizeof(PackedBlockHeader)) {
+    throw std::runtime_error("Invalid number of blocks in .3dfz file");
+  }
+  std::vector<PackedBlock> blocks(static_cast<size_t>(numOfBlocks));
+  size_t position = sizeof(header);
+  uint64_t numOfVertices = 0u;
+  uint64_t numOfFaces = 0u;
+  for (size_t b = 0u; b < blocks.size(); ++b) {
+    if (size - position < sizeof(PackedBlockHeader)) {
+      throw std::runtime_error("Truncated .3dfz file");
+    }
+    std::memcpy(&blocks[b].header, bytes + position, sizeof(PackedBlockHeader));
+    position += sizeof(PackedBlockHeader);
+    if (size - position < blocks[b].header.encodedSize) {
+      throw std::runtime_error("Truncated .3dfz file");
+    }
+
+    /* a vertex takes at least 3 decoded bytes and a face 1, no more than the block can decode to */
+    const bool isVertexBlock = (b < header.numOfVertexBlocks);
+    const uint64_t count = blocks[b].header.count;
+    if (count > PACKED_BLOCK_SIZE ||
+        (isVertexBlock ? 3u : 1u) * count > entropyMaxDecodedSize(blocks[b].header.encodedSize)) {
+      throw std::runtime_error("Invalid number of vertices or faces in .3dfz block");
+    }
+
+    uint64_t& numOfItems = isVertexBlock ? numOfVertices : numOfFaces;
+    blocks[b].bytes = bytes + position;
+    blocks[b].first = static_cast<size_t>(numOfItems);
+    numOfItems += blocks[b].header.count;
+    position += blocks[b].header.encodedSize;
+  }
+  if (numOfVertices != header.numOfVertices || numOfFaces != header.numOfFaces) {
+    throw std::runtime_error("Invalid number of vertices or faces in .3dfz file");
+  }
+
+  const glm::dvec3 boundsMin(header.boundsMin[0], header.boundsMin[1], header.boundsMin[2]);
+  const glm::dvec3 boundsMax(header.boundsMax[0], header.boundsMax[1], header.boundsMax[2]);
+  const glm::dvec3 step = (boundsMax - boundsMin) / static_cast<double>((1u << header.quantizationBits) - 1u);
+
+  data.geometricVertices.resize(static_cast<size_t>(header.numOfVertices));
+  data.faces.resize(static_cast<size_t>(header.numOfFaces));
+  std::atomic<size_t> numOfDecodedBlocks{0u};
+  parallelFor(blocks.size(), 1u, [&](size_t begin, size_t end) {
+    for (size_t b = begin; b < end; ++b) {
+      progress.checkCancelled();
+      const PackedBlock& block = blocks[b];
+
+      if (b < header.numOfVertexBlocks) {
+        const std::vector<uint8_t> raw = entropyDecode(block.bytes, block.header.encodedSize,
+                                                       block.header.count * MAX_PACKED_VERTEX_SIZE_IN_BYTES);
+        const uint8_t* p = raw.data();
+        const uint8_t* rawEnd = raw.data() + raw.size();
+        int64_t q[3] = {0, 0, 0};
+        for (size_t i = block.first; i < block.first + block.header.count; ++i) {
+          for (glm::length_t c = 0; c < 3; ++c) {
+            q[c] += unzigzag(readVarint(p, rawEnd));
+          }
+          data.geometricVertices[i] = glm::dvec4(boundsMin + glm::dvec3(q[0], q[1], q[2]) * step, 1.0);
+        }
+      } else {
+        /* faces have any number of vertices, so only the encoded size bounds the decoded size of their block */
+        const std::vector<uint8_t> raw = entropyDecode(block.bytes, block.header.encodedSize,
+                                                       static_cast<size_t>(entropyMaxDecodedSize(block.header.encodedSize)));
+        const uint8_t* p = raw.data();
+        const uint8_t* rawEnd = raw.data() + raw.size();
+        uint64_t watermark = block.header.watermark;
+        for (size_t f = block.first; f < block.first + block.header.count; ++f) {
+          const uint64_t numOfFaceVertices = readVarint(p, rawEnd);
+          if (numOfFaceVertices > static_cast<uint64_t>(rawEnd - p)) {
+            throw std::runtime_error("Invalid face in .3dfz file");
+          }
+
+          auto& references = data.faces[f].geometricVertexReferences;
+          references.resize(static_cast<size_t>(numOfFaceVertices));
+          for (auto& reference : references) {
+            const uint64_t distance = readVarint(p, rawEnd);
+            if (distance > watermark || watermark - distance >= header.numOfVertices) {
+              throw std::runtime_error("Invalid vertex index in .3dfz file");
+            }
+
+            const uint64_t index = watermark - distance;
+            reference = static_cast<uint32_t>(index + 1u);
+            watermark = std::max(watermark, index + 1u);
+          }
+        }
+      }
+
+      progress.update(0.8 * static_cast<double>(++numOfDecodedBlocks) / blocks.size());
+    }
+  });
+
+  data.updateTriangles();
+  progress.update(1.0);
+}
+
+} // namespace conv
@@ -0,0 +1,400 @@
+#include "ReadPly.h"
+#include "MappedFile.h"
+#include "Parallel.h"
+
+#include <cstring>
+#include <string_view>
+
+
+namespace conv {
+
+/* number of elements decoded by one task */
+constexpr size_t PLY_DECODE_BLOCK_SIZE = 16384u;
+
+namespace {
+
+/* enum for the scalar types of the properties */
+enum class PlyType : uint8_t {
+  PLY_TYPE_INT8 = 0u,
+  PLY_TYPE_UINT8,
+  PLY_TYPE_INT16,
+  PLY_TYPE_UINT16,
+  PLY_TYPE_INT32,
+  PLY_TYPE_UINT32,
+  PLY_TYPE_FLOAT32,
+  PLY_TYPE_FLOAT64
+};
+
+/* property of an element, a list has a count type besides its value type */
+struct PlyProperty {
+  std::string name;
+  PlyType type = PlyType::PLY_TYPE_FLOAT32;
+  bool isList = false;
+  PlyType countType = PlyType::PLY_TYPE_UINT8;
+
+  /* position in the records of fixed size elements */
+  size_t offset = 0u;
+};
+
+/* element of the file (vertex, face or any other) */
+struct PlyElement {
+  std::string name;
+  size_t count = 0u;
+  std::vector<PlyProperty> properties;
+
+  /* size of a record, 0 if the element has lists */
+  size_t recordSize = 0u;
+
+  /* position of the first record in the file */
+  size_t start = 0u;
+
+  /* position of every record (and the end of the last one) of an element with lists */
+  std::vector<size_t> recordStarts;
+};
+
+/* function to get the scalar type of a type name (both the old and the sized names) */
+PlyType parseType(const std::string& name) {
+  if (name == "char" || name == "int8") return PlyType::PLY_TYPE_INT8;
+  if (name == "uchar" || name == "uint8") return PlyType::PLY_TYPE_UINT8;
+  if (name == "short" || name == "int16") return PlyType::PLY_TYPE_INT16;
+  if (name == "ushort" || name == "uint16") return PlyType::PLY_TYPE_UINT16;
+  if (name == "int" || name == "int32") return PlyType::PLY_TYPE_INT32;
+  if (name == "uint" || name == "uint32") return PlyType::PLY_TYPE_UINT32;
+  if (name == "float" || name == "float32") return PlyType::PLY_TYPE_FLOAT32;
+  if (name == "double" || name == "float64") return PlyType::PLY_TYPE_FLOAT64;
+  throw std::runtime_error("Unknown PLY property type: " + name);
+}
+
+size_t sizeOf(PlyType type) {
+  switch (type) {
+  case PlyType::PLY_TYPE_INT8:
+  case PlyType::PLY_TYPE_UINT8:
+    return 1u;
+  case PlyType::PLY_TYPE_INT16:
+  case PlyType::PLY_TYPE_UINT16:
+    return 2u;
+  case PlyType::PLY_TYPE_INT32:
+  case PlyType::PLY_TYPE_UINT32:
+  case PlyType::PLY_TYPE_FLOAT32:
+    return 4u;
+  case PlyType::PLY_TYPE_FLOAT64:
+    return 8u;
+  }
+  return 0u;
+}
+
+/* function to decode a scalar of the file */
+template <typename T>
+T load(const uint8_t* bytes, bool isBigEndian) {
+  uint8_t value[sizeof(T)];
+  std::memcpy(value, bytes, sizeof(T));
+  if (isBigEndian) {
+    std::reverse(value, value + sizeof(T));
+  }
+
+  T result;
+  std::memcpy(&result, value, sizeof(T));
+  return result;
+}
+
+double loadScalar(const uint8_t* bytes, PlyType type, bool isBigEndian) {
+  switch (type) {
+  case PlyType::PLY_TYPE_INT8:
+    return load<int8_t>(bytes, isBigEndian);
+  case PlyType::PLY_TYPE_UINT8:
+    return load<uint8_t>(bytes, isBigEndian);
+  case PlyType::PLY_TYPE_INT16:
+    return load<int16_t>(bytes, isBigEndian);
+  case PlyType::PLY_TYPE_UINT16:
+    return load<uint16_t>(bytes, isBigEndian);
+  case PlyType::PLY_TYPE_INT32:
+    return load<int32_t>(bytes, isBigEndian);
+  case PlyType::PLY_TYPE_UINT32:
+    return load<uint32_t>(bytes, isBigEndian);
+  case PlyType::PLY_TYPE_FLOAT32:
+    return load<float>(bytes, isBigEndian);
+  case PlyType::PLY_TYPE_FLOAT64:
+    return load<double>(bytes, isBigEndian);
+  }
+  return 0.0;
+}
+
+/* function to decode an integer (count or index) of the file */
+int64_t loadInteger(const uint8_t* bytes, PlyType type, bool isBigEndian) {
+  switch (type) {
+  case PlyType::PLY_TYPE_INT8:
+    return load<int8_t>(bytes, isBigEndian);
+  case PlyType::PLY_TYPE_UINT8:
+    return load<uint8_t>(bytes, isBigEndian);
+  case PlyType::PLY_TYPE_INT16:
+    return load<int16_t>(bytes, isBigEndian);
+  case PlyType::PLY_TYPE_UINT16:
+    return load<uint16_t>(bytes, isBigEndian);
+  case PlyType::PLY_TYPE_INT32:
+    return load<int32_t>(bytes, isBigEndian);
+  case PlyType::PLY_TYPE_UINT32:
+    return load<uint32_t>(bytes, isBigEndian);
+  default:
+    throw std::runtime_error("PLY list counts and indices must be integers");
+  }
+}
+
+/* function to find the property of the element, returns nullptr if there is none */
+const PlyProperty* findProperty(const PlyElement& element, std::initializer_list<const char*> names) {
+  for (const char* name : names) {
+    for (const auto& p : element.properties) {
+      if (p.name == name) {
+        return &p;
+      }
+    }
+  }
+  return nullptr;
+}
+
+/* function to get the size of the list element starting at the record */
+size_t listRecordSize(const PlyElement& element, const uint8_t* record, const uint8_t* end, bool isBigEndian) {
+  size_t size = 0u;
+  for (const auto& p : element.properties) {
+    if (record + size + sizeOf(p.isList ? p.countType : p.type) > end) {
+      throw std::runtime_error("PLY file is shorter than its elements");
+    }
+
+    if (p.isList) {
+      const int64_t count = loadInteger(record + size, p.countType, isBigEndian);
+      if (count < 0) {
+        throw std::runtime_error("Negative PLY list count");
+      }
+      size += sizeOf(p.countType) + static_cast<size_t>(count) * sizeOf(p.type);
+    } else {
+      size += sizeOf(p.type);
+    }
+  }
+
+  if (record + size > end) {
+    throw std::runtime_error("PLY file is shorter than its elements");
+  }
+  return size;
+}
+
+} // namespace
+
+void ReadPly::read(const std::string& pathToFile, MeshData& data, const Progress& progress) {
+  /* the elements are decoded straight from the mapping of the file */
+  MappedFile file(pathToFile);
+  read(file.data(), file.size(), data, progress);
+}
+
+void ReadPly::read(const uint8_t* bytes, size_t size, MeshData& data, const Progress& progress) {
+  const std::string_view content(reinterpret_cast<const char*>(bytes), size);
+  const size_t headerEnd = content.find("end_header");
+  if (content.compare(0u, 3u, "ply") != 0 || headerEnd == std::string_view::npos) {
+    throw std::runtime_error("Not a PLY file");
+  }
+
+  /* header */
+  std::istringstream header(std::string(content.substr(0u, headerEnd)));
+  std::vector<PlyElement> elements;
+  bool isBigEndian = false;
+  std::string line;
+  while (std::getline(header, line)) {
+    std::istringstream words(line);
+    std::string keyword;
+    words >> keyword;
+
+    if (keyword == "format") {
+      std::string format;
+      words >> format;
+      if (format == "binary_big_endian") {
+        isBigEndian = true;
+      } else if (format != "binary_little_endian") {
+        throw std::runtime_error("Not supported PLY format: " + format);
+      }
+    } else if (keyword == "element") {
+      PlyElement element;
+      words >> element.name >> element.count;
+      elements.emplace_back(element);
+    } else if (keyword == "property") {
+      if (elements.empty()) {
+        throw std::runtime_error("PLY property without an element");
+      }
+
+      PlyProperty property;
+      std::string type;
+      words >> type;
+      if (type == "list") {
+        std::string countType;
+        words >> countType >> type;
+        property.isList = true;
+        property.countType = parseType(countType);
+      }
+      property.type = parseType(type);
+      words >> property.name;
+      elements.back().properties.emplace_back(property);
+    }
+  }
+
+  /* position of every element, the records of elements with lists are found one by one */
+  size_t position = content.find('\n', headerEnd);
+  position = (position == std::string_view::npos) ? size : (position + 1u);
+  for (auto& element : elements) {
+    element.start = position;
+    bool isFixed = true;
+    for (auto& p : element.properties) {
+      p.offset = element.recordSize;
+      element.recordSize += sizeOf(p.type);
+      isFixed = isFixed && !p.isList;
+    }
+
+    if (isFixed) {
+      if (0u != element.recordSize && element.count > (size - position) / element.recordSize) {
+        throw std::runtime_error("PLY file is shorter than its elements");
+      }
+      position += element.count * element.recordSize;
+    } else {
+      element.recordSize = 0u;
+      if (element.count > size - position) {
+        throw std::runtime_error("PLY file is shorter than its elements");
+      }
+      element.recordStarts.resize(element.count + 1u, position);
+      for (size_t i = 0u; i < element.count; ++i) {
+        element.recordStarts[i + 1u] = element.recordStarts[i] +
+                                       listRecordSize(element, bytes + element.recordStarts[i], bytes + size, isBigEndian);
+      }
+      position = element.recordStarts.back();
+    }
+
+    if (position > size) {
+      throw std::runtime_error("PLY file is shorter than its elements");
+    }
+  }
+  progress.update(0.0);
+
+  /* vertices (reported as 40 %) */
+  auto vertexElement = std::find_if(elements.begin(), elements.end(), [](const PlyElement& e) { return e.name == "vertex"; });
+  if (vertexElement == elements.end() || 0u == vertexElement->recordSize) {
+    throw std::runtime_error("PLY file without vertex element of fixed size");
+  }
+
+  const PlyElement& vertex = *vertexElement;
+  const PlyProperty* x = findProperty(vertex, {"x"});
+  const PlyProperty* y = findProperty(vertex, {"y"});
+  const PlyProperty* z = findProperty(vertex, {"z"});
+  if (!x || !y || !z) {
+    throw std::runtime_error("PLY vertex without x, y and z");
+  }
+  const PlyProperty* nx = findProperty(vertex, {"nx"});
+  const PlyProperty* ny = findProperty(vertex, {"ny"});
+  const PlyProperty* nz = findProperty(vertex, {"nz"});
+  const bool hasNormals = nx && ny && nz;
+  const PlyProperty* s = findProperty(vertex, {"s", "u", "texture_u"});
+  const PlyProperty* t = findProperty(vertex, {"t", "v", "texture_v"});
+  const bool hasTextures = s && t;
+
+  const size_t numOfExistingVertices = data.geometricVertices.size();
+  const size_t numOfExistingNormals = data.vertexNormals.size();
+  const size_t numOfExistingTextures = data.textureVertices.size();
+  if (numOfExistingVertices + vertex.count >= std::numeric_limits<uint32_t>::max()) {
+    throw std::runtime_error("Too many vertices in the PLY file");
+  }
+
+  data.geometricVertices.resize(numOfExistingVertices + vertex.count);
+  data.vertexNormals.resize(numOfExistingNormals + (hasNormals ? vertex.count : 0u));
+  data.textureVertices.resize(numOfExistingTextures + (hasTextures ? vertex.count : 0u));
+  std::atomic<size_t> numOfDecoded{0u};
+  parallelFor(vertex.count, PLY_DECODE_BLOCK_SIZE, [&](size_t begin, size_t end) {
+    progress.checkCancelled();
+    for (size_t i = begin; i < end; ++i) {
+      const uint8_t* record = bytes + vertex.start + i * vertex.recordSize;
+      data.geometricVertices[numOfExistingVertices + i] =
+        glm::dvec4(loadScalar(record + x->offset, x->type, isBigEndian), loadScalar(record + y->offset, y->type, isBigEndian),
+                   loadScalar(record + z->offset, z->type, isBigEndian), 1.0);
+      if (hasNormals) {
+        data.vertexNormals[numOfExistingNormals + i] =
+          glm::dvec3(loadScalar(record + nx->offset, nx->type, isBigEndian), loadScalar(record + ny->offset, ny->type, isBigEndian),
+                     loadScalar(record + nz->offset, nz->type, isBigEndian));
+      }
+      if (hasTextures) {
+        data.textureVertices[numOfExistingTextures + i] =
+          glm::dvec3(loadScalar(record + s->offset, s->type, isBigEndian), loadScalar(record + t->offset, t->type, isBigEndian), 0.0);
+      }
+    }
+
+    numOfDecoded += end - begin;
+    progress.update(0.4 * numOfDecoded / vertex.count);
+  });
+
+  /* faces: their starts are known from the pass over the elements, they are decoded in parallel (reported as 40 %) */
+  auto faceElement = std::find_if(elements.begin(), elements.end(), [](const PlyElement& e) { return e.name == "face"; });
+  if (faceElement != elements.end()) {
+    const PlyElement& face = *faceElement;
+    const PlyProperty* indices = findProperty(face, {"vertex_indices", "vertex_index"});
+    if (!indices || !indices->isList) {
+      throw std::runtime_error("PLY face without vertex_indices list");
+    }
+
+    /* faces of fixed size (without lists) have no indices */
+    if (0u != face.recordSize) {
+      throw std::runtime_error("PLY face without vertex_indices list");
+    }
+
+    const size_t numOfExistingFaces = data.faces.size();
+    data.faces.resize(numOfExistingFaces + face.count);
+    std::atomic<bool> isOutOfRange{false};
+    numOfDecoded = 0u;
+    parallelFor(face.count, PLY_DECODE_BLOCK_SIZE, [&](size_t begin, size_t end) {
+      progress.checkCancelled();
+      for (size_t i = begin; i < end; ++i) {
+        const uint8_t* record = bytes + face.recordStarts[i];
+        for (const auto& p : face.properties) {
+          if (&p != indices) {
+            record += p.isList ? sizeOf(p.countType) + static_cast<size_t>(loadInteger(record, p.countType, isBigEndian)) * sizeOf(p.type) :
+                                 sizeOf(p.type);
+            continue;
+          }
+
+          const size_t count = static_cast<size_t>(loadInteger(record, p.countType, isBigEndian));
+          record += sizeOf(p.countType);
+
+          Face& f = data.faces[numOfExistingFaces + i];
+          f.geometricVertexReferences.resize(count);
+          for (size_t k = 0u; k < count; ++k, record += sizeOf(p.type)) {
+            const int64_t index = loadInteger(record, p.type, isBigEndian);
+            if (index < 0 || static_cast<size_t>(index) >= vertex.count) {
+              isOutOfRange = true;
+              f.geometricVertexReferences.clear();
+              break;
+            }
+            f.geometricVertexReferences[k] = static_cast<uint32_t>(numOfExistingVertices + index + 1);
+          }
+
+          /* normals and texture vertices are referenced by the vertex indices */
+          if (hasNormals) {
+            f.vertexNormalReferences = f.geometricVertexReferences;
+            for (auto& r : f.vertexNormalReferences) {
+              r = static_cast<uint32_t>(r - numOfExistingVertices + numOfExistingNormals);
+            }
+          }
+          if (hasTextures) {
+            f.textureVertexReferences = f.geometricVertexReferences;
+            for (auto& r : f.textureVertexReferences) {
+              r = static_cast<uint32_t>(r - numOfExistingVertices + numOfExistingTextures);
+            }
+          }
+        }
+      }
+
+      numOfDecoded += end - begin;
+      progress.update(0.4 + 0.4 * numOfDecoded / face.count);
+    });
+
+    if (isOutOfRange) {
+      throw std::runtime_error("PLY face index out of range");
+    }
+  }
+
+  /* update triangles */
+  data.updateTriangles();
+  progress.update(1.0);
+}
+
+} // namespace conv
@@ -0,0 +1,243 @@
+#include "ReadStl.h"
+#include "Hash.h"
+#include "MappedFile.h"
+#include "Parallel.h"
+
+#include <cstring>
+#include <unordered_map>
+
+
+namespace conv {
+
+constexpr size_t HEADER_SIZE_IN_BYTES = 80u;
+constexpr size_t FIRST_RECORD_OFFSET = HEADER_SIZE_IN_BYTES + sizeof(uint32_t);
+
+/* normal, three vertices and attribute byte count of a triangle */
+constexpr size_t RECORD_SIZE_IN_BYTES = 12u * sizeof(float) + sizeof(uint16_t);
+constexpr size_t LEGACY_RECORD_SIZE_IN_BYTES = 12u * sizeof(double) + sizeof(uint16_t);
+
+/* number of triangles decoded by one task */
+constexpr size_t DECODE_BLOCK_SIZE = 16384u;
+
+/* number of corners hashed by one task of the welding, and the number of independent hash tables */
+constexpr size_t WELD_BLOCK_SIZE = 65536u;
+constexpr size_t NUM_OF_WELD_SHARDS = 64u;
+
+namespace {
+
+/* function to hash a position (negative zeros are turned into positive ones before) */
+struct PositionHash {
+  size_t operator() (const glm::dvec3& position) const {
+    return static_cast<size_t>(hash64(&position, sizeof(position)));
+  }
+};
+
+/*
+ * function to merge the equal corners into vertices, the vertices keep the order of their first corner
+ * the corners are distributed into shards by their hash, the shards are deduplicated in parallel
+ */
+void weld(const std::vector<glm::dvec3>& corners, std::vector<glm::dvec3>& vertices,
+          std::vector<uint32_t>& indices, const Progress& progress) {
+  const size_t numOfBlocks = (corners.size() + WELD_BLOCK_SIZE - 1u) / WELD_BLOCK_SIZE;
+
+  /* shard of every corner and the size of the shards in every block */
+  std::vector<uint8_t> shards(corners.size());
+  std::vector<size_t> counts(numOfBlocks * NUM_OF_WELD_SHARDS, 0u);
+  parallelFor(numOfBlocks, 1u, [&](size_t begin, size_t end) {
+    for (size_t b = begin; b < end; ++b) {
+      progress.checkCancelled();
+      for (size_t i = b * WELD_BLOCK_SIZE; i < std::min(corners.size(), (b + 1u) * WELD_BLOCK_SIZE); ++i) {
+        shards[i] = static_cast<uint8_t>(PositionHash()(corners[i]) % NUM_OF_WELD_SHARDS);
+        counts[b * NUM_OF_WELD_SHARDS + shards[i]]++;
+      }
+    }
+  });
+
+  /* corners ordered by shard, within a shard in file order */
+  std::vector<size_t> offsets(numOfBlocks * NUM_OF_WELD_SHARDS);
+  std::vector<size_t> shardStarts(NUM_OF_WELD_SHARDS + 1u, 0u);
+  size_t position = 0u;
+  for (size_t s = 0u; s < NUM_OF_WELD_SHARDS; ++s) {
+    shardStarts[s] = position;
+    for (size_t b = 0u; b < numOfBlocks; ++b) {
+      offsets[b * NUM_OF_WELD_SHARDS + s] = position;
+      position += counts[b * NUM_OF_WELD_SHARDS + s];
+    }
+  }
+  shardStarts[NUM_OF_WELD_SHARDS] = position;
+
+  std::vector<uint32_t> order(corners.size());
+  parallelFor(numOfBlocks, 1u, [&](size_t begin, size_t end) {
+    for (size_t b = begin; b < end; ++b) {
+      for (size_t i = b * WELD_BLOCK_SIZE; i < std::min(corners.size(), (b + 1u) * WELD_BLOCK_SIZE); ++i) {
+        order[offsets[b * NUM_OF_WELD_SHARDS + shards[i]]++] = static_cast<uint32_t>(i);
+      }
+    }
+  });
+
+  /* first corner of every position */
+  std::vector<uint32_t> firstCorners(corners.size());
+  parallelFor(NUM_OF_WELD_SHARDS, 1u, [&](size_t begin, size_t end) {
+    for (size_t s = begin; s < end; ++s) {
+      progress.checkCancelled();
+      std::unordered_map<glm::dvec3, uint32_t, PositionHash> first;
+      first.reserve(shardStarts[s + 1u] - shardStarts[s]);
+      for (size_t k = shardStarts[s]; k < shardStarts[s + 1u]; ++k) {
+        firstCorners[order[k]] = first.emplace(corners[order[k]], order[k]).first->second;
+      }
+    }
+  });
+
+  /* number the first corners in file order, the other corners take the number of their first corner */
+  std::vector<size_t> firstVertices(numOfBlocks + 1u, 0u);
+  parallelFor(numOfBlocks, 1u, [&](size_t begin, size_t end) {
+    for (size_t b = begin; b < end; ++b) {
+      for (size_t i = b * WELD_BLOCK_SIZE; i < std::min(corners.size(), (b + 1u) * WELD_BLOCK_SIZE); ++i) {
+        firstVertices[b + 1u] += (firstCorners[i] == i) ? 1u : 0u;
+      }
+    }
+  });
+  for (size_t b = 0u; b < numOfBlocks; ++b) {
+    firstVertices[b + 1u] += firstVertices[b];
+  }
+
+  vertices.resize(firstVertices.back());
+  indices.resize(corners.size());
+  parallelFor(numOfBlocks, 1u, [&](size_t begin, size_t end) {
+    for (size_t b = begin; b < end; ++b) {
+      uint32_t vertex = static_cast<uint32_t>(firstVertices[b]);
+      for (size_t i = b * WELD_BLOCK_SIZE; i < std::min(corners.size(), (b + 1u) * WELD_BLOCK_SIZE); ++i) {
+        if (firstCorners[i] == i) {
+          vertices[vertex] = corners[i];
+          indices[i] = vertex++;
+        }
+      }
+    }
+  });
+  /* the first corners keep their indices, so no slot read by another thread is written */
+  parallelFor(corners.size(), WELD_BLOCK_SIZE, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      if (firstCorners[i] != i) {
+        indices[i] = indices[firstCorners[i]];
+      }
+    }
+  });
+}
+
+} // namespace
+
+size_t ReadStl::recordSize(uint32_t numOfTriangles, uint64_t fileSize) {
+  if (fileSize == FIRST_RECORD_OFFSET + static_cast<uint64_t>(numOfTriangles) * RECORD_SIZE_IN_BYTES) {
+    return RECORD_SIZE_IN_BYTES;
+  }
+  if (fileSize == FIRST_RECORD_OFFSET + static_cast<uint64_t>(numOfTriangles) * LEGACY_RECORD_SIZE_IN_BYTES) {
+    return LEGACY_RECORD_SIZE_IN_BYTES;
+  }
+  return 0u;
+}
+
+void ReadStl::read(const std::string& pathToFile, MeshData& data, const Progress& progress) {
+  /* the records are decoded straight from the mapping of the file */
+  MappedFile file(pathToFile);
+  read(file.data(), file.size(), data, progress);
+}
+
+void ReadStl::read(const uint8_t* bytes, size_t size, MeshData& data, const Progress& progress) {
+  if (size < FIRST_RECORD_OFFSET) {
+    throw std::runtime_error("Binary STL file is shorter than its header");
+  }
+
+  /* UINT32 - Number of triangles (little endian) */
+  const uint8_t* count = bytes + HEADER_SIZE_IN_BYTES;
+  const uint32_t numOfTriangles = static_cast<uint32_t>(count[0]) | (static_cast<uint32_t>(count[1]) << 8u) |
+                                  (static_cast<uint32_t>(count[2]) << 16u) | (static_cast<uint32_t>(count[3]) << 24u);
+  const size_t sizeOfRecord = recordSize(numOfTriangles, size);
+  if (0u == sizeOfRecord) {
+    throw std::runtime_error("Size of the binary STL file does not match its number of triangles");
+  }
+  progress.update(0.0);
+
+  /*
+   * decode the corners of the triangles (the stored normal vectors are skipped, they are calculated
+   * from the vertices), decoding is reported as 40 % with welding and 80 % without
+   */
+  const double decodeShare = isWelding_ ? 0.4 : 0.8;
+  std::vector<glm::dvec3> corners(3u * static_cast<size_t>(numOfTriangles));
+  std::atomic<size_t> numOfDecoded{0u};
+  parallelFor(numOfTriangles, DECODE_BLOCK_SIZE, [&](size_t begin, size_t end) {
+    progress.checkCancelled();
+    for (size_t i = begin; i < end; ++i) {
+      const uint8_t* record = bytes + FIRST_RECORD_OFFSET + i * sizeOfRecord;
+      if (sizeOfRecord == RECORD_SIZE_IN_BYTES) {
+        /* REAL32[3] - Vertex 1, Vertex 2, Vertex 3 (after the normal vector) */
+        float values[9];
+        std::memcpy(values, record + 3u * sizeof(float), sizeof(values));
+        for (size_t c = 0u; c < 3u; ++c) {
+          corners[3u * i + c] = glm::dvec3(values[3u * c], values[3u * c + 1u], values[3u * c + 2u]);
+        }
+      } else {
+        double values[9];
+        std::memcpy(values, record + 3u * sizeof(double), sizeof(values));
+        for (size_t c = 0u; c < 3u; ++c) {
+          corners[3u * i + c] = glm::dvec3(values[3u * c], values[3u * c + 1u], values[3u * c + 2u]);
+        }
+      }
+    }
+
+    numOfDecoded += end - begin;
+    progress.update(decodeShare * numOfDecoded / numOfTriangles);
+  });
+
+  appendTriangles(corners, isWelding_, data, progress);
+}
+
+void appendTriangles(std::vector<glm::dvec3>& corners, bool isWelding, MeshData& data, const Progress& progress) {
+  const size_t numOfTriangles = corners.size() / 3u;
+  const size_t numOfExistingVertices = data.geometricVertices.size();
+  if (corners.size() + numOfExistingVertices >= std::numeric_limits<uint32_t>::max()) {
+    throw std::runtime_error("Too many vertices in the STL file");
+  }
+
+  /* vertices of the corners, without welding every corner is a vertex */
+  std::vector<glm::dvec3> vertices;
+  std::vector<uint32_t> indices;
+  if (isWelding) {
+    /* negative zeros are equal to positive ones, but not for the hash of the welding */
+    parallelFor(corners.size(), DECODE_BLOCK_SIZE, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        corners[i] += glm::dvec3(0.0);
+      }
+    });
+    weld(corners, vertices, indices, progress);
+    progress.update(0.8);
+  } else {
+    vertices = std::move(corners);
+  }
+
+  data.geometricVertices.resize(numOfExistingVertices + vertices.size());
+  parallelFor(vertices.size(), DECODE_BLOCK_SIZE, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      data.geometricVertices[numOfExistingVertices + i] = glm::dvec4(vertices[i], 1.0);
+    }
+  });
+
+  /* one face per triangle with 1-based references */
+  const size_t numOfExistingFaces = data.faces.size();
+  data.faces.resize(numOfExistingFaces + numOfTriangles);
+  parallelFor(numOfTriangles, DECODE_BLOCK_SIZE, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      std::vector<uint32_t>& refs = data.faces[numOfExistingFaces + i].geometricVertexReferences;
+      refs.resize(3u);
+      for (size_t c = 0u; c < 3u; ++c) {
+        const size_t corner = 3u * i + c;
+        refs[c] = static_cast<uint32_t>(numOfExistingVertices + (isWelding ? indices[corner] : corner) + 1u);
+      }
+    }
+  });
+
+  /* update triangles */
+  data.updateTriangles();
+  progress.update(1.0);
+}
+
+} // namespace conv
@@ -0,0 +1,176 @@
+#include "Scheduler.h"
+
+#include <algorithm>
+
+
+namespace conv {
+
+namespace {
+
+/* scheduler and deque of the worker running on the current thread */
+thread_local Scheduler* currentScheduler = nullptr;
+thread_local size_t currentWorker = 0u;
+
+} // namespace
+
+Scheduler& Scheduler::instance() {
+  static Scheduler scheduler(std::max(2u, std::thread::hardware_concurrency()) - 1u);
+  return scheduler;
+}
+
+Scheduler::Scheduler(size_t numOfWorkers) {
+  numOfWorkers = std::max<size_t>(numOfWorkers, 1u);
+
+  for (size_t i = 0u; i < numOfWorkers; ++i) {
+    workers_.emplace_back(std::make_unique<Worker>());
+  }
+  for (size_t i = 0u; i < numOfWorkers; ++i) {
+    threads_.emplace_back(&Scheduler::workerLoop, this, i);
+  }
+}
+
+Scheduler::~Scheduler() {
+  {
+    std::lock_guard<std::mutex> lock(sleepMutex_);
+    stop_ = true;
+  }
+  wakeUp_.notify_all();
+
+  for (auto& t : threads_) {
+    t.join();
+  }
+}
+
+void Scheduler::submit(Task task) {
+  /* a worker keeps its own tasks, the others are spread over the deques */
+  size_t index = (currentScheduler == this) ? currentWorker : (nextExternal_++ % workers_.size());
+
+  /* counted before it is visible, so the counter never drops below the number of queued tasks */
+  numOfQueuedTasks_++;
+  {
+    std::lock_guard<std::mutex> lock(workers_[index]->mutex);
+    workers_[index]->tasks.emplace_back(std::move(task));
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(sleepMutex_);
+  }
+  wakeUp_.notify_one();
+}
+
+bool Scheduler::takeTask(Task& task) {
+  const bool isWorker = (currentScheduler == this);
+
+  /* newest task of the own deque */
+  if (isWorker) {
+    Worker& own = *workers_[currentWorker];
+    std::lock_guard<std::mutex> lock(own.mutex);
+    if (!own.tasks.empty()) {
+      task = std::move(own.tasks.back());
+      own.tasks.pop_back();
+      numOfQueuedTasks_--;
+      return true;
+    }
+  }
+
+  /* oldest task of another deque */
+  const size_t first = isWorker ? (currentWorker + 1u) : 0u;
+  for (size_t i = 0u; i < workers_.size(); ++i) {
+    Worker& victim = *workers_[(first + i) % workers_.size()];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (!victim.tasks.empty()) {
+      task = std::move(victim.tasks.front());
+      victim.tasks.pop_front();
+      numOfQueuedTasks_--;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool Scheduler::runPendingTask() {
+  Task task;
+  if (!takeTask(task)) {
+    return false;
+  }
+
+  task();
+  return true;
+}
+
+void Scheduler::waitUntil(const std::function<bool()>& predicate) {
+  while (!predicate()) {
+    if (runPendingTask()) {
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(sleepMutex_);
+    wakeUp_.wait(lock, [&]() { return predicate() || numOfQueuedTasks_ > 0u; });
+  }
+}
+
+void Scheduler::notifyWaiters() {
+  {
+    std::lock_guard<std::mutex> lock(sleepMutex_);
+  }
+  wakeUp_.notify_all();
+}
+
+void Scheduler::workerLoop(size_t index) {
+  currentScheduler = this;
+  currentWorker = index;
+
+  while (true) {
+    if (runPendingTask()) {
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(sleepMutex_);
+    wakeUp_.wait(lock, [this]() { return stop_ || numOfQueuedTasks_ > 0u; });
+    if (stop_ && 0u == numOfQueuedTasks_) {
+      return;
+    }
+  }
+}
+
+TaskGroup::~TaskGroup() {
+  /* the tasks refer to the group, it must not go away before them */
+  scheduler_.waitUntil([this]() { return 0u == numOfPendingTasks_; });
+}
+
+void TaskGroup::run(Scheduler::Task task) {
+  numOfPendingTasks_++;
+
+  scheduler_.submit([this, task = std::move(task)]() {
+    try {
+      task();
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(errorMutex_);
+      if (!error_) {
+        error_ = std::current_exception();
+      }
+    }
+
+    /* the group may be gone as soon as the counter drops to zero */
+    Scheduler& scheduler = scheduler_;
+    if (0u == --numOfPendingTasks_) {
+      scheduler.notifyWaiters();
+    }
+  });
+}
+
+void TaskGroup::wait() {
+  scheduler_.waitUntil([this]() { return 0u == numOfPendingTasks_; });
+
+  std::exception_ptr error;
+  {
+    std::lock_guard<std::mutex> lock(errorMutex_);
+    std::swap(error, error_);
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+} // namespace conv
@@ -0,0 +1,192 @@
+#include "VertexCache.h"
+#include "Parallel.h"
+
+
+namespace conv {
+
+/* number of faces renumbered by one task */
+constexpr size_t VERTEX_CACHE_BLOCK_SIZE = 16384u;
+
+namespace {
+
+/* function to renumber the values of a kind in the order of their first use by the faces, the unused ones at the end */
+template <typename Value>
+void reorderByFirstUse(std::vector<Face>& faces, std::vector<uint32_t> Face::*references, std::vector<Value>& values) {
+  const uint32_t UNUSED = std::numeric_limits<uint32_t>::max();
+  std::vector<uint32_t> newIndexOf(values.size(), UNUSED);
+  std::vector<Value> reordered;
+  reordered.reserve(values.size());
+
+  for (const Face& f : faces) {
+    for (uint32_t reference : f.*references) {
+      if (0u == reference || reference > values.size()) {
+        throw std::runtime_error("Invalid reference: " + std::to_string(reference));
+      }
+
+      if (newIndexOf[reference - 1u] == UNUSED) {
+        newIndexOf[reference - 1u] = static_cast<uint32_t>(reordered.size());
+        reordered.emplace_back(values[reference - 1u]);
+      }
+    }
+  }
+  for (size_t i = 0u; i < values.size(); ++i) {
+    if (newIndexOf[i] == UNUSED) {
+      newIndexOf[i] = static_cast<uint32_t>(reordered.size());
+      reordered.emplace_back(values[i]);
+    }
+  }
+
+  parallelFor(faces.size(), VERTEX_CACHE_BLOCK_SIZE, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      for (uint32_t& reference : faces[i].*references) {
+        reference = newIndexOf[reference - 1u] + 1u;
+      }
+    }
+  });
+  values.swap(reordered);
+}
+
+} // namespace
+
+uint64_t countCacheMisses(const MeshData& data, size_t cacheSize) {
+  /* a vertex is in the FIFO cache while fewer than cacheSize vertices were loaded after it */
+  std::vector<uint64_t> loadedAt(data.geometricVertices.size(), 0u);
+  uint64_t numOfLoads = cacheSize;
+  for (const Face& f : data.faces) {
+    const auto& references = f.geometricVertexReferences;
+    for (size_t i = 1u; (i + 1u) < references.size(); ++i) {
+      for (uint32_t reference : {references[0], references[i], references[i + 1u]}) {
+        if (0u == reference || reference > loadedAt.size()) {
+          throw std::runtime_error("Invalid vertex reference: " + std::to_string(reference));
+        }
+        if (numOfLoads - loadedAt[reference - 1u] >= cacheSize) {
+          loadedAt[reference - 1u] = numOfLoads++;
+        }
+      }
+    }
+  }
+  return numOfLoads - cacheSize;
+}
+
+VertexCacheStatistics optimizeVertexCache(MeshData& data, size_t cacheSize) {
+  const size_t numOfVertices = data.geometricVertices.size();
+  const size_t numOfFaces = data.faces.size();
+
+  VertexCacheStatistics statistics;
+  statistics.numOfTriangles = data.triangles.size();
+  statistics.numOfMissesBefore = countCacheMisses(data, cacheSize);
+
+  /* faces of every vertex, and the number of faces of every vertex not emitted yet */
+  std::vector<size_t> firstFace(numOfVertices + 1u, 0u);
+  for (const Face& f : data.faces) {
+    for (uint32_t reference : f.geometricVertexReferences) {
+      if (0u == reference || reference > numOfVertices) {
+        throw std::runtime_error("Invalid vertex reference: " + std::to_string(reference));
+      }
+      ++firstFace[reference];
+    }
+  }
+  std::vector<uint32_t> numOfLiveFaces(numOfVertices);
+  for (size_t v = 0u; v < numOfVertices; ++v) {
+    numOfLiveFaces[v] = static_cast<uint32_t>(firstFace[v + 1u]);
+    firstFace[v + 1u] += firstFace[v];
+  }
+  std::vector<uint32_t> faceOfVertex(firstFace.back());
+  {
+    std::vector<size_t> position(firstFace.begin(), firstFace.end() - 1);
+    for (size_t i = 0u; i < numOfFaces; ++i) {
+      for (uint32_t reference : data.faces[i].geometricVertexReferences) {
+        faceOfVertex[position[reference - 1u]++] = static_cast<uint32_t>(i);
+      }
+    }
+  }
+
+  /*
+   * Tipsify: emit the faces around the fanning vertex, then fan around the vertex of those faces that
+   * stays longest in the cache and still has faces, else around a recently used vertex (dead end) or
+   * the next vertex in order
+   */
+  std::vector<Face> faces;
+  faces.reserve(numOfFaces);
+  std::vector<bool> isEmitted(numOfFaces, false);
+  std::vector<uint64_t> loadedAt(numOfVertices, 0u);
+  std::vector<uint32_t> deadEnd;
+  std::vector<uint32_t> candidates;
+  uint64_t numOfLoads = cacheSize + 1u;
+  size_t nextVertex = 0u;
+
+  auto nextInOrder = [&]() -> int64_t {
+    while (!deadEnd.empty()) {
+      const uint32_t v = deadEnd.back();
+      deadEnd.pop_back();
+      if (numOfLiveFaces[v] > 0u) {
+        return v;
+      }
+    }
+    while (nextVertex < numOfVertices) {
+      if (numOfLiveFaces[nextVertex] > 0u) {
+        return static_cast<int64_t>(nextVertex++);
+      }
+      ++nextVertex;
+    }
+    return -1;
+  };
+
+  for (int64_t fanning = nextInOrder(); fanning >= 0;) {
+    candidates.clear();
+    for (size_t k = firstFace[fanning]; k < firstFace[fanning + 1]; ++k) {
+      const uint32_t face = faceOfVertex[k];
+      if (isEmitted[face]) {
+        continue;
+      }
+      isEmitted[face] = true;
+
+      for (uint32_t reference : data.faces[face].geometricVertexReferences) {
+        const uint32_t v = reference - 1u;
+        deadEnd.emplace_back(v);
+        candidates.emplace_back(v);
+        --numOfLiveFaces[v];
+        if (numOfLoads - loadedAt[v] > cacheSize) {
+          loadedAt[v] = numOfLoads++;
+        }
+      }
+      faces.emplace_back(std::move(data.faces[face]));
+    }
+
+    /* the candidate that is in the cache and will still be after its remaining faces are emitted */
+    int64_t best = -1;
+    uint64_t bestPriority = 0u;
+    for (uint32_t v : candidates) {
+      if (numOfLiveFaces[v] > 0u) {
+        uint64_t priority = 1u;
+        if (numOfLoads - loadedAt[v] + 2u * numOfLiveFaces[v] <= cacheSize) {
+          priority += numOfLoads - loadedAt[v];
+        }
+        if (priority > bestPriority) {
+          best = v;
+          bestPriority = priority;
+        }
+      }
+    }
+    fanning = (best >= 0) ? best : nextInOrder();
+  }
+
+  /* faces without vertices keep their order at the end */
+  for (size_t i = 0u; i < numOfFaces; ++i) {
+    if (!isEmitted[i]) {
+      faces.emplace_back(std::move(data.faces[i]));
+    }
+  }
+  data.faces.swap(faces);
+
+  /* vertex fetch order */
+  reorderByFirstUse(data.faces, &Face::geometricVertexReferences, data.geometricVertices);
+  reorderByFirstUse(data.faces, &Face::textureVertexReferences, data.textureVertices);
+  reorderByFirstUse(data.faces, &Face::vertexNormalReferences, data.vertexNormals);
+
+  data.updateTriangles();
+  statistics.numOfMissesAfter = countCacheMisses(data, cacheSize);
+  return statistics;
+}
+
+} // namespace conv
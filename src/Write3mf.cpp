@@ -0,0 +1,124 @@
+#include "Write3mf.h"
+#include "TextWriter.h"
+
+
+namespace conv {
+
+/* number of vertices or faces formatted before they are handed to the ZIP writer (bounds the memory of the text) */
+constexpr size_t MODEL_WINDOW_SIZE = 16u * TEXT_FORMAT_BLOCK_SIZE;
+
+/* upper bound of the text of a vertex element (3 numbers of at most 24 characters) */
+constexpr size_t MAX_3MF_VERTEX_SIZE_IN_BYTES = 112u;
+
+/* upper bound of the text of a triangle element (3 indices of at most 10 digits) */
+constexpr size_t MAX_3MF_TRIANGLE_SIZE_IN_BYTES = 64u;
+
+/* parts of the package besides the model */
+const char* const CONTENT_TYPES_XML =
+  "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+  "<Types xmlns=\"http://schemas.openxmlformats.org/package/2006/content-types\">"
+  "<Default Extension=\"rels\" ContentType=\"application/vnd.openxmlformats-package.relationships+xml\"/>"
+  "<Default Extension=\"model\" ContentType=\"application/vnd.ms-package.3dmanufacturing-3dmodel+xml\"/>"
+  "</Types>\n";
+
+const char* const RELATIONSHIPS_XML =
+  "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+  "<Relationships xmlns=\"http://schemas.openxmlformats.org/package/2006/relationships\">"
+  "<Relationship Target=\"/3D/3dmodel.model\" Id=\"rel0\" "
+  "Type=\"http://schemas.microsoft.com/3dmanufacturing/2013/01/3dmodel\"/>"
+  "</Relationships>\n";
+
+const char* const MODEL_HEADER =
+  "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+  "<model unit=\"millimeter\" xml:lang=\"en-US\" xmlns=\"http://schemas.microsoft.com/3dmanufacturing/core/2015/02\">\n"
+  "<resources>\n<object id=\"1\" type=\"model\">\n<mesh>\n<vertices>\n";
+
+const char* const MODEL_FOOTER =
+  "</triangles>\n</mesh>\n</object>\n</resources>\n<build>\n<item objectid=\"1\"/>\n</build>\n</model>\n";
+
+namespace {
+
+/* function to append name"value" to the buffer */
+template <typename Value>
+char* appendAttribute(char* buffer, const char* name, Value value) {
+  buffer = std::to_chars(appendText(buffer, name), buffer + 64, value).ptr;
+  *buffer++ = '"';
+  return buffer;
+}
+
+} // namespace
+
+Write3mf::Write3mf(ZipMethod method) : method_(method) {
+}
+
+void Write3mf::write(std::ostream& stream, const MeshData& data, const Progress& progress) {
+  ZipWriter zip(stream);
+  progress.update(0.0);
+
+  zip.beginEntry("[Content_Types].xml", method_);
+  zip.write(CONTENT_TYPES_XML);
+  zip.endEntry();
+  zip.beginEntry("_rels/.rels", method_);
+  zip.write(RELATIONSHIPS_XML);
+  zip.endEntry();
+
+  /* the vertices and faces are reported by their share of the elements */
+  const size_t numOfVertices = data.geometricVertices.size();
+  const size_t numOfFaces = data.faces.size();
+  const double numOfElements = static_cast<double>(std::max<size_t>(1u, numOfVertices + numOfFaces));
+
+  zip.beginEntry("3D/3dmodel.model", method_);
+  zip.write(MODEL_HEADER);
+  for (size_t first = 0u; first < numOfVertices; first += MODEL_WINDOW_SIZE) {
+    const size_t last = std::min(numOfVertices, first + MODEL_WINDOW_SIZE);
+    zip.write(formatLines(last - first, [](size_t begin, size_t end) {
+      return (end - begin) * MAX_3MF_VERTEX_SIZE_IN_BYTES;
+    }, [&](char* text, size_t i) {
+      const glm::dvec4& v = data.geometricVertices[first + i];
+      text = appendAttribute(appendText(text, "<vertex"), " x=\"", v.x);
+      text = appendAttribute(appendAttribute(text, " y=\"", v.y), " z=\"", v.z);
+      return appendText(text, "/>\n");
+    }, progress.part(first / numOfElements, last / numOfElements)));
+  }
+
+  /* fans of the faces with 0-based indices, the degenerate triangles are not allowed by 3MF */
+  zip.write("</vertices>\n<triangles>\n");
+  for (size_t first = 0u; first < numOfFaces; first += MODEL_WINDOW_SIZE) {
+    const size_t last = std::min(numOfFaces, first + MODEL_WINDOW_SIZE);
+    zip.write(formatLines(last - first, [&](size_t begin, size_t end) {
+      size_t size = 0u;
+      for (size_t i = first + begin; i < first + end; ++i) {
+        size += data.faces[i].geometricVertexReferences.size() * MAX_3MF_TRIANGLE_SIZE_IN_BYTES;
+      }
+      return size;
+    }, [&](char* text, size_t i) {
+      const auto& references = data.faces[first + i].geometricVertexReferences;
+      for (uint32_t reference : references) {
+        if (0u == reference || reference > numOfVertices) {
+          throw std::runtime_error("Invalid vertex reference: " + std::to_string(reference));
+        }
+      }
+
+      for (size_t k = 1u; (k + 1u) < references.size(); ++k) {
+        const uint32_t a = references[0] - 1u;
+        const uint32_t b = references[k] - 1u;
+        const uint32_t c = references[k + 1u] - 1u;
+        if (a == b || b == c || c == a) {
+          continue;
+        }
+
+        text = appendAttribute(appendText(text, "<triangle"), " v1=\"", a);
+        text = appendAttribute(appendAttribute(text, " v2=\"", b), " v3=\"", c);
+        text = appendText(text, "/>\n");
+      }
+      return text;
+    }, progress.part((numOfVertices + first) / numOfElements, (numOfVertices + last) / numOfElements)));
+  }
+  zip.write(MODEL_FOOTER);
+  zip.endEntry();
+
+  zip.finish();
+  progress.update(1.0);
+}
+
+} // namespace conv
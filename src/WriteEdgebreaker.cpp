@@ -0,0 +1,78 @@
+#include "WriteEdgebreaker.h"
+#include "Edgebreaker.h"
+#include "Entropy.h"
+#include "Parallel.h"
+
+#include <cstring>
+
+
+namespace conv {
+
+/* number of vertices gathered by one task */
+constexpr size_t EDGEBREAKER_GATHER_BLOCK_SIZE = 16384u;
+
+void WriteEdgebreaker::write(std::ostream& stream, const MeshData& data, const Progress& progress) {
+  if (data.geometricVertices.size() >= std::numeric_limits<uint32_t>::max()) {
+    throw std::runtime_error("Too many vertices for a .3dfe file");
+  }
+
+  progress.update(0.0);
+
+  /* triangles of the faces (fans, like the triangles of the mesh) with 0-based indices */
+  std::vector<std::array<uint32_t, 3>> triangles;
+  triangles.reserve(data.triangles.size());
+  for (const auto& f : data.faces) {
+    for (uint32_t reference : f.geometricVertexReferences) {
+      if (0u == reference || reference > data.geometricVertices.size()) {
+        throw std::runtime_error("Invalid vertex reference: " + std::to_string(reference));
+      }
+    }
+
+    const auto& references = f.geometricVertexReferences;
+    for (size_t i = 1u; (i + 1u) < references.size(); ++i) {
+      triangles.push_back({references[0] - 1u, references[i] - 1u, references[i + 1u] - 1u});
+    }
+  }
+
+  const EncodedConnectivity connectivity = encodeConnectivity(triangles, data.geometricVertices.size());
+  progress.update(0.5);
+
+  /* positions in the order of the decoded vertices */
+  std::vector<uint8_t> positions(connectivity.vertexOrder.size() * 3u * sizeof(double));
+  parallelFor(connectivity.vertexOrder.size(), EDGEBREAKER_GATHER_BLOCK_SIZE, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      const glm::dvec4& v = data.geometricVertices[connectivity.vertexOrder[i]];
+      const double position[3] = {v.x, v.y, v.z};
+      std::memcpy(positions.data() + i * sizeof(position), position, sizeof(position));
+    }
+  });
+
+  const std::vector<uint8_t> encodedSymbols = entropyEncode(connectivity.symbols);
+  const std::vector<uint8_t> encodedIndices = entropyEncode(connectivity.indices);
+  const std::vector<uint8_t> encodedPositions = entropyEncode(positions);
+  progress.update(0.9);
+
+  EdgebreakerHeader header;
+  std::memcpy(header.magic, EDGEBREAKER_MAGIC, sizeof(EDGEBREAKER_MAGIC));
+  header.version = EDGEBREAKER_VERSION;
+  header.byteOrderMark = EDGEBREAKER_BYTE_ORDER_MARK;
+  header.numOfVertices = connectivity.vertexOrder.size();
+  header.numOfTriangles = triangles.size();
+  header.numOfSymbols = connectivity.symbols.size();
+  header.sizeOfIndices = connectivity.indices.size();
+  header.encodedSymbolsSize = encodedSymbols.size();
+  header.encodedIndicesSize = encodedIndices.size();
+  header.encodedPositionsSize = encodedPositions.size();
+
+  stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  for (const auto* section : {&encodedSymbols, &encodedIndices, &encodedPositions}) {
+    stream.write(reinterpret_cast<const char*>(section->data()), static_cast<std::streamsize>(section->size()));
+  }
+
+  if (stream.bad()) {
+    throw std::runtime_error("Unable to write file at buffer");
+  }
+  progress.update(1.0);
+}
+
+} // namespace conv
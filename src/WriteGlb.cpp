@@ -0,0 +1,302 @@
+#include "WriteGlb.h"
+#include "Hash.h"
+#include "Parallel.h"
+
+#include <array>
+#include <charconv>
+#include <cstring>
+#include <sstream>
+#include <unordered_map>
+
+
+namespace conv {
+
+/* binary glTF container */
+constexpr uint32_t GLB_MAGIC = 0x46546C67u;
+constexpr uint32_t GLB_VERSION = 2u;
+constexpr uint32_t GLB_CHUNK_TYPE_JSON = 0x4E4F534Au;
+constexpr uint32_t GLB_CHUNK_TYPE_BIN = 0x004E4942u;
+
+/* glTF constants of the accessors and buffer views */
+constexpr uint32_t COMPONENT_TYPE_UNSIGNED_SHORT = 5123u;
+constexpr uint32_t COMPONENT_TYPE_UNSIGNED_INT = 5125u;
+constexpr uint32_t COMPONENT_TYPE_FLOAT = 5126u;
+constexpr uint32_t TARGET_ARRAY_BUFFER = 34962u;
+constexpr uint32_t TARGET_ELEMENT_ARRAY_BUFFER = 34963u;
+
+/* 16 bit indices are used below this number of vertices (65535 is the primitive restart value) */
+constexpr size_t MAX_NUM_OF_SHORT_INDEXED_VERTICES = 65535u;
+
+/* number of faces or vertices encoded by one task */
+constexpr size_t GLB_ENCODE_BLOCK_SIZE = 16384u;
+
+namespace {
+
+/* references of a face corner, equal corners become one vertex */
+struct Corner {
+  uint32_t position = 0u;
+  uint32_t normal = 0u;
+  uint32_t texture = 0u;
+
+  bool operator== (const Corner& other) const {
+    return position == other.position && normal == other.normal && texture == other.texture;
+  }
+};
+
+struct CornerHash {
+  size_t operator() (const Corner& corner) const {
+    return static_cast<size_t>(hash64(&corner, sizeof(corner)));
+  }
+};
+
+/* part of the BIN chunk read by an accessor */
+struct BufferSection {
+  size_t offset = 0u;
+  size_t size = 0u;
+};
+
+/* function to round the size up to a multiple of 4 (chunks and accessors are 4-byte aligned) */
+size_t alignTo4(size_t size) {
+  return (size + 3u) & ~static_cast<size_t>(3u);
+}
+
+/* function to format the value as the shortest text that reads back to the same float */
+std::string formatFloat(float value) {
+  char text[32];
+  return std::string(text, std::to_chars(text, text + sizeof(text), value).ptr);
+}
+
+/* function to check whether every face references a value of the given kind for each of its corners */
+bool isReferencedByEveryFace(const MeshData& data, std::vector<uint32_t> Face::*references, size_t numOfValues) {
+  if (0u == numOfValues) {
+    return false;
+  }
+
+  for (const auto& f : data.faces) {
+    if (f.geometricVertexReferences.size() >= 3u && (f.*references).size() != f.geometricVertexReferences.size()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/* function to encode the attribute of the vertices as floats, returns the minimum and the maximum of the components */
+template <size_t N, typename Value>
+std::pair<std::array<float, N>, std::array<float, N>> encodeAttribute(size_t numOfVertices, uint8_t* target,
+                                                                     const Value& value, const Progress& progress) {
+  const size_t numOfBlocks = (numOfVertices + GLB_ENCODE_BLOCK_SIZE - 1u) / GLB_ENCODE_BLOCK_SIZE;
+  std::vector<std::array<float, N>> minimums(numOfBlocks);
+  std::vector<std::array<float, N>> maximums(numOfBlocks);
+
+  parallelFor(numOfBlocks, 1u, [&](size_t begin, size_t end) {
+    for (size_t b = begin; b < end; ++b) {
+      progress.checkCancelled();
+      minimums[b].fill(std::numeric_limits<float>::max());
+      maximums[b].fill(std::numeric_limits<float>::lowest());
+
+      for (size_t i = b * GLB_ENCODE_BLOCK_SIZE; i < std::min(numOfVertices, (b + 1u) * GLB_ENCODE_BLOCK_SIZE); ++i) {
+        const std::array<float, N> components = value(i);
+        std::memcpy(target + i * sizeof(components), components.data(), sizeof(components));
+        for (size_t c = 0u; c < N; ++c) {
+          minimums[b][c] = std::min(minimums[b][c], components[c]);
+          maximums[b][c] = std::max(maximums[b][c], components[c]);
+        }
+      }
+    }
+  });
+
+  std::array<float, N> minimum;
+  std::array<float, N> maximum;
+  minimum.fill(std::numeric_limits<float>::max());
+  maximum.fill(std::numeric_limits<float>::lowest());
+  for (size_t b = 0u; b < numOfBlocks; ++b) {
+    for (size_t c = 0u; c < N; ++c) {
+      minimum[c] = std::min(minimum[c], minimums[b][c]);
+      maximum[c] = std::max(maximum[c], maximums[b][c]);
+    }
+  }
+  return {minimum, maximum};
+}
+
+/* function to format the components as a JSON array */
+template <size_t N>
+std::string formatArray(const std::array<float, N>& values) {
+  std::string text = "[";
+  for (size_t c = 0u; c < N; ++c) {
+    text += (c ? "," : "") + formatFloat(values[c]);
+  }
+  return text + "]";
+}
+
+/* function to append a little endian 32 bit value to the buffer */
+void appendUint32(std::string& buffer, uint32_t value) {
+  for (uint32_t i = 0u; i < 4u; ++i) {
+    buffer.push_back(static_cast<char>((value >> (8u * i)) & 0xFFu));
+  }
+}
+
+} // namespace
+
+void WriteGlb::write(std::ostream& stream, const MeshData& data, const Progress& progress) {
+  progress.update(0.0);
+
+  const bool hasNormals = isReferencedByEveryFace(data, &Face::vertexNormalReferences, data.vertexNormals.size());
+  const bool hasTextures = isReferencedByEveryFace(data, &Face::textureVertexReferences, data.textureVertices.size());
+
+  /* corners of the triangles of the faces (fans, like the triangles of the mesh) */
+  std::vector<size_t> firstTriangle(data.faces.size() + 1u, 0u);
+  for (size_t i = 0u; i < data.faces.size(); ++i) {
+    const size_t numOfVertices = data.faces[i].geometricVertexReferences.size();
+    firstTriangle[i + 1u] = firstTriangle[i] + ((numOfVertices > 2u) ? (numOfVertices - 2u) : 0u);
+  }
+
+  std::vector<Corner> corners(3u * firstTriangle.back());
+  parallelFor(data.faces.size(), GLB_ENCODE_BLOCK_SIZE, [&](size_t begin, size_t end) {
+    for (size_t j = begin; j < end; ++j) {
+      const Face& f = data.faces[j];
+      auto corner = [&](size_t k) {
+        return Corner{f.geometricVertexReferences[k], hasNormals ? f.vertexNormalReferences[k] : 0u,
+                      hasTextures ? f.textureVertexReferences[k] : 0u};
+      };
+
+      for (size_t i = 1u; (i + 1u) < f.geometricVertexReferences.size(); ++i) {
+        Corner* triangle = corners.data() + 3u * (firstTriangle[j] + i - 1u);
+        triangle[0] = corner(0u);
+        triangle[1] = corner(i);
+        triangle[2] = corner(i + 1u);
+      }
+    }
+  });
+
+  /* deduplicate the corners, the vertices keep the order of their first corner */
+  std::vector<Corner> vertices;
+  std::vector<uint32_t> indices(corners.size());
+  {
+    std::unordered_map<Corner, uint32_t, CornerHash> vertexOfCorner;
+    vertexOfCorner.reserve(corners.size() / 2u);
+    for (size_t i = 0u; i < corners.size(); ++i) {
+      auto inserted = vertexOfCorner.emplace(corners[i], static_cast<uint32_t>(vertices.size()));
+      if (inserted.second) {
+        vertices.emplace_back(corners[i]);
+      }
+      indices[i] = inserted.first->second;
+    }
+  }
+  std::vector<Corner>().swap(corners);
+  progress.update(0.4);
+
+  /* layout of the BIN chunk */
+  const bool isShortIndexed = vertices.size() < MAX_NUM_OF_SHORT_INDEXED_VERTICES;
+  const size_t indexSize = isShortIndexed ? sizeof(uint16_t) : sizeof(uint32_t);
+  BufferSection positionSection{0u, vertices.size() * 3u * sizeof(float)};
+  BufferSection normalSection{alignTo4(positionSection.offset + positionSection.size), hasNormals ? vertices.size() * 3u * sizeof(float) : 0u};
+  BufferSection textureSection{alignTo4(normalSection.offset + normalSection.size), hasTextures ? vertices.size() * 2u * sizeof(float) : 0u};
+  BufferSection indexSection{alignTo4(textureSection.offset + textureSection.size), indices.size() * indexSize};
+  std::vector<uint8_t> bin(alignTo4(indexSection.offset + indexSection.size), 0u);
+
+  /* vertex attributes, the bounds of the positions are found while they are encoded */
+  auto positionBounds = encodeAttribute<3u>(vertices.size(), bin.data() + positionSection.offset, [&](size_t i) {
+    const glm::dvec4& v = data.geometricVertices[vertices[i].position - 1u];
+    return std::array<float, 3u>{static_cast<float>(v.x), static_cast<float>(v.y), static_cast<float>(v.z)};
+  }, progress);
+
+  if (hasNormals) {
+    encodeAttribute<3u>(vertices.size(), bin.data() + normalSection.offset, [&](size_t i) {
+      glm::dvec3 n = data.vertexNormals[vertices[i].normal - 1u];
+      n = (glm::length(n) > 0.0) ? glm::normalize(n) : glm::dvec3(0.0, 0.0, 1.0);
+      return std::array<float, 3u>{static_cast<float>(n.x), static_cast<float>(n.y), static_cast<float>(n.z)};
+    }, progress);
+  }
+
+  /* glTF texture coordinates start at the top left corner of the image */
+  if (hasTextures) {
+    encodeAttribute<2u>(vertices.size(), bin.data() + textureSection.offset, [&](size_t i) {
+      const glm::dvec3& t = data.textureVertices[vertices[i].texture - 1u];
+      return std::array<float, 2u>{static_cast<float>(t.x), static_cast<float>(1.0 - t.y)};
+    }, progress);
+  }
+
+  parallelFor(indices.size(), GLB_ENCODE_BLOCK_SIZE, [&](size_t begin, size_t end) {
+    uint8_t* target = bin.data() + indexSection.offset;
+    for (size_t i = begin; i < end; ++i) {
+      if (isShortIndexed) {
+        const uint16_t index = static_cast<uint16_t>(indices[i]);
+        std::memcpy(target + i * sizeof(index), &index, sizeof(index));
+      } else {
+        std::memcpy(target + i * sizeof(uint32_t), &indices[i], sizeof(uint32_t));
+      }
+    }
+  });
+  progress.update(0.8);
+
+  /* JSON chunk, a mesh without triangles is an empty scene */
+  std::ostringstream json;
+  json << "{\"asset\":{\"version\":\"2.0\",\"generator\":\"3dfc\"},\"scene\":0,";
+  if (indices.empty()) {
+    json << "\"scenes\":[{\"nodes\":[]}]}";
+    bin.clear();
+  } else {
+    std::vector<std::pair<BufferSection, uint32_t>> views{{positionSection, TARGET_ARRAY_BUFFER}};
+    std::ostringstream attributes;
+    std::ostringstream accessors;
+    attributes << "\"POSITION\":0";
+    accessors << "{\"bufferView\":0,\"componentType\":" << COMPONENT_TYPE_FLOAT << ",\"count\":" << vertices.size()
+              << ",\"type\":\"VEC3\",\"min\":" << formatArray(positionBounds.first)
+              << ",\"max\":" << formatArray(positionBounds.second) << "}";
+    if (hasNormals) {
+      attributes << ",\"NORMAL\":" << views.size();
+      accessors << ",{\"bufferView\":" << views.size() << ",\"componentType\":" << COMPONENT_TYPE_FLOAT
+                << ",\"count\":" << vertices.size() << ",\"type\":\"VEC3\"}";
+      views.push_back({normalSection, TARGET_ARRAY_BUFFER});
+    }
+    if (hasTextures) {
+      attributes << ",\"TEXCOORD_0\":" << views.size();
+      accessors << ",{\"bufferView\":" << views.size() << ",\"componentType\":" << COMPONENT_TYPE_FLOAT
+                << ",\"count\":" << vertices.size() << ",\"type\":\"VEC2\"}";
+      views.push_back({textureSection, TARGET_ARRAY_BUFFER});
+    }
+    const size_t indexAccessor = views.size();
+    accessors << ",{\"bufferView\":" << indexAccessor << ",\"componentType\":"
+              << (isShortIndexed ? COMPONENT_TYPE_UNSIGNED_SHORT : COMPONENT_TYPE_UNSIGNED_INT)
+              << ",\"count\":" << indices.size() << ",\"type\":\"SCALAR\"}";
+    views.push_back({indexSection, TARGET_ELEMENT_ARRAY_BUFFER});
+
+    json << "\"scenes\":[{\"nodes\":[0]}],\"nodes\":[{\"mesh\":0}],"
+         << "\"meshes\":[{\"primitives\":[{\"attributes\":{" << attributes.str() << "},\"indices\":" << indexAccessor
+         << ",\"mode\":4}]}],\"buffers\":[{\"byteLength\":" << bin.size() << "}],\"bufferViews\":[";
+    for (size_t v = 0u; v < views.size(); ++v) {
+      json << (v ? "," : "") << "{\"buffer\":0,\"byteOffset\":" << views[v].first.offset << ",\"byteLength\":"
+           << views[v].first.size << ",\"target\":" << views[v].second << "}";
+    }
+    json << "],\"accessors\":[" << accessors.str() << "]}";
+  }
+
+  std::string jsonChunk = json.str();
+  jsonChunk.resize(alignTo4(jsonChunk.size()), ' ');
+
+  /* header and JSON chunk, then the BIN chunk with one write */
+  const size_t totalSize = 12u + 8u + jsonChunk.size() + (bin.empty() ? 0u : (8u + bin.size()));
+  if (totalSize > std::numeric_limits<uint32_t>::max()) {
+    throw std::runtime_error("Mesh is too large for a GLB file");
+  }
+
+  std::string head;
+  appendUint32(head, GLB_MAGIC);
+  appendUint32(head, GLB_VERSION);
+  appendUint32(head, static_cast<uint32_t>(totalSize));
+  appendUint32(head, static_cast<uint32_t>(jsonChunk.size()));
+  appendUint32(head, GLB_CHUNK_TYPE_JSON);
+  head += jsonChunk;
+  if (!bin.empty()) {
+    appendUint32(head, static_cast<uint32_t>(bin.size()));
+    appendUint32(head, GLB_CHUNK_TYPE_BIN);
+  }
+  stream.write(head.data(), static_cast<std::streamsize>(head.size()));
+  stream.write(reinterpret_cast<const char*>(bin.data()), static_cast<std::streamsize>(bin.size()));
+  if (stream.bad()) {
+    throw std::runtime_error("Unable to write file at buffer");
+  }
+  progress.update(1.0);
+}
+
+} // namespace conv
@@ -0,0 +1,108 @@
+#include "WriteNative.h"
+#include "Hash.h"
+#include "NativeMesh.h"
+#include "Parallel.h"
+
+#include <cstddef>
+#include <cstring>
+
+
+namespace conv {
+
+/* number of faces gathered by one task */
+constexpr size_t NATIVE_GATHER_BLOCK_SIZE = 16384u;
+
+namespace {
+
+/* references of the faces of one kind, gathered into one array */
+struct GatheredReferences {
+  std::vector<uint64_t> offsets;
+  std::vector<uint32_t> references;
+};
+
+/* function to gather the references of a kind, nothing if no face has references of the kind (unless required) */
+GatheredReferences gather(const MeshData& data, std::vector<uint32_t> Face::*references, bool isRequired) {
+  GatheredReferences result;
+  const bool hasReferences = std::any_of(data.faces.begin(), data.faces.end(), [&](const Face& f) { return !(f.*references).empty(); });
+  if (!hasReferences && !isRequired) {
+    return result;
+  }
+
+  result.offsets.resize(data.faces.size() + 1u, 0u);
+  for (size_t i = 0u; i < data.faces.size(); ++i) {
+    result.offsets[i + 1u] = result.offsets[i] + (data.faces[i].*references).size();
+  }
+
+  result.references.resize(result.offsets.back());
+  parallelFor(data.faces.size(), NATIVE_GATHER_BLOCK_SIZE, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      std::copy((data.faces[i].*references).begin(), (data.faces[i].*references).end(),
+                result.references.begin() + result.offsets[i]);
+    }
+  });
+  return result;
+}
+
+} // namespace
+
+void WriteNative::write(std::ostream& stream, const MeshData& data, const Progress& progress) {
+  progress.update(0.0);
+
+  const GatheredReferences geometric = gather(data, &Face::geometricVertexReferences, true);
+  const GatheredReferences texture = gather(data, &Face::textureVertexReferences, false);
+  const GatheredReferences normal = gather(data, &Face::vertexNormalReferences, false);
+  progress.update(0.4);
+
+  /* bytes and number of elements of the sections, in the order of NativeSection */
+  const std::pair<const void*, size_t> sections[NATIVE_NUM_OF_SECTIONS] = {
+      {data.geometricVertices.data(), data.geometricVertices.size()},
+      {data.textureVertices.data(), data.textureVertices.size()},
+      {data.vertexNormals.data(), data.vertexNormals.size()},
+      {geometric.offsets.data(), geometric.offsets.size()},
+      {geometric.references.data(), geometric.references.size()},
+      {texture.offsets.data(), texture.offsets.size()},
+      {texture.references.data(), texture.references.size()},
+      {normal.offsets.data(), normal.offsets.size()},
+      {normal.references.data(), normal.references.size()}};
+
+  NativeHeader header;
+  std::memcpy(header.magic, NATIVE_MAGIC, sizeof(NATIVE_MAGIC));
+  header.version = NATIVE_VERSION;
+  header.byteOrderMark = NATIVE_BYTE_ORDER_MARK;
+  header.numOfFaces = data.faces.size();
+
+  size_t offset = sizeof(NativeHeader);
+  for (uint32_t s = 0u; s < NATIVE_NUM_OF_SECTIONS; ++s) {
+    offset = (offset + NATIVE_SECTION_ALIGNMENT - 1u) / NATIVE_SECTION_ALIGNMENT * NATIVE_SECTION_ALIGNMENT;
+    header.sections[s].offset = offset;
+    header.sections[s].count = sections[s].second;
+    offset += sections[s].second * NativeMesh::elementSize(static_cast<NativeSection>(s));
+  }
+
+  parallelFor(NATIVE_NUM_OF_SECTIONS, 1u, [&](size_t begin, size_t end) {
+    for (size_t s = begin; s < end; ++s) {
+      const size_t sizeInBytes = sections[s].second * NativeMesh::elementSize(static_cast<NativeSection>(s));
+      header.sections[s].checksum = hash64(sections[s].first, sizeInBytes);
+    }
+  });
+  header.checksum = hash64(&header, offsetof(NativeHeader, checksum));
+  progress.update(0.6);
+
+  /* the sections are written as they are, with zeros up to their aligned positions */
+  static const char PADDING[NATIVE_SECTION_ALIGNMENT] = {};
+  stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  size_t position = sizeof(header);
+  for (uint32_t s = 0u; s < NATIVE_NUM_OF_SECTIONS; ++s) {
+    const size_t sizeInBytes = sections[s].second * NativeMesh::elementSize(static_cast<NativeSection>(s));
+    stream.write(PADDING, static_cast<std::streamsize>(header.sections[s].offset - position));
+    stream.write(static_cast<const char*>(sections[s].first), static_cast<std::streamsize>(sizeInBytes));
+    position = header.sections[s].offset + sizeInBytes;
+  }
+
+  if (stream.bad()) {
+    throw std::runtime_error("Unable to write file at buffer");
+  }
+  progress.update(1.0);
+}
+
+} // namespace conv
@@ -0,0 +1,113 @@
+#include "WriteObj.h"
+#include "TextWriter.h"
+
+
+namespace conv {
+
+/* upper bound of the text of a vertex line (4 numbers of at most 24 characters and the keyword) */
+constexpr size_t MAX_OBJ_VERTEX_SIZE_IN_BYTES = 112u;
+
+/* upper bound of the text of a face corner (3 indices of at most 10 digits, 2 slashes and a space) */
+constexpr size_t MAX_OBJ_CORNER_SIZE_IN_BYTES = 33u;
+
+namespace {
+
+/* function to append " v", " v/vt", " v//vn" or " v/vt/vn" of the face corner to the buffer */
+char* appendCorner(char* buffer, const Face& f, size_t corner, bool hasTexture, bool hasNormal) {
+  buffer = appendValue(buffer, f.geometricVertexReferences[corner]);
+  if (hasTexture || hasNormal) {
+    *buffer++ = '/';
+  }
+  if (hasTexture) {
+    buffer = std::to_chars(buffer, buffer + 16, f.textureVertexReferences[corner]).ptr;
+  }
+  if (hasNormal) {
+    *buffer++ = '/';
+    buffer = std::to_chars(buffer, buffer + 16, f.vertexNormalReferences[corner]).ptr;
+  }
+  return buffer;
+}
+
+} // namespace
+
+void WriteObj::write(std::ostream& stream, const MeshData& data, const Progress& progress) {
+  progress.update(0.0);
+  stream << "# written by 3dfc\n";
+
+  /* the sections are reported by their number of lines */
+  const double numOfLines = static_cast<double>(data.geometricVertices.size() + data.textureVertices.size() +
+                                                data.vertexNormals.size() + data.faces.size());
+  double numOfWrittenLines = 0.0;
+  auto writeSection = [&](size_t numOfSectionLines, auto sizeOfBlock, auto format, const char* name) {
+    const double first = (numOfLines > 0.0) ? numOfWrittenLines / numOfLines : 0.0;
+    numOfWrittenLines += numOfSectionLines;
+    const double last = (numOfLines > 0.0) ? numOfWrittenLines / numOfLines : 1.0;
+
+    for (const auto& block : formatLines(numOfSectionLines, sizeOfBlock, format, progress.part(first, last))) {
+      stream.write(block.data(), static_cast<std::streamsize>(block.size()));
+    }
+    if (stream.bad()) {
+      throw std::runtime_error(std::string("Unable to write file at ") + name);
+    }
+  };
+  auto sizeOfVertices = [](size_t first, size_t last) { return (last - first) * MAX_OBJ_VERTEX_SIZE_IN_BYTES; };
+
+  /* v x y z (w), the weight only if it is not the default 1 */
+  writeSection(data.geometricVertices.size(), sizeOfVertices, [&](char* text, size_t i) {
+    const glm::dvec4& v = data.geometricVertices[i];
+    text = appendValue(appendValue(appendValue(appendText(text, "v"), v.x), v.y), v.z);
+    if (1.0 != v.w) {
+      text = appendValue(text, v.w);
+    }
+    *text++ = '\n';
+    return text;
+  }, "vertices");
+
+  /* vt u v (w), the depth only if it is not the default 0 */
+  writeSection(data.textureVertices.size(), sizeOfVertices, [&](char* text, size_t i) {
+    const glm::dvec3& t = data.textureVertices[i];
+    text = appendValue(appendValue(appendText(text, "vt"), t.x), t.y);
+    if (0.0 != t.z) {
+      text = appendValue(text, t.z);
+    }
+    *text++ = '\n';
+    return text;
+  }, "texture vertices");
+
+  /* vn i j k */
+  writeSection(data.vertexNormals.size(), sizeOfVertices, [&](char* text, size_t i) {
+    const glm::dvec3& n = data.vertexNormals[i];
+    text = appendValue(appendValue(appendValue(appendText(text, "vn"), n.x), n.y), n.z);
+    *text++ = '\n';
+    return text;
+  }, "vertex normals");
+
+  /* f with the variant of the face: the texture and normal references only if there is one for every corner */
+  auto sizeOfFaces = [&](size_t first, size_t last) {
+    size_t size = 0u;
+    for (size_t i = first; i < last; ++i) {
+      size += 2u + (data.faces[i].geometricVertexReferences.size() + 1u) * MAX_OBJ_CORNER_SIZE_IN_BYTES;
+    }
+    return size;
+  };
+  writeSection(data.faces.size(), sizeOfFaces, [&](char* text, size_t i) {
+    const Face& f = data.faces[i];
+    const size_t numOfCorners = f.geometricVertexReferences.size();
+    const bool hasTexture = (f.textureVertexReferences.size() == numOfCorners);
+    const bool hasNormal = (f.vertexNormalReferences.size() == numOfCorners);
+    if (0u == numOfCorners) {
+      return text;
+    }
+
+    text = appendText(text, "f");
+    for (size_t corner = 0u; corner < numOfCorners; ++corner) {
+      text = appendCorner(text, f, corner, hasTexture, hasNormal);
+    }
+    *text++ = '\n';
+    return text;
+  }, "faces");
+
+  progress.update(1.0);
+}
+
+} // namespace conv
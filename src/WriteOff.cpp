@@ -0,0 +1,64 @@
+#include "WriteOff.h"
+#include "TextWriter.h"
+
+
+namespace conv {
+
+/* upper bound of the text of a vertex line (3 numbers of at most 24 characters) */
+constexpr size_t MAX_OFF_VERTEX_SIZE_IN_BYTES = 80u;
+
+/* upper bound of the text of a face index (at most 10 digits and a space) */
+constexpr size_t MAX_OFF_INDEX_SIZE_IN_BYTES = 11u;
+
+void WriteOff::write(std::ostream& stream, const MeshData& data, const Progress& progress) {
+  progress.update(0.0);
+
+  /* the number of edges is not needed by the readers, it is written as 0 */
+  stream << "OFF\n" << data.geometricVertices.size() << " " << data.faces.size() << " 0\n";
+
+  /* x y z (formatting is reported by the share of the lines) */
+  const double vertexShare = static_cast<double>(data.geometricVertices.size()) /
+                             std::max<size_t>(1u, data.geometricVertices.size() + data.faces.size());
+  auto vertices = formatLines(data.geometricVertices.size(), [](size_t first, size_t last) {
+    return (last - first) * MAX_OFF_VERTEX_SIZE_IN_BYTES;
+  }, [&](char* text, size_t i) {
+    const glm::dvec4& v = data.geometricVertices[i];
+    text = std::to_chars(text, text + 32, v.x).ptr;
+    text = appendValue(appendValue(text, v.y), v.z);
+    *text++ = '\n';
+    return text;
+  }, progress.part(0.0, vertexShare));
+  for (const auto& block : vertices) {
+    stream.write(block.data(), static_cast<std::streamsize>(block.size()));
+  }
+  if (stream.bad()) {
+    throw std::runtime_error("Unable to write file at vertices");
+  }
+  std::vector<std::string>().swap(vertices);
+
+  /* n v1 v2 ... vn with 0-based indices */
+  auto faces = formatLines(data.faces.size(), [&](size_t first, size_t last) {
+    size_t size = 0u;
+    for (size_t i = first; i < last; ++i) {
+      size += (data.faces[i].geometricVertexReferences.size() + 2u) * MAX_OFF_INDEX_SIZE_IN_BYTES;
+    }
+    return size;
+  }, [&](char* text, size_t i) {
+    const auto& references = data.faces[i].geometricVertexReferences;
+    text = std::to_chars(text, text + 16, references.size()).ptr;
+    for (uint32_t reference : references) {
+      text = appendValue(text, reference - 1u);
+    }
+    *text++ = '\n';
+    return text;
+  }, progress.part(vertexShare, 1.0));
+  for (const auto& block : faces) {
+    stream.write(block.data(), static_cast<std::streamsize>(block.size()));
+  }
+  if (stream.bad()) {
+    throw std::runtime_error("Unable to write file at faces");
+  }
+  progress.update(1.0);
+}
+
+} // namespace conv
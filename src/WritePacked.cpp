@@ -0,0 +1,198 @@
+#include "WritePacked.h"
+#include "Entropy.h"
+#include "Hash.h"
+#include "Parallel.h"
+
+#include <atomic>
+#include <cstring>
+#include <unordered_map>
+
+
+namespace conv {
+
+namespace {
+
+/* position quantized within the bounding box */
+struct QuantizedPosition {
+  uint32_t x = 0u;
+  uint32_t y = 0u;
+  uint32_t z = 0u;
+
+  bool operator== (const QuantizedPosition& other) const {
+    return x == other.x && y == other.y && z == other.z;
+  }
+};
+
+struct QuantizedPositionHash {
+  size_t operator() (const QuantizedPosition& position) const {
+    return static_cast<size_t>(hash64(&position, sizeof(position)));
+  }
+};
+
+/* function to append the difference of the coordinates as zigzag variable-length integers */
+void appendDelta(std::vector<uint8_t>& bytes, const QuantizedPosition& position, const QuantizedPosition& previous) {
+  appendVarint(bytes, zigzag(static_cast<int64_t>(position.x) - previous.x));
+  appendVarint(bytes, zigzag(static_cast<int64_t>(position.y) - previous.y));
+  appendVarint(bytes, zigzag(static_cast<int64_t>(position.z) - previous.z));
+}
+
+} // namespace
+
+WritePacked::WritePacked(uint32_t quantizationBits) : quantizationBits_(quantizationBits) {
+  if (quantizationBits < PACKED_MIN_QUANTIZATION_BITS || quantizationBits > PACKED_MAX_QUANTIZATION_BITS) {
+    throw std::invalid_argument("Invalid number of quantization bits: " + std::to_string(quantizationBits));
+  }
+}
+
+void WritePacked::write(std::ostream& stream, const MeshData& data, const Progress& progress) {
+  if (data.geometricVertices.size() >= std::numeric_limits<uint32_t>::max()) {
+    throw std::runtime_error("Too many vertices for a .3dfz file");
+  }
+
+  progress.update(0.0);
+
+  /* bounding box of the vertices */
+  const size_t numOfVertices = data.geometricVertices.size();
+  glm::dvec3 boundsMin(0.0, 0.0, 0.0);
+  glm::dvec3 boundsMax(0.0, 0.0, 0.0);
+  if (0u != numOfVertices) {
+    boundsMin = boundsMax = glm::dvec3(data.geometricVertices[0]);
+    for (const auto& v : data.geometricVertices) {
+      boundsMin = glm::min(boundsMin, glm::dvec3(v));
+      boundsMax = glm::max(boundsMax, glm::dvec3(v));
+    }
+  }
+
+  /* quantization */
+  const double maxQuantized = static_cast<double>((1u << quantizationBits_) - 1u);
+  const glm::dvec3 extent = boundsMax - boundsMin;
+  std::vector<QuantizedPosition> quantized(numOfVertices);
+  parallelFor(numOfVertices, PACKED_BLOCK_SIZE, [&](size_t begin, size_t end) {
+    progress.checkCancelled();
+    for (size_t i = begin; i < end; ++i) {
+      uint32_t q[3];
+      for (glm::length_t c = 0; c < 3; ++c) {
+        const double scaled = (extent[c] > 0.0) ? (data.geometricVertices[i][c] - boundsMin[c]) / extent[c] * maxQuantized : 0.0;
+        q[c] = static_cast<uint32_t>(std::llround(std::clamp(scaled, 0.0, maxQuantized)));
+      }
+      quantized[i] = QuantizedPosition{q[0], q[1], q[2]};
+    }
+  });
+
+  /* vertices on the same quantized position are merged */
+  std::vector<uint32_t> mergedVertexOf(numOfVertices);
+  std::vector<uint32_t> firstVertexOf;
+  {
+    std::unordered_map<QuantizedPosition, uint32_t, QuantizedPositionHash> mergedVertexOfPosition;
+    mergedVertexOfPosition.reserve(numOfVertices);
+    for (size_t i = 0u; i < numOfVertices; ++i) {
+      auto inserted = mergedVertexOfPosition.emplace(quantized[i], static_cast<uint32_t>(firstVertexOf.size()));
+      if (inserted.second) {
+        firstVertexOf.emplace_back(static_cast<uint32_t>(i));
+      }
+      mergedVertexOf[i] = inserted.first->second;
+    }
+  }
+
+  /* vertices numbered in the order of their first use, the unused ones at the end */
+  const uint32_t UNUSED = std::numeric_limits<uint32_t>::max();
+  const size_t numOfFaceBlocks = (data.faces.size() + PACKED_BLOCK_SIZE - 1u) / PACKED_BLOCK_SIZE;
+  std::vector<uint32_t> newIndexOf(firstVertexOf.size(), UNUSED);
+  std::vector<uint32_t> order;
+  std::vector<uint32_t> watermarks(numOfFaceBlocks);
+  order.reserve(firstVertexOf.size());
+  for (size_t f = 0u; f < data.faces.size(); ++f) {
+    if (f % PACKED_BLOCK_SIZE == 0u) {
+      watermarks[f / PACKED_BLOCK_SIZE] = static_cast<uint32_t>(order.size());
+    }
+
+    for (uint32_t reference : data.faces[f].geometricVertexReferences) {
+      if (0u == reference || reference > numOfVertices) {
+        throw std::runtime_error("Invalid vertex reference: " + std::to_string(reference));
+      }
+
+      const uint32_t merged = mergedVertexOf[reference - 1u];
+      if (newIndexOf[merged] == UNUSED) {
+        newIndexOf[merged] = static_cast<uint32_t>(order.size());
+        order.emplace_back(merged);
+      }
+    }
+  }
+  for (uint32_t merged = 0u; merged < firstVertexOf.size(); ++merged) {
+    if (newIndexOf[merged] == UNUSED) {
+      newIndexOf[merged] = static_cast<uint32_t>(order.size());
+      order.emplace_back(merged);
+    }
+  }
+  progress.update(0.3);
+
+  /* every block is encoded on its own */
+  const size_t numOfVertexBlocks = (order.size() + PACKED_BLOCK_SIZE - 1u) / PACKED_BLOCK_SIZE;
+  std::vector<std::vector<uint8_t>> blocks(numOfVertexBlocks + numOfFaceBlocks);
+  std::vector<PackedBlockHeader> blockHeaders(blocks.size());
+  std::atomic<size_t> numOfEncodedBlocks{0u};
+  parallelFor(blocks.size(), 1u, [&](size_t begin, size_t end) {
+    for (size_t b = begin; b < end; ++b) {
+      progress.checkCancelled();
+
+      std::vector<uint8_t> raw;
+      if (b < numOfVertexBlocks) {
+        const size_t first = b * PACKED_BLOCK_SIZE;
+        const size_t last = std::min(order.size(), first + PACKED_BLOCK_SIZE);
+        QuantizedPosition previous;
+        for (size_t i = first; i < last; ++i) {
+          const QuantizedPosition& position = quantized[firstVertexOf[order[i]]];
+          appendDelta(raw, position, previous);
+          previous = position;
+        }
+        blockHeaders[b].count = static_cast<uint32_t>(last - first);
+      } else {
+        const size_t first = (b - numOfVertexBlocks) * PACKED_BLOCK_SIZE;
+        const size_t last = std::min(data.faces.size(), first + PACKED_BLOCK_SIZE);
+        uint32_t watermark = watermarks[b - numOfVertexBlocks];
+        for (size_t f = first; f < last; ++f) {
+          const auto& references = data.faces[f].geometricVertexReferences;
+          appendVarint(raw, references.size());
+          for (uint32_t reference : references) {
+            const uint32_t index = newIndexOf[mergedVertexOf[reference - 1u]];
+            appendVarint(raw, watermark - index);
+            watermark = std::max(watermark, index + 1u);
+          }
+        }
+        blockHeaders[b].count = static_cast<uint32_t>(last - first);
+        blockHeaders[b].watermark = watermarks[b - numOfVertexBlocks];
+      }
+
+      blocks[b] = entropyEncode(raw);
+      blockHeaders[b].encodedSize = static_cast<uint32_t>(blocks[b].size());
+      progress.update(0.3 + 0.6 * static_cast<double>(++numOfEncodedBlocks) / blocks.size());
+    }
+  });
+
+  PackedHeader header;
+  std::memcpy(header.magic, PACKED_MAGIC, sizeof(PACKED_MAGIC));
+  header.version = PACKED_VERSION;
+  header.byteOrderMark = PACKED_BYTE_ORDER_MARK;
+  header.quantizationBits = quantizationBits_;
+  header.numOfVertices = order.size();
+  header.numOfFaces = data.faces.size();
+  for (glm::length_t c = 0; c < 3; ++c) {
+    header.boundsMin[c] = boundsMin[c];
+    header.boundsMax[c] = boundsMax[c];
+  }
+  header.numOfVertexBlocks = static_cast<uint32_t>(numOfVertexBlocks);
+  header.numOfFaceBlocks = static_cast<uint32_t>(numOfFaceBlocks);
+
+  stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  for (size_t b = 0u; b < blocks.size(); ++b) {
+    stream.write(reinterpret_cast<const char*>(&blockHeaders[b]), sizeof(blockHeaders[b]));
+    stream.write(reinterpret_cast<const char*>(blocks[b].data()), static_cast<std::streamsize>(blocks[b].size()));
+  }
+
+  if (stream.bad()) {
+    throw std::runtime_error("Unable to write file at buffer");
+  }
+  progress.update(1.0);
+}
+
+} // namespace conv
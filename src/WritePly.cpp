@@ -0,0 +1,135 @@
+#include "WritePly.h"
+#include "Parallel.h"
+
+#include <cstring>
+
+
+namespace conv {
+
+/* number of vertices or faces encoded by one task */
+constexpr size_t PLY_ENCODE_BLOCK_SIZE = 16384u;
+
+namespace {
+
+/* function to check whether the references of every face equal its vertex references */
+bool isPerVertex(const MeshData& data, std::vector<uint32_t> Face::*references, size_t numOfValues) {
+  if (numOfValues != data.geometricVertices.size() || 0u == numOfValues) {
+    return false;
+  }
+
+  std::atomic<bool> isEqual{true};
+  parallelFor(data.faces.size(), PLY_ENCODE_BLOCK_SIZE, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end && isEqual; ++i) {
+      if (data.faces[i].*references != data.faces[i].geometricVertexReferences) {
+        isEqual = false;
+      }
+    }
+  });
+  return isEqual;
+}
+
+/* function to append the values as REAL32 to the record */
+uint8_t* appendFloats(uint8_t* record, std::initializer_list<double> values) {
+  for (double value : values) {
+    const float f = static_cast<float>(value);
+    std::memcpy(record, &f, sizeof(f));
+    record += sizeof(f);
+  }
+  return record;
+}
+
+} // namespace
+
+void WritePly::write(std::ostream& stream, const MeshData& data, const Progress& progress) {
+  progress.update(0.0);
+
+  const bool hasNormals = isPerVertex(data, &Face::vertexNormalReferences, data.vertexNormals.size());
+  const bool hasTextures = isPerVertex(data, &Face::textureVertexReferences, data.textureVertices.size());
+
+  /* faces with more than 255 vertices need a wider count */
+  size_t maxNumOfFaceVertices = 0u;
+  std::vector<size_t> faceOffsets(data.faces.size() + 1u, 0u);
+  for (size_t i = 0u; i < data.faces.size(); ++i) {
+    const size_t numOfVertices = data.faces[i].geometricVertexReferences.size();
+    maxNumOfFaceVertices = std::max(maxNumOfFaceVertices, numOfVertices);
+    faceOffsets[i + 1u] = faceOffsets[i] + numOfVertices * sizeof(int32_t);
+  }
+  const size_t countSize = (maxNumOfFaceVertices > std::numeric_limits<uint8_t>::max()) ? sizeof(uint32_t) : sizeof(uint8_t);
+
+  /* header */
+  stream << "ply\n"
+         << "format binary_little_endian 1.0\n"
+         << "comment written by 3dfc\n"
+         << "element vertex " << data.geometricVertices.size() << "\n"
+         << "property float x\nproperty float y\nproperty float z\n";
+  if (hasNormals) {
+    stream << "property float nx\nproperty float ny\nproperty float nz\n";
+  }
+  if (hasTextures) {
+    stream << "property float s\nproperty float t\n";
+  }
+  stream << "element face " << data.faces.size() << "\n"
+         << "property list " << ((countSize == sizeof(uint8_t)) ? "uchar" : "uint") << " int vertex_indices\n"
+         << "end_header\n";
+  if (stream.bad()) {
+    throw std::runtime_error("Unable to write file at header");
+  }
+
+  /* vertex section (encoding is reported as 40 %) */
+  const size_t vertexSize = (3u + (hasNormals ? 3u : 0u) + (hasTextures ? 2u : 0u)) * sizeof(float);
+  std::vector<uint8_t> vertices(data.geometricVertices.size() * vertexSize);
+  parallelFor(data.geometricVertices.size(), PLY_ENCODE_BLOCK_SIZE, [&](size_t begin, size_t end) {
+    progress.checkCancelled();
+    for (size_t i = begin; i < end; ++i) {
+      const glm::dvec4& v = data.geometricVertices[i];
+      uint8_t* record = appendFloats(vertices.data() + i * vertexSize, {v.x, v.y, v.z});
+      if (hasNormals) {
+        const glm::dvec3& n = data.vertexNormals[i];
+        record = appendFloats(record, {n.x, n.y, n.z});
+      }
+      if (hasTextures) {
+        const glm::dvec3& t = data.textureVertices[i];
+        appendFloats(record, {t.x, t.y});
+      }
+    }
+  });
+
+  stream.write(reinterpret_cast<const char*>(vertices.data()), static_cast<std::streamsize>(vertices.size()));
+  if (stream.bad()) {
+    throw std::runtime_error("Unable to write file at vertices");
+  }
+  std::vector<uint8_t>().swap(vertices);
+  progress.update(0.4);
+
+  /* face section, the references are 1-based, the indices of the file 0-based (reported as 40 %) */
+  std::vector<uint8_t> faces(faceOffsets.back() + data.faces.size() * countSize);
+  parallelFor(data.faces.size(), PLY_ENCODE_BLOCK_SIZE, [&](size_t begin, size_t end) {
+    progress.checkCancelled();
+    for (size_t i = begin; i < end; ++i) {
+      const auto& refs = data.faces[i].geometricVertexReferences;
+      uint8_t* record = faces.data() + faceOffsets[i] + i * countSize;
+      if (countSize == sizeof(uint8_t)) {
+        *record = static_cast<uint8_t>(refs.size());
+      } else {
+        const uint32_t count = static_cast<uint32_t>(refs.size());
+        std::memcpy(record, &count, sizeof(count));
+      }
+      record += countSize;
+
+      for (uint32_t r : refs) {
+        const int32_t index = static_cast<int32_t>(r - 1u);
+        std::memcpy(record, &index, sizeof(index));
+        record += sizeof(index);
+      }
+    }
+  });
+  progress.update(0.8);
+
+  stream.write(reinterpret_cast<const char*>(faces.data()), static_cast<std::streamsize>(faces.size()));
+  if (stream.bad()) {
+    throw std::runtime_error("Unable to write file at faces");
+  }
+  progress.update(1.0);
+}
+
+} // namespace conv
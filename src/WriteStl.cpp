@@ -1,25 +1,23 @@
 #include "WriteStl.h"
+#include "Parallel.h"
+
+#include <cstring>
 
 
 namespace conv {
 
 constexpr size_t HEADER_SIZE_IN_BYTES = 80u;
+constexpr size_t TRIANGLE_SIZE_IN_BYTES = 12u * sizeof(float) + sizeof(uint16_t);
 
-void WriteStl::write(const std::string& pathToFile, const MeshData& data) {
-  if (pathToFile.empty()) {
-    throw std::invalid_argument(std::string("No path to the output file: ") + pathToFile);
-  }
-
-  std::ofstream file(pathToFile, std::ios::out | std::ios::binary | std::ios::trunc);
-  if (!file.is_open()) {
-    throw std::runtime_error(std::string("Cannot open file for write: ") + pathToFile);
-  }
+/* number of triangles encoded by one task */
+constexpr size_t ENCODE_BLOCK_SIZE = 16384u;
 
+void WriteStl::write(std::ostream& stream, const MeshData& data, const Progress& progress) {
   /* structure of the binary .stl format */
   /* UINT8[80] - Header */
   uint8_t header[HEADER_SIZE_IN_BYTES] = {0u};
-  file.write(reinterpret_cast<char*>(header), sizeof(header));
-  if (file.bad()) {
+  stream.write(reinterpret_cast<char*>(header), sizeof(header));
+  if (stream.bad()) {
     throw std::runtime_error("Unable to write file at header");
   }
 
@@ -30,48 +28,47 @@ void WriteStl::write(const std::string& pathToFile, const MeshData& data) {
   byte[1] = (numOfTriangles >> 8u) & 0xFFu;
   byte[2] = (numOfTriangles >> 16u) & 0xFFu;
   byte[3] = (numOfTriangles >> 24u) & 0xFFu;
-  file.write(reinterpret_cast<char*>(byte), sizeof(byte));
-  if (file.bad()) {
+  stream.write(reinterpret_cast<char*>(byte), sizeof(byte));
+  if (stream.bad()) {
     throw std::runtime_error("Unable to write file at number of triangles");
   }
 
-  /* for each triangle */
-  for (const auto& t : data.triangles) {
-    /* REAL32[3] - Normal vector */
-    glm::dvec3 normalVector = t.normal;
-    file.write(reinterpret_cast<char*>(&normalVector), sizeof(normalVector));
-    if (file.bad()) {
-      throw std::runtime_error("Unable to write file at normal vector");
-    }
+  /* encode the triangles in parallel into one buffer, then write it at once (encoding is reported as 50 %) */
+  std::vector<char> buffer(data.triangles.size() * TRIANGLE_SIZE_IN_BYTES);
+  std::atomic<size_t> numOfEncoded{0u};
+  progress.update(0.0);
+  parallelFor(data.triangles.size(), ENCODE_BLOCK_SIZE, [&](size_t begin, size_t end) {
+    progress.checkCancelled();
+    for (size_t i = begin; i < end; ++i) {
+      const Triangle& t = data.triangles[i];
+      char* record = buffer.data() + i * TRIANGLE_SIZE_IN_BYTES;
 
-    /* REAL32[3] - Vertex 1 */
-    glm::dvec3 vertex1 = t.vertices[0];
-    file.write(reinterpret_cast<char*>(&vertex1), sizeof(vertex1));
-    if (file.bad()) {
-      throw std::runtime_error("Unable to write file at vertex 1");
-    }
+      /* REAL32[3] - Normal vector */
+      glm::vec3 normalVector(t.normal);
+      std::memcpy(record, &normalVector, sizeof(normalVector));
+      record += sizeof(normalVector);
 
-    /* REAL32[3] - Vertex 2 */
-    glm::dvec3 vertex2 = t.vertices[1];
-    file.write(reinterpret_cast<char*>(&vertex2), sizeof(vertex2));
-    if (file.bad()) {
-      throw std::runtime_error("Unable to write file at vertex 2");
-    }
+      /* REAL32[3] - Vertex 1, Vertex 2, Vertex 3 */
+      for (const auto& vertex : t.vertices) {
+        glm::vec3 v(vertex);
+        std::memcpy(record, &v, sizeof(v));
+        record += sizeof(v);
+      }
 
-    /* REAL32[3] - Vertex 3 */
-    glm::dvec3 vertex3 = t.vertices[2];
-    file.write(reinterpret_cast<char*>(&vertex3), sizeof(vertex3));
-    if (file.bad()) {
-      throw std::runtime_error("Unable to write file at vertex 3");
+      /* UINT16 - Attribute byte count */
+      uint16_t attribute = 0u;
+      std::memcpy(record, &attribute, sizeof(attribute));
     }
 
-    /* UINT16 - Attribute byte count */
-    uint16_t attribute = 0u;
-    file.write(reinterpret_cast<char*>(&attribute), sizeof(attribute));
-    if (file.bad()) {
-      throw std::runtime_error("Unable to write file at attribute byte count");
-    }
+    numOfEncoded += end - begin;
+    progress.update(0.5 * numOfEncoded / data.triangles.size());
+  });
+
+  stream.write(buffer.data(), buffer.size());
+  if (stream.bad()) {
+    throw std::runtime_error("Unable to write file at triangles");
   }
+  progress.update(1.0);
 }
 
 } // namespace conv
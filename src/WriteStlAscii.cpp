@@ -0,0 +1,63 @@
+#include "WriteStlAscii.h"
+#include "TextWriter.h"
+
+#include <filesystem>
+
+
+namespace conv {
+
+/* name of the solid written to a stream */
+const char* const DEFAULT_SOLID_NAME = "mesh";
+
+/* upper bound of the text of one facet (12 numbers of at most 24 characters and the keywords) */
+constexpr size_t MAX_FACET_SIZE_IN_BYTES = 512u;
+
+namespace {
+
+/* function to append " x y z" to the buffer */
+char* appendVector(char* buffer, const glm::dvec3& v) {
+  return appendValue(appendValue(appendValue(buffer, v.x), v.y), v.z);
+}
+
+} // namespace
+
+void WriteStlAscii::write(const std::string& pathToFile, const MeshData& data, const Progress& progress) {
+  /* the solid is named after the file */
+  writeFile(pathToFile, [&](std::ostream& stream) {
+    writeSolid(stream, std::filesystem::path(pathToFile).stem().string(), data, progress);
+  });
+}
+
+void WriteStlAscii::write(std::ostream& stream, const MeshData& data, const Progress& progress) {
+  writeSolid(stream, DEFAULT_SOLID_NAME, data, progress);
+}
+
+void WriteStlAscii::writeSolid(std::ostream& stream, const std::string& name, const MeshData& data, const Progress& progress) {
+  stream << "solid " << name << "\n";
+
+  /* the facets are formatted in parallel blocks (formatting is reported as 80 %) */
+  progress.update(0.0);
+  auto blocks = formatLines(data.triangles.size(), [](size_t first, size_t last) {
+    return (last - first) * MAX_FACET_SIZE_IN_BYTES;
+  }, [&](char* text, size_t i) {
+    const Triangle& t = data.triangles[i];
+    text = appendVector(appendText(text, "facet normal"), t.normal);
+    text = appendText(text, "\n  outer loop\n");
+    for (const auto& vertex : t.vertices) {
+      text = appendVector(appendText(text, "    vertex"), vertex);
+      *text++ = '\n';
+    }
+    return appendText(text, "  endloop\nendfacet\n");
+  }, progress.part(0.0, 0.8));
+
+  for (const auto& block : blocks) {
+    stream.write(block.data(), block.size());
+  }
+  stream << "endsolid " << name << "\n";
+  if (stream.bad()) {
+    throw std::runtime_error("Unable to write file at facets");
+  }
+  progress.update(1.0);
+}
+
+} // namespace conv
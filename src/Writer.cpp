@@ -0,0 +1,42 @@
+#include "Writer.h"
+
+#include <atomic>
+#include <filesystem>
+
+#include <unistd.h>
+
+
+namespace conv {
+
+namespace fs = std::filesystem;
+
+void Writer::writeFile(const std::string& pathToFile, const std::function<void(std::ostream&)>& body) {
+  static std::atomic<uint64_t> numOfWrites{0u};
+
+  if (pathToFile.empty()) {
+    throw std::invalid_argument(std::string("No path to the output file: ") + pathToFile);
+  }
+
+  /* unique within the directory for every thread and process writing the same file */
+  const std::string temporary = pathToFile + ".tmp" + std::to_string(::getpid()) + "_" + std::to_string(numOfWrites++);
+  std::ofstream file(temporary, std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!file.is_open()) {
+    throw std::runtime_error(std::string("Cannot open file for write: ") + pathToFile);
+  }
+
+  try {
+    body(file);
+    file.close();
+    if (file.fail()) {
+      throw std::runtime_error(std::string("Unable to write file: ") + pathToFile);
+    }
+    fs::rename(temporary, pathToFile);
+  } catch (...) {
+    file.close();
+    std::error_code error;
+    fs::remove(temporary, error);
+    throw;
+  }
+}
+
+} // namespace conv
@@ -0,0 +1,538 @@
+#include "ZipWriter.h"
+#include "Parallel.h"
+
+#include <array>
+#include <cstring>
+#include <stdexcept>
+
+
+namespace conv {
+
+/* signatures of the ZIP records */
+constexpr uint32_t ZIP_LOCAL_HEADER_SIGNATURE = 0x04034B50u;
+constexpr uint32_t ZIP_CENTRAL_HEADER_SIGNATURE = 0x02014B50u;
+constexpr uint32_t ZIP64_END_OF_DIRECTORY_SIGNATURE = 0x06064B50u;
+constexpr uint32_t ZIP64_END_OF_DIRECTORY_LOCATOR_SIGNATURE = 0x07064B50u;
+constexpr uint32_t ZIP_END_OF_DIRECTORY_SIGNATURE = 0x06054B50u;
+constexpr uint32_t ZIP_DATA_DESCRIPTOR_SIGNATURE = 0x08074B50u;
+
+/* version 4.5 is needed for ZIP64, the entries are dated 1980-01-01 00:00 */
+constexpr uint16_t ZIP_VERSION = 45u;
+constexpr uint16_t ZIP_DOS_DATE = 0x0021u;
+constexpr uint16_t ZIP64_EXTRA_FIELD_ID = 0x0001u;
+constexpr uint32_t ZIP64_MARKER = 0xFFFFFFFFu;
+
+/* general purpose flag of the entries whose checksum and sizes follow their data */
+constexpr uint16_t ZIP_FLAG_DATA_DESCRIPTOR = 0x0008u;
+
+/* size of the fixed part of a local header, the ZIP64 field of a streamed entry follows its name */
+constexpr size_t ZIP_LOCAL_HEADER_SIZE = 30u;
+constexpr size_t ZIP_LOCAL_CRC_OFFSET = 14u;
+constexpr size_t ZIP_LOCAL_EXTRA_SIZE = 20u;
+
+/* deflate window, hash table and matches */
+constexpr size_t DEFLATE_WINDOW_SIZE = 1u << 15u;
+constexpr uint32_t DEFLATE_HASH_BITS = 15u;
+constexpr size_t DEFLATE_MIN_MATCH = 3u;
+constexpr size_t DEFLATE_MAX_MATCH = 258u;
+constexpr uint32_t DEFLATE_MAX_CHAIN = 16u;
+constexpr uint32_t DEFLATE_END_OF_BLOCK = 256u;
+
+namespace {
+
+/* tables of the fixed Huffman codes (bit reversed, as they are written least significant bit first) */
+struct DeflateTables {
+  std::array<uint16_t, 288> literalCodes{};
+  std::array<uint8_t, 288> literalLengths{};
+  std::array<uint8_t, 30> distanceCodes{};
+
+  /* length symbol (257..285) and distance code (0..29) of every match length and distance */
+  std::array<uint16_t, DEFLATE_MAX_MATCH + 1u> lengthSymbols{};
+  std::array<uint8_t, DEFLATE_WINDOW_SIZE + 1u> distanceSymbols{};
+
+  static constexpr uint16_t LENGTH_BASES[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                                35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+  static constexpr uint8_t LENGTH_EXTRA_BITS[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                                    2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+  static constexpr uint16_t DISTANCE_BASES[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129,
+                                                  193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097,
+                                                  6145, 8193, 12289, 16385, 24577};
+  static constexpr uint8_t DISTANCE_EXTRA_BITS[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6,
+                                                      6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+  static uint32_t reverse(uint32_t code, uint32_t length) {
+    uint32_t reversed = 0u;
+    for (uint32_t i = 0u; i < length; ++i) {
+      reversed = (reversed << 1u) | ((code >> i) & 1u);
+    }
+    return reversed;
+  }
+
+  DeflateTables() {
+    for (uint32_t s = 0u; s < 288u; ++s) {
+      const uint32_t length = (s < 144u) ? 8u : (s < 256u) ? 9u : (s < 280u) ? 7u : 8u;
+      const uint32_t code = (s < 144u) ? (0x30u + s) : (s < 256u) ? (0x190u + s - 144u) :
+                            (s < 280u) ? (s - 256u) : (0xC0u + s - 280u);
+      literalCodes[s] = static_cast<uint16_t>(reverse(code, length));
+      literalLengths[s] = static_cast<uint8_t>(length);
+    }
+    for (uint32_t d = 0u; d < 30u; ++d) {
+      distanceCodes[d] = static_cast<uint8_t>(reverse(d, 5u));
+    }
+    for (uint32_t s = 0u; s < 29u; ++s) {
+      const uint32_t last = (s == 28u) ? DEFLATE_MAX_MATCH : (LENGTH_BASES[s + 1u] - 1u);
+      for (uint32_t length = LENGTH_BASES[s]; length <= last; ++length) {
+        lengthSymbols[length] = static_cast<uint16_t>(257u + s);
+      }
+    }
+    for (uint32_t d = 0u; d < 30u; ++d) {
+      const uint32_t last = (d == 29u) ? DEFLATE_WINDOW_SIZE : (DISTANCE_BASES[d + 1u] - 1u);
+      for (uint32_t distance = DISTANCE_BASES[d]; distance <= last; ++distance) {
+        distanceSymbols[distance] = static_cast<uint8_t>(d);
+      }
+    }
+  }
+
+  static const DeflateTables& instance() {
+    static const DeflateTables tables;
+    return tables;
+  }
+};
+
+/* writer of the bits of a deflate stream, least significant bit first */
+class BitWriter {
+public:
+  explicit BitWriter(std::vector<uint8_t>& bytes) : bytes_(bytes) {
+  }
+
+  void put(uint32_t value, uint32_t numOfBits) {
+    bits_ |= static_cast<uint64_t>(value) << numOfBits_;
+    numOfBits_ += numOfBits;
+    while (numOfBits_ >= 8u) {
+      bytes_.push_back(static_cast<uint8_t>(bits_));
+      bits_ >>= 8u;
+      numOfBits_ -= 8u;
+    }
+  }
+
+  void putSymbol(uint32_t symbol) {
+    const DeflateTables& tables = DeflateTables::instance();
+    put(tables.literalCodes[symbol], tables.literalLengths[symbol]);
+  }
+
+  /* function to fill the last byte with zero bits */
+  void align() {
+    if (0u != numOfBits_) {
+      bytes_.push_back(static_cast<uint8_t>(bits_));
+      bits_ = 0u;
+      numOfBits_ = 0u;
+    }
+  }
+
+private:
+  std::vector<uint8_t>& bytes_;
+  uint64_t bits_ = 0u;
+  uint32_t numOfBits_ = 0u;
+};
+
+/* function to append the value in little endian byte order */
+void appendLittleEndian(std::vector<uint8_t>& bytes, uint64_t value, size_t numOfBytes) {
+  for (size_t i = 0u; i < numOfBytes; ++i) {
+    bytes.push_back(static_cast<uint8_t>(value >> (8u * i)));
+  }
+}
+
+} // namespace
+
+uint32_t crc32(uint32_t crc, const uint8_t* bytes, size_t size) {
+  /* slicing by 8: TABLES[k][b] is the CRC of the byte b followed by k zero bytes */
+  static const std::array<std::array<uint32_t, 256>, 8> TABLES = [] {
+    std::array<std::array<uint32_t, 256>, 8> tables{};
+    for (uint32_t i = 0u; i < 256u; ++i) {
+      uint32_t c = i;
+      for (int k = 0; k < 8; ++k) {
+        c = (c & 1u) ? (0xEDB88320u ^ (c >> 1u)) : (c >> 1u);
+      }
+      tables[0][i] = c;
+    }
+    for (size_t k = 1u; k < 8u; ++k) {
+      for (uint32_t i = 0u; i < 256u; ++i) {
+        tables[k][i] = (tables[k - 1u][i] >> 8u) ^ tables[0][tables[k - 1u][i] & 0xFFu];
+      }
+    }
+    return tables;
+  }();
+
+  crc = ~crc;
+  size_t i = 0u;
+  for (; i + 8u <= size; i += 8u) {
+    const uint32_t low = crc ^ (static_cast<uint32_t>(bytes[i]) | (static_cast<uint32_t>(bytes[i + 1u]) << 8u) |
+                                (static_cast<uint32_t>(bytes[i + 2u]) << 16u) | (static_cast<uint32_t>(bytes[i + 3u]) << 24u));
+    crc = TABLES[7][low & 0xFFu] ^ TABLES[6][(low >> 8u) & 0xFFu] ^ TABLES[5][(low >> 16u) & 0xFFu] ^
+          TABLES[4][low >> 24u] ^ TABLES[3][bytes[i + 4u]] ^ TABLES[2][bytes[i + 5u]] ^
+          TABLES[1][bytes[i + 6u]] ^ TABLES[0][bytes[i + 7u]];
+  }
+  for (; i < size; ++i) {
+    crc = TABLES[0][(crc ^ bytes[i]) & 0xFFu] ^ (crc >> 8u);
+  }
+  return ~crc;
+}
+
+/* function to get the length of the common prefix of the bytes, at most maxLength */
+size_t matchLength(const uint8_t* a, const uint8_t* b, size_t maxLength) {
+  size_t length = 0u;
+  while (length + 8u <= maxLength) {
+    uint64_t x = 0u;
+    uint64_t y = 0u;
+    std::memcpy(&x, a + length, sizeof(x));
+    std::memcpy(&y, b + length, sizeof(y));
+    if (x != y) {
+      break;
+    }
+    length += 8u;
+  }
+  while (length < maxLength && a[length] == b[length]) {
+    ++length;
+  }
+  return length;
+}
+
+void deflatePiece(const uint8_t* bytes, size_t size, std::vector<uint8_t>& compressed) {
+  if (0u == size) {
+    return;
+  }
+
+  const DeflateTables& tables = DeflateTables::instance();
+  BitWriter writer(compressed);
+
+  /* not final, fixed Huffman codes */
+  writer.put(0u, 1u);
+  writer.put(1u, 2u);
+
+  /* the last position of every hash, and the previous position of the same hash within the window */
+  std::vector<int32_t> head(size_t(1u) << DEFLATE_HASH_BITS, -1);
+  std::vector<int32_t> previous(DEFLATE_WINDOW_SIZE, -1);
+  auto hashAt = [&](size_t i) {
+    const uint32_t key = (static_cast<uint32_t>(bytes[i]) << 16u) | (static_cast<uint32_t>(bytes[i + 1u]) << 8u) | bytes[i + 2u];
+    return (key * 2654435761u) >> (32u - DEFLATE_HASH_BITS);
+  };
+  auto insert = [&](size_t i) {
+    const uint32_t h = hashAt(i);
+    previous[i & (DEFLATE_WINDOW_SIZE - 1u)] = head[h];
+    head[h] = static_cast<int32_t>(i);
+  };
+
+  size_t i = 0u;
+  while (i < size) {
+    size_t bestLength = 0u;
+    size_t bestDistance = 0u;
+    if (i + DEFLATE_MIN_MATCH <= size) {
+      const size_t maxLength = std::min(DEFLATE_MAX_MATCH, size - i);
+      int32_t candidate = head[hashAt(i)];
+      for (uint32_t chain = 0u; candidate >= 0 && chain < DEFLATE_MAX_CHAIN; ++chain) {
+        const size_t distance = i - static_cast<size_t>(candidate);
+        if (distance > DEFLATE_WINDOW_SIZE) {
+          break;
+        }
+
+        const uint8_t* match = bytes + candidate;
+        if (match[bestLength] == bytes[i + bestLength]) {
+          const size_t length = matchLength(match, bytes + i, maxLength);
+          if (length > bestLength) {
+            bestLength = length;
+            bestDistance = distance;
+            if (length == maxLength) {
+              break;
+            }
+          }
+        }
+        candidate = previous[static_cast<size_t>(candidate) & (DEFLATE_WINDOW_SIZE - 1u)];
+      }
+      insert(i);
+    }
+
+    if (bestLength >= DEFLATE_MIN_MATCH) {
+      const uint32_t lengthSymbol = tables.lengthSymbols[bestLength];
+      writer.putSymbol(lengthSymbol);
+      writer.put(static_cast<uint32_t>(bestLength - DeflateTables::LENGTH_BASES[lengthSymbol - 257u]),
+                 DeflateTables::LENGTH_EXTRA_BITS[lengthSymbol - 257u]);
+
+      const uint32_t distanceSymbol = tables.distanceSymbols[bestDistance];
+      writer.put(tables.distanceCodes[distanceSymbol], 5u);
+      writer.put(static_cast<uint32_t>(bestDistance - DeflateTables::DISTANCE_BASES[distanceSymbol]),
+                 DeflateTables::DISTANCE_EXTRA_BITS[distanceSymbol]);
+
+      for (size_t k = i + 1u; k < i + bestLength && k + DEFLATE_MIN_MATCH <= size; ++k) {
+        insert(k);
+      }
+      i += bestLength;
+    } else {
+      writer.putSymbol(bytes[i]);
+      ++i;
+    }
+  }
+  writer.putSymbol(DEFLATE_END_OF_BLOCK);
+
+  /* empty stored block to end on a byte boundary (like a sync flush of zlib) */
+  writer.put(0u, 3u);
+  writer.align();
+  compressed.insert(compressed.end(), {0x00u, 0x00u, 0xFFu, 0xFFu});
+}
+
+void deflateEnd(std::vector<uint8_t>& compressed) {
+  /* final empty block with the fixed codes */
+  BitWriter writer(compressed);
+  writer.put(1u, 1u);
+  writer.put(1u, 2u);
+  writer.putSymbol(DEFLATE_END_OF_BLOCK);
+  writer.align();
+}
+
+ZipWriter::ZipWriter(std::ostream& stream) : stream_(stream), start_(stream.tellp()) {
+  isSeekable_ = (start_ != std::streampos(-1));
+}
+
+void ZipWriter::beginEntry(const std::string& name, ZipMethod method) {
+  if (isEntryOpen_) {
+    throw std::runtime_error("The previous ZIP entry is not ended: " + entries_.back().name);
+  }
+
+  /*
+   * nothing marks the end of the data of a stored entry, so a reader going front to back cannot find its
+   * data descriptor: the entries written to streams that cannot seek are always deflated
+   */
+  Entry entry;
+  entry.name = name;
+  entry.method = isSeekable_ ? method : ZipMethod::ZIP_METHOD_DEFLATED;
+  entry.localHeaderOffset = position_;
+
+  /* the checksum and sizes are filled in or follow the data (see endEntry) */
+  std::vector<uint8_t> header;
+  appendLittleEndian(header, ZIP_LOCAL_HEADER_SIGNATURE, 4u);
+  appendLittleEndian(header, ZIP_VERSION, 2u);
+  appendLittleEndian(header, flags(), 2u);
+  appendLittleEndian(header, static_cast<uint16_t>(entry.method), 2u);
+  appendLittleEndian(header, 0u, 2u);
+  appendLittleEndian(header, ZIP_DOS_DATE, 2u);
+  appendLittleEndian(header, 0u, 4u);
+  appendLittleEndian(header, ZIP64_MARKER, 4u);
+  appendLittleEndian(header, ZIP64_MARKER, 4u);
+  appendLittleEndian(header, name.size(), 2u);
+  appendLittleEndian(header, ZIP_LOCAL_EXTRA_SIZE, 2u);
+  header.insert(header.end(), name.begin(), name.end());
+  appendLittleEndian(header, ZIP64_EXTRA_FIELD_ID, 2u);
+  appendLittleEndian(header, ZIP_LOCAL_EXTRA_SIZE - 4u, 2u);
+  appendLittleEndian(header, 0u, 8u);
+  appendLittleEndian(header, 0u, 8u);
+  writeBytes(header.data(), header.size());
+
+  entries_.emplace_back(entry);
+  isEntryOpen_ = true;
+}
+
+void ZipWriter::write(std::string_view data) {
+  if (!isEntryOpen_) {
+    throw std::runtime_error("No open ZIP entry");
+  }
+
+  pending_.append(data.data(), data.size());
+  if (pending_.size() >= ZIP_PIECE_SIZE) {
+    writePieces({pending_});
+    pending_.clear();
+  }
+}
+
+void ZipWriter::write(const std::vector<std::string>& blocks) {
+  if (!isEntryOpen_) {
+    throw std::runtime_error("No open ZIP entry");
+  }
+
+  /* the pending text and the blocks are compressed as pieces of at least ZIP_PIECE_SIZE */
+  std::vector<std::string_view> pieces;
+  std::vector<std::string> joined;
+  joined.reserve(blocks.size());
+  for (const auto& block : blocks) {
+    if (pending_.empty() && block.size() >= ZIP_PIECE_SIZE) {
+      pieces.emplace_back(block);
+      continue;
+    }
+
+    pending_ += block;
+    if (pending_.size() >= ZIP_PIECE_SIZE) {
+      joined.emplace_back(std::move(pending_));
+      pieces.emplace_back(joined.back());
+      pending_.clear();
+    }
+  }
+  writePieces(pieces);
+}
+
+void ZipWriter::writePieces(const std::vector<std::string_view>& pieces) {
+  Entry& entry = entries_.back();
+  for (const auto& piece : pieces) {
+    entry.crc = crc32(entry.crc, reinterpret_cast<const uint8_t*>(piece.data()), piece.size());
+    entry.uncompressedSize += piece.size();
+  }
+
+  if (entry.method == ZipMethod::ZIP_METHOD_STORED) {
+    for (const auto& piece : pieces) {
+      writeBytes(reinterpret_cast<const uint8_t*>(piece.data()), piece.size());
+      entry.compressedSize += piece.size();
+    }
+    return;
+  }
+
+  std::vector<std::vector<uint8_t>> compressed(pieces.size());
+  parallelFor(pieces.size(), 1u, [&](size_t begin, size_t end) {
+    for (size_t p = begin; p < end; ++p) {
+      deflatePiece(reinterpret_cast<const uint8_t*>(pieces[p].data()), pieces[p].size(), compressed[p]);
+    }
+  });
+  for (const auto& c : compressed) {
+    writeBytes(c.data(), c.size());
+    entry.compressedSize += c.size();
+  }
+}
+
+void ZipWriter::endEntry() {
+  if (!isEntryOpen_) {
+    throw std::runtime_error("No open ZIP entry");
+  }
+
+  Entry& entry = entries_.back();
+  if (!pending_.empty()) {
+    writePieces({pending_});
+    pending_.clear();
+  }
+  if (entry.method == ZipMethod::ZIP_METHOD_DEFLATED) {
+    std::vector<uint8_t> end;
+    deflateEnd(end);
+    writeBytes(end.data(), end.size());
+    entry.compressedSize += end.size();
+  }
+
+  if (isSeekable_) {
+    /* fill in the checksum and the sizes of the ZIP64 field of the local header */
+    std::vector<uint8_t> crc;
+    appendLittleEndian(crc, entry.crc, 4u);
+    std::vector<uint8_t> sizes;
+    appendLittleEndian(sizes, entry.uncompressedSize, 8u);
+    appendLittleEndian(sizes, entry.compressedSize, 8u);
+
+    const std::streampos end = stream_.tellp();
+    patchBytes(entry.localHeaderOffset + ZIP_LOCAL_CRC_OFFSET, crc);
+    patchBytes(entry.localHeaderOffset + ZIP_LOCAL_HEADER_SIZE + entry.name.size() + 4u, sizes);
+    stream_.seekp(end);
+  } else {
+    /* data descriptor with 8 byte sizes, as the local header has a ZIP64 field */
+    std::vector<uint8_t> descriptor;
+    appendLittleEndian(descriptor, ZIP_DATA_DESCRIPTOR_SIGNATURE, 4u);
+    appendLittleEndian(descriptor, entry.crc, 4u);
+    appendLittleEndian(descriptor, entry.compressedSize, 8u);
+    appendLittleEndian(descriptor, entry.uncompressedSize, 8u);
+    writeBytes(descriptor.data(), descriptor.size());
+  }
+
+  isEntryOpen_ = false;
+}
+
+void ZipWriter::finish() {
+  if (isEntryOpen_) {
+    endEntry();
+  }
+
+  const uint64_t directoryOffset = position_;
+  std::vector<uint8_t> directory;
+  for (const auto& entry : entries_) {
+    /* the values that do not fit into 32 bits are moved to the ZIP64 field */
+    std::vector<uint8_t> extra;
+    for (uint64_t value : {entry.uncompressedSize, entry.compressedSize, entry.localHeaderOffset}) {
+      if (value >= ZIP64_MARKER) {
+        appendLittleEndian(extra, value, 8u);
+      }
+    }
+    auto field = [&](uint64_t value) { return (value >= ZIP64_MARKER) ? ZIP64_MARKER : value; };
+
+    appendLittleEndian(directory, ZIP_CENTRAL_HEADER_SIGNATURE, 4u);
+    appendLittleEndian(directory, ZIP_VERSION, 2u);
+    appendLittleEndian(directory, ZIP_VERSION, 2u);
+    appendLittleEndian(directory, flags(), 2u);
+    appendLittleEndian(directory, static_cast<uint16_t>(entry.method), 2u);
+    appendLittleEndian(directory, 0u, 2u);
+    appendLittleEndian(directory, ZIP_DOS_DATE, 2u);
+    appendLittleEndian(directory, entry.crc, 4u);
+    appendLittleEndian(directory, field(entry.compressedSize), 4u);
+    appendLittleEndian(directory, field(entry.uncompressedSize), 4u);
+    appendLittleEndian(directory, entry.name.size(), 2u);
+    appendLittleEndian(directory, extra.empty() ? 0u : (extra.size() + 4u), 2u);
+    appendLittleEndian(directory, 0u, 2u);
+    appendLittleEndian(directory, 0u, 2u);
+    appendLittleEndian(directory, 0u, 2u);
+    appendLittleEndian(directory, 0u, 4u);
+    appendLittleEndian(directory, field(entry.localHeaderOffset), 4u);
+    directory.insert(directory.end(), entry.name.begin(), entry.name.end());
+    if (!extra.empty()) {
+      appendLittleEndian(directory, ZIP64_EXTRA_FIELD_ID, 2u);
+      appendLittleEndian(directory, extra.size(), 2u);
+      directory.insert(directory.end(), extra.begin(), extra.end());
+    }
+  }
+
+  const uint64_t directorySize = directory.size();
+  const bool isZip64 = (directoryOffset >= ZIP64_MARKER || entries_.size() >= 0xFFFFu);
+  if (isZip64) {
+    const uint64_t recordOffset = directoryOffset + directorySize;
+    appendLittleEndian(directory, ZIP64_END_OF_DIRECTORY_SIGNATURE, 4u);
+    appendLittleEndian(directory, 44u, 8u);
+    appendLittleEndian(directory, ZIP_VERSION, 2u);
+    appendLittleEndian(directory, ZIP_VERSION, 2u);
+    appendLittleEndian(directory, 0u, 4u);
+    appendLittleEndian(directory, 0u, 4u);
+    appendLittleEndian(directory, entries_.size(), 8u);
+    appendLittleEndian(directory, entries_.size(), 8u);
+    appendLittleEndian(directory, directorySize, 8u);
+    appendLittleEndian(directory, directoryOffset, 8u);
+
+    appendLittleEndian(directory, ZIP64_END_OF_DIRECTORY_LOCATOR_SIGNATURE, 4u);
+    appendLittleEndian(directory, 0u, 4u);
+    appendLittleEndian(directory, recordOffset, 8u);
+    appendLittleEndian(directory, 1u, 4u);
+  }
+
+  appendLittleEndian(directory, ZIP_END_OF_DIRECTORY_SIGNATURE, 4u);
+  appendLittleEndian(directory, 0u, 2u);
+  appendLittleEndian(directory, 0u, 2u);
+  appendLittleEndian(directory, isZip64 ? 0xFFFFu : entries_.size(), 2u);
+  appendLittleEndian(directory, isZip64 ? 0xFFFFu : entries_.size(), 2u);
+  appendLittleEndian(directory, isZip64 ? ZIP64_MARKER : directorySize, 4u);
+  appendLittleEndian(directory, isZip64 ? ZIP64_MARKER : directoryOffset, 4u);
+  appendLittleEndian(directory, 0u, 2u);
+  writeBytes(directory.data(), directory.size());
+
+  stream_.flush();
+  if (stream_.bad()) {
+    throw std::runtime_error("Unable to write file at central directory");
+  }
+}
+
+void ZipWriter::patchBytes(uint64_t offset, const std::vector<uint8_t>& bytes) {
+  stream_.seekp(start_ + static_cast<std::streamoff>(offset));
+  stream_.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+  if (!stream_) {
+    throw std::runtime_error("Unable to write file at local header");
+  }
+}
+
+uint16_t ZipWriter::flags() const {
+  return isSeekable_ ? 0u : ZIP_FLAG_DATA_DESCRIPTOR;
+}
+
+void ZipWriter::writeBytes(const uint8_t* bytes, size_t size) {
+  stream_.write(reinterpret_cast<const char*>(bytes), static_cast<std::streamsize>(size));
+  if (stream_.bad()) {
+    throw std::runtime_error("Unable to write file at buffer");
+  }
+  position_ += size;
+}
+
+} // namespace conv
@@ -2,11 +2,53 @@
 
 #include "catch.hpp"
 
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "BatchConverter.h"
+#include "CommandLine.h"
+#include "ConversionCache.h"
+#include "Daemon.h"
+#include "Edgebreaker.h"
+#include "Entropy.h"
 #include "FileConverter.h"
+#include "Hash.h"
+#include "Parallel.h"
+#include "Predicates.h"
+#include "Utils.h"
+#include "VertexCache.h"
+#include "ZipWriter.h"
 
 
 using namespace conv;
 
+/* number of temporary directories created by the tests */
+std::atomic<uint64_t> numOfTemporaryDirectories{0u};
+
+/* unique directory for the files of a test (parallel runs never share a file), removed at the end of the test */
+struct TemporaryDirectory {
+  const std::filesystem::path path;
+
+  TemporaryDirectory()
+      : path(std::filesystem::temp_directory_path() /
+             ("3dfc_test_" + std::to_string(::getpid()) + "_" + std::to_string(numOfTemporaryDirectories++))) {
+    std::filesystem::create_directories(path);
+  }
+
+  ~TemporaryDirectory() {
+    std::error_code error;
+    std::filesystem::remove_all(path, error);
+  }
+};
+
 TEST_CASE("Read and Write converters are set", "[converter]") {
   auto& fc = FileConverter::getInstance();
   InputType input = InputType::INPUT_TYPE_OBJ;
@@ -41,7 +83,7 @@ TEST_CASE("Read from file", "[file reader]") {
   }
 
   SECTION("Testing valid input file") {
-    input = "../../3dfc/res/cube.obj";
+    input = RES_DIR "cube.obj";
     REQUIRE_FALSE(input.empty());
     REQUIRE_NOTHROW(fc.read(input));
   }
@@ -57,7 +99,7 @@ TEST_CASE("Write to file", "[file writer]") {
   }
 
   SECTION("Testing valid output file") {
-    output = "../../3dfc/res/cube.stl";
+    output = RES_DIR "cube.stl";
     REQUIRE_FALSE(output.empty());
     REQUIRE_NOTHROW(fc.read(output));
   }
@@ -92,7 +134,7 @@ TEST_CASE("Translate mesh", "[translate]") {
 
 TEST_CASE("Is point inside", "[point]") {
   auto& fc = FileConverter::getInstance();
-  const std::string input = "../../3dfc/res/cube.obj";
+  const std::string input = RES_DIR "cube.obj";
   glm::dvec3 point = {1.9, 1.9, 1.0};
 
   SECTION("Testing if point is inside the mesh") {
@@ -111,7 +153,7 @@ TEST_CASE("Is point inside", "[point]") {
 
 TEST_CASE("Volume of mesh", "[volume]") {
   auto& fc = FileConverter::getInstance();
-  const std::string input = "../../3dfc/res/cube.obj";
+  const std::string input = RES_DIR "cube.obj";
 
   SECTION("Testing volume functionality") {
     REQUIRE_FALSE(input.empty());
@@ -122,7 +164,7 @@ TEST_CASE("Volume of mesh", "[volume]") {
 
 TEST_CASE("Surface of mesh", "[surface]") {
   auto& fc = FileConverter::getInstance();
-  const std::string input = "../../3dfc/res/cube.obj";
+  const std::string input = RES_DIR "cube.obj";
 
   SECTION("Testing surface functionality") {
     REQUIRE_FALSE(input.empty());
@@ -130,3 +172,1863 @@ TEST_CASE("Surface of mesh", "[surface]") {
     REQUIRE(fc.surface() == Approx(24.0));
   }
 }
+
+TEST_CASE("Ray queries", "[ray]") {
+  auto& fc = FileConverter::getInstance();
+  const std::string input = RES_DIR "cube.obj";
+  REQUIRE_NOTHROW(fc.read(input));
+
+  Ray hitting;
+  hitting.origin = {1.0, 0.5, -1.0};
+  hitting.direction = {0.0, 0.0, 1.0};
+
+  Ray missing;
+  missing.origin = {5.0, 5.0, -1.0};
+  missing.direction = {0.0, 0.0, 1.0};
+
+  Ray segment = hitting;
+  segment.tMax = 2.0;
+
+  SECTION("Testing first hit") {
+    auto hits = fc.firstHits({hitting, missing, segment});
+    REQUIRE(hits.size() == 3u);
+    REQUIRE(hits[0].valid());
+    REQUIRE(hits[0].t == Approx(1.0));
+    REQUIRE_FALSE(hits[1].valid());
+    REQUIRE(hits[2].t == Approx(1.0));
+  }
+
+  SECTION("Testing any hit") {
+    auto hits = fc.anyHits({hitting, missing});
+    REQUIRE(hits[0].valid());
+    REQUIRE_FALSE(hits[1].valid());
+  }
+
+  SECTION("Testing all hits along the ray and along a segment") {
+    auto hits = fc.allHits({hitting, missing, segment});
+    REQUIRE(hits[0].size() == 2u);
+    REQUIRE(hits[0][0].t == Approx(1.0));
+    REQUIRE(hits[0][1].t == Approx(3.0));
+    REQUIRE(hits[1].empty());
+    REQUIRE(hits[2].size() == 1u);
+  }
+
+  SECTION("Testing a batch of rays through the mesh") {
+    std::vector<Ray> rays;
+    for (int i = 0; i < 10; ++i) {
+      for (int j = 0; j < 10; ++j) {
+        Ray r;
+        r.origin = {0.1 + 0.2 * i, 0.15 + 0.2 * j, 5.0};
+        r.direction = {0.0, 0.0, -1.0};
+        rays.emplace_back(r);
+      }
+    }
+
+    auto first = fc.firstHits(rays);
+    auto all = fc.allHits(rays);
+    for (size_t i = 0u; i < rays.size(); ++i) {
+      REQUIRE(first[i].t == Approx(3.0));
+      REQUIRE(all[i].size() == 2u);
+    }
+  }
+}
+
+TEST_CASE("Orientation predicate", "[predicates]") {
+  glm::dvec3 a = {0.0, 0.0, 0.0};
+  glm::dvec3 b = {1.0, 0.0, 0.0};
+  glm::dvec3 c = {0.0, 1.0, 0.0};
+
+  SECTION("Testing clear orientations") {
+    REQUIRE(orient3d(a, b, c, glm::dvec3(0.2, 0.2, 1.0)) == 1);
+    REQUIRE(orient3d(a, b, c, glm::dvec3(0.2, 0.2, -1.0)) == -1);
+    REQUIRE(orient3d(b, a, c, glm::dvec3(0.2, 0.2, 1.0)) == -1);
+  }
+
+  SECTION("Testing nearly coplanar points with large coordinates") {
+    /* exactly coplanar: d - a = u + v, but the floating-point products round */
+    glm::dvec3 origin = {1099511627777.0, 3.0, 7.0};
+    glm::dvec3 u = {1073741827.0, -536870923.0, 268435459.0};
+    glm::dvec3 v = {-805306367.0, 1342177283.0, 939524093.0};
+    glm::dvec3 d = origin + u + v;
+
+    REQUIRE(orient3d(origin, origin + u, origin + v, d) == 0);
+    REQUIRE(orient3d(origin, origin + u, origin + v, d + glm::dvec3(0.0, 0.0, 1.0)) ==
+            -orient3d(origin, origin + u, origin + v, d - glm::dvec3(0.0, 0.0, 1.0)));
+    REQUIRE(orient3d(origin, origin + u, origin + v, d + glm::dvec3(0.0, 0.0, 1.0)) != 0);
+  }
+
+  SECTION("Testing nearly coplanar points where the rounded determinant has the wrong sign") {
+    glm::dvec3 p = {0x1.b537f328e16b1p-1, 0x1.fac7da9ef1ceap-1, 0x1.6a91f2b02b478p-4};
+    glm::dvec3 q = {0x1.99e7a144435f0p-1, 0x1.a4501af2d40c0p-2, 0x1.34c47a0526ef4p-3};
+    glm::dvec3 r = {0x1.2cf1d3b6ac94cp-2, 0x1.899f171a9297bp-1, 0x1.bedb51c79c570p-1};
+    glm::dvec3 s = {0x1.03cbf2781c2cdp-1, 0x1.a821ffa7e04ebp-1, 0x1.257c793d7eb7fp-1};
+
+    REQUIRE(orient3d(p, q, r, s) == 1);
+    REQUIRE(orient3d(q, p, r, s) == -1);
+  }
+}
+
+TEST_CASE("Is point inside with probes through edges and vertices", "[point]") {
+  auto& fc = FileConverter::getInstance();
+  const std::string input = RES_DIR "cube.obj";
+  REQUIRE_NOTHROW(fc.read(input));
+
+  SECTION("Testing points whose first probe passes through a vertex") {
+    REQUIRE(fc.isPointInside(glm::dvec3(1.0, 1.0, 1.0)));
+    REQUIRE(fc.isPointInside(glm::dvec3(0.5, 0.5, 0.5)));
+  }
+
+  SECTION("Testing a point whose first probe passes through an edge") {
+    REQUIRE(fc.isPointInside(glm::dvec3(1.0, 1.0, 0.5)));
+  }
+}
+
+TEST_CASE("Properties of mesh", "[properties]") {
+  auto& fc = FileConverter::getInstance();
+  const std::string input = RES_DIR "cube.obj";
+  REQUIRE_NOTHROW(fc.read(input));
+
+  SECTION("Testing properties of the cube") {
+    const MeshProperties& p = fc.properties();
+    REQUIRE(p.volume == Approx(8.0));
+    REQUIRE(p.surface == Approx(24.0));
+    REQUIRE(p.centroid.x == Approx(1.0));
+    REQUIRE(p.centroid.y == Approx(1.0));
+    REQUIRE(p.centroid.z == Approx(1.0));
+    REQUIRE(p.inertia[0][0] == Approx(16.0 / 3.0));
+    REQUIRE(p.inertia[1][1] == Approx(16.0 / 3.0));
+    REQUIRE(p.inertia[2][2] == Approx(16.0 / 3.0));
+    REQUIRE(p.inertia[0][1] == Approx(0.0).margin(1e-12));
+    REQUIRE(p.boundsMin == glm::dvec3(0.0, 0.0, 0.0));
+    REQUIRE(p.boundsMax == glm::dvec3(2.0, 2.0, 2.0));
+  }
+
+  SECTION("Testing properties after rigid transformations") {
+    fc.properties();
+    fc.translate(glm::dvec3(1.0, -2.0, 3.0));
+    REQUIRE(fc.properties().centroid.x == Approx(2.0));
+    REQUIRE(fc.properties().centroid.y == Approx(-1.0));
+    REQUIRE(fc.properties().centroid.z == Approx(4.0));
+    REQUIRE(fc.properties().boundsMin.y == Approx(-2.0));
+
+    fc.rotate(glm::dvec3(0.3, 0.0, 0.0));
+    REQUIRE(fc.volume() == Approx(8.0));
+    REQUIRE(fc.surface() == Approx(24.0));
+    REQUIRE(fc.properties().inertia[1][1] == Approx(16.0 / 3.0));
+    REQUIRE(fc.properties().inertia[1][2] == Approx(0.0).margin(1e-9));
+  }
+
+  SECTION("Testing properties after scaling") {
+    fc.properties();
+    fc.scale(glm::dvec3(2.0, 1.0, 1.0));
+    REQUIRE(fc.volume() == Approx(16.0));
+    REQUIRE(fc.properties().centroid.x == Approx(2.0));
+    REQUIRE(fc.properties().boundsMax.x == Approx(4.0));
+  }
+}
+
+TEST_CASE("Properties of mesh far from the origin", "[properties]") {
+  auto& fc = FileConverter::getInstance();
+  const std::string input = RES_DIR "cube.obj";
+  REQUIRE_NOTHROW(fc.read(input));
+
+  SECTION("Testing volume and surface without cancellation") {
+    fc.translate(glm::dvec3(1e7, -1e7, 1e7));
+    REQUIRE(fc.volume() == Approx(8.0).epsilon(1e-12));
+    REQUIRE(fc.surface() == Approx(24.0).epsilon(1e-12));
+    REQUIRE(fc.properties().centroid.x == Approx(1e7 + 1.0).epsilon(1e-15));
+    REQUIRE(fc.properties().inertia[0][0] == Approx(16.0 / 3.0).epsilon(1e-9));
+  }
+}
+
+TEST_CASE("Vertex neighbourhood queries", "[octree]") {
+  auto& fc = FileConverter::getInstance();
+
+  SECTION("Testing queries on the cube") {
+    REQUIRE_NOTHROW(fc.read(RES_DIR "cube.obj"));
+
+    auto inRadius = fc.verticesWithinRadius(glm::dvec3(0.0, 0.0, 0.0), 2.0);
+    REQUIRE(inRadius.size() == 4u);
+    REQUIRE(inRadius[0].vertex == 0u);
+    REQUIRE(inRadius[0].squaredDistance == 0.0);
+
+    auto closest = fc.nearestVertices(glm::dvec3(1.9, 1.9, 2.1), 1u);
+    REQUIRE(closest.size() == 1u);
+    REQUIRE(closest[0].vertex == 7u);
+
+    auto all = fc.nearestVertices(glm::dvec3(1.0, 1.0, 1.0), 100u);
+    REQUIRE(all.size() == 8u);
+  }
+
+  SECTION("Testing queries against brute force on many vertices") {
+    const TemporaryDirectory temporary;
+    const std::string path = (temporary.path / "3dfc_octree_test.obj").string();
+    std::vector<glm::dvec3> vertices;
+    {
+      std::ofstream file(path);
+      uint64_t state = 12345u;
+      auto next = [&state]() {
+        state = state * 6364136223846793005u + 1442695040888963407u;
+        return static_cast<double>(state >> 11u) / static_cast<double>(1ull << 53u);
+      };
+      for (size_t i = 0u; i < 40000u; ++i) {
+        glm::dvec3 v(next() * 10.0, next() * 5.0, next());
+        vertices.emplace_back(v);
+        file << std::setprecision(17) << "v " << v.x << " " << v.y << " " << v.z << "\n";
+      }
+    }
+    REQUIRE_NOTHROW(fc.read(path));
+    std::filesystem::remove(path);
+
+    std::vector<glm::dvec3> points = {{5.0, 2.5, 0.5}, {0.0, 0.0, 0.0}, {12.0, -1.0, 3.0}};
+    auto inRadius = fc.verticesWithinRadius(points, 0.3);
+    auto closest = fc.nearestVertices(points, 10u);
+
+    for (size_t p = 0u; p < points.size(); ++p) {
+      std::vector<double> distances;
+      for (const auto& v : vertices) {
+        distances.emplace_back(glm::dot(v - points[p], v - points[p]));
+      }
+      std::sort(distances.begin(), distances.end());
+
+      size_t expected = std::upper_bound(distances.begin(), distances.end(), 0.09) - distances.begin();
+      REQUIRE(inRadius[p].size() == expected);
+      REQUIRE(closest[p].size() == 10u);
+      for (size_t i = 0u; i < 10u; ++i) {
+        REQUIRE(closest[p][i].squaredDistance == distances[i]);
+      }
+    }
+  }
+}
+
+TEST_CASE("Concurrent converter sessions", "[session]") {
+  SECTION("Testing reading without a format") {
+    FileConverter fc;
+    REQUIRE_THROWS(fc.read(RES_DIR "cube.obj"));
+    REQUIRE_THROWS(fc.write(RES_DIR "cube.stl"));
+  }
+
+  SECTION("Testing independent conversions on many threads") {
+    const size_t numOfSessions = 48u;
+    const TemporaryDirectory temporary;
+    const auto directory = temporary.path;
+    std::vector<double> volumes(numOfSessions, 0.0);
+    std::vector<uintmax_t> sizes(numOfSessions, 0u);
+    std::vector<std::thread> threads;
+
+    for (size_t i = 0u; i < numOfSessions; ++i) {
+      threads.emplace_back([&, i]() {
+        const std::string output = (directory / ("3dfc_session_" + std::to_string(i) + ".stl")).string();
+
+        FileConverter fc;
+        fc.setInputFormat(InputType::INPUT_TYPE_OBJ);
+        fc.setOutputFormat(OutputType::OUTPUT_TYPE_STL);
+        fc.read(RES_DIR "cube.obj");
+        fc.scale(glm::dvec3(1.0 + i, 1.0, 1.0));
+        fc.rotate(glm::dvec3(0.1 * i, 0.0, 0.2));
+        fc.write(output);
+
+        volumes[i] = fc.volume();
+        sizes[i] = std::filesystem::file_size(output);
+        std::filesystem::remove(output);
+      });
+    }
+    for (auto& t : threads) {
+      t.join();
+    }
+
+    for (size_t i = 0u; i < numOfSessions; ++i) {
+      REQUIRE(volumes[i] == Approx(8.0 * (1.0 + i)));
+      REQUIRE(sizes[i] == sizes[0]);
+    }
+  }
+}
+
+TEST_CASE("Work-stealing scheduler", "[scheduler]") {
+  SECTION("Testing nested parallel loops") {
+    std::vector<std::atomic<uint32_t>> counts(64u * 1000u);
+    parallelFor(64u, 1u, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        parallelFor(1000u, 7u, [&](size_t first, size_t last) {
+          for (size_t j = first; j < last; ++j) {
+            counts[i * 1000u + j]++;
+          }
+        });
+      }
+    });
+
+    for (const auto& c : counts) {
+      REQUIRE(c == 1u);
+    }
+  }
+
+  SECTION("Testing task groups on a scheduler of its own") {
+    Scheduler scheduler(4u);
+    std::atomic<size_t> sum{0u};
+    {
+      TaskGroup group(scheduler);
+      for (size_t i = 1u; i <= 100u; ++i) {
+        group.run([&sum, i]() { sum += i; });
+      }
+      group.wait();
+    }
+    REQUIRE(sum == 5050u);
+
+    TaskGroup group(scheduler);
+    group.run([]() { throw std::runtime_error("task failed"); });
+    REQUIRE_THROWS_AS(group.wait(), std::runtime_error);
+  }
+
+  SECTION("Testing exceptions of parallel loops") {
+    REQUIRE_THROWS_AS(parallelFor(100u, 1u, [](size_t begin, size_t) {
+      if (begin == 42u) {
+        throw std::out_of_range("block failed");
+      }
+    }), std::out_of_range);
+  }
+}
+
+TEST_CASE("Asynchronous conversion", "[async]") {
+  const TemporaryDirectory temporary;
+  const auto directory = temporary.path;
+
+  SECTION("Testing progress and completion") {
+    FileConverter fc;
+    fc.setInputFormat(InputType::INPUT_TYPE_OBJ);
+    fc.setOutputFormat(OutputType::OUTPUT_TYPE_STL);
+
+    std::vector<double> fractions;
+    bool completed = false;
+    AsyncOptions options;
+    options.progress = [&](double fraction) { fractions.emplace_back(fraction); };
+    options.completion = [&](std::exception_ptr error) { completed = !error; };
+
+    const std::string output = (directory / "3dfc_async.stl").string();
+    REQUIRE_NOTHROW(fc.convertAsync(RES_DIR "cube.obj", output, options).get());
+    REQUIRE(completed);
+    REQUIRE(!fractions.empty());
+    REQUIRE(std::is_sorted(fractions.begin(), fractions.end()));
+    REQUIRE(fractions.back() == 1.0);
+    REQUIRE(fc.volume() == Approx(8.0));
+    REQUIRE(std::filesystem::exists(output));
+    std::filesystem::remove(output);
+
+    REQUIRE_THROWS(fc.readAsync(RES_DIR "missing.obj").get());
+  }
+
+  SECTION("Testing cancellation") {
+    FileConverter fc;
+    fc.setInputFormat(InputType::INPUT_TYPE_OBJ);
+
+    AsyncOptions options;
+    options.cancellation.cancel();
+    REQUIRE_THROWS_AS(fc.readAsync(RES_DIR "cube.obj", options).get(), OperationCancelled);
+    REQUIRE(fc.mesh().triangles.empty());
+  }
+
+  SECTION("Testing a cancelled write") {
+    FileConverter fc;
+    fc.setInputFormat(InputType::INPUT_TYPE_OBJ);
+    fc.setOutputFormat(OutputType::OUTPUT_TYPE_AUTO);
+    fc.read(RES_DIR "cube.obj");
+
+    /* function to count the files of the directory whose name starts with the prefix */
+    auto countFiles = [&](const std::string& prefix) {
+      size_t n = 0u;
+      for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+        n += (entry.path().filename().string().rfind(prefix, 0u) == 0u) ? 1u : 0u;
+      }
+      return n;
+    };
+
+    CancellationToken cancellation;
+    cancellation.cancel();
+    for (const char* extension : {".stl", ".ply", ".glb", ".obj", ".off", ".3mf", ".3dfc", ".3dfz", ".3dfe"}) {
+      const std::string output = (directory / (std::string("3dfc_cancelled") + extension)).string();
+      REQUIRE_THROWS_AS(fc.write(output, Progress(cancellation, nullptr)), OperationCancelled);
+      CHECK_FALSE(std::filesystem::exists(output));
+    }
+    CHECK(countFiles("3dfc_cancelled") == 0u);
+
+    /* an existing output is kept as it was */
+    const std::string output = (directory / "3dfc_cancelled.stl").string();
+    auto readFile = [&]() {
+      std::ifstream file(output, std::ios::binary);
+      return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    };
+    fc.write(output);
+    const std::string bytes = readFile();
+    fc.scale(glm::dvec3(2.0));
+    REQUIRE_THROWS_AS(fc.write(output, Progress(cancellation, nullptr)), OperationCancelled);
+    CHECK(readFile() == bytes);
+    CHECK(countFiles("3dfc_cancelled") == 1u);
+    std::filesystem::remove(output);
+  }
+
+  SECTION("Testing many conversions in flight") {
+    const size_t numOfSessions = 100u;
+    std::vector<FileConverter> sessions(numOfSessions);
+    std::vector<std::future<void>> futures;
+    for (size_t i = 0u; i < numOfSessions; ++i) {
+      sessions[i].setInputFormat(InputType::INPUT_TYPE_OBJ);
+      sessions[i].setOutputFormat(OutputType::OUTPUT_TYPE_STL);
+      futures.emplace_back(sessions[i].convertAsync(RES_DIR "box.obj",
+                                                    (directory / ("3dfc_async_" + std::to_string(i) + ".stl")).string()));
+    }
+
+    for (size_t i = 0u; i < numOfSessions; ++i) {
+      REQUIRE_NOTHROW(futures[i].get());
+      REQUIRE(sessions[i].mesh().triangles.size() == sessions[0].mesh().triangles.size());
+      std::filesystem::remove(directory / ("3dfc_async_" + std::to_string(i) + ".stl"));
+    }
+  }
+}
+
+TEST_CASE("Wildcard matching", "[utils]") {
+  REQUIRE(utils::matchesWildcard("cube.obj", "*.obj"));
+  REQUIRE(utils::matchesWildcard("cube2.obj", "cube?.obj"));
+  REQUIRE(utils::matchesWildcard("cube.obj", "*"));
+  REQUIRE(utils::matchesWildcard("a.b.obj", "*.*.obj"));
+  REQUIRE(!utils::matchesWildcard("cube.obj", "cube?.obj"));
+  REQUIRE(!utils::matchesWildcard("cube.stl", "*.obj"));
+  REQUIRE(!utils::matchesWildcard("", "?"));
+}
+
+TEST_CASE("Command line", "[cli]") {
+  const TemporaryDirectory temporary;
+  const auto directory = temporary.path;
+
+  /* function to parse the arguments given after the name of the tool */
+  auto parse = [](std::vector<const char*> args) {
+    args.insert(args.begin(), "3dfc");
+    return parseCommandLine(static_cast<int>(args.size()), args.data());
+  };
+
+  /* function to run the tool, returning its exit code */
+  std::ostringstream out;
+  std::ostringstream err;
+  auto run = [&](std::vector<const char*> args) {
+    args.insert(args.begin(), "3dfc");
+    return runCommandLine(static_cast<int>(args.size()), args.data(), out, err);
+  };
+
+  SECTION("Testing the options") {
+    const CommandLine commandLine = parse({"a.obj", "-o", "out", "-f", "ply", "-j", "4", "-s", "2,2,2",
+                                           "--rotate", "0,0,1.5", "-t", "1,-1,0", "--optimize-cache", "--stats",
+                                           "--cache", "cache", "--cache-size", "16", "b.stl"});
+    CHECK(commandLine.inputs == std::vector<std::string>{"a.obj", "b.stl"});
+    CHECK(commandLine.output == "out");
+    CHECK(commandLine.format == "ply");
+    CHECK(commandLine.numOfJobs == 4u);
+    CHECK(commandLine.stats);
+    CHECK(commandLine.cacheDirectory == "cache");
+    CHECK(commandLine.cacheSizeInMegabytes == 16.0);
+
+    /* the transformations keep their order */
+    REQUIRE(commandLine.transforms.size() == 4u);
+    CHECK(commandLine.transforms[0].type == TransformType::TRANSFORM_TYPE_SCALE);
+    CHECK(commandLine.transforms[1].type == TransformType::TRANSFORM_TYPE_ROTATE);
+    CHECK(commandLine.transforms[1].value == glm::dvec3(0.0, 0.0, 1.5));
+    CHECK(commandLine.transforms[2].type == TransformType::TRANSFORM_TYPE_TRANSLATE);
+    CHECK(commandLine.transforms[2].value == glm::dvec3(1.0, -1.0, 0.0));
+    CHECK(commandLine.transforms[3].type == TransformType::TRANSFORM_TYPE_OPTIMIZE_VERTEX_CACHE);
+  }
+
+  SECTION("Testing invalid options") {
+    CHECK_THROWS_AS(parse({"--bogus"}), std::invalid_argument);
+    CHECK_THROWS_AS(parse({"a.obj", "-o"}), std::invalid_argument);
+    CHECK_THROWS_AS(parse({"-f", "dwg"}), std::invalid_argument);
+    CHECK_THROWS_AS(parse({"-j", "0"}), std::invalid_argument);
+    CHECK_THROWS_AS(parse({"-j", "1.5"}), std::invalid_argument);
+    CHECK_THROWS_AS(parse({"-s", "1,2"}), std::invalid_argument);
+    CHECK_THROWS_AS(parse({"-t", "1,2,z"}), std::invalid_argument);
+    CHECK_THROWS_AS(parse({"--cache-size", "-1"}), std::invalid_argument);
+    CHECK_THROWS_AS(parse({"a.obj", "--connect", "3dfc.sock", "--cache", "cache"}), std::invalid_argument);
+  }
+
+  SECTION("Testing the exit codes") {
+    const std::string output = (directory / "3dfc_cli.stl").string();
+    const std::string missing = (directory / "3dfc_missing.obj").string();
+
+    CHECK(run({"--help"}) == EXIT_CODE_SUCCESS);
+    CHECK(run({}) == EXIT_CODE_USAGE);
+    CHECK(run({"--bogus"}) == EXIT_CODE_USAGE);
+    CHECK(run({RES_DIR "cube.obj", "-j", "x"}) == EXIT_CODE_USAGE);
+
+    CHECK(run({RES_DIR "cube.obj", "-o", output.c_str()}) == EXIT_CODE_SUCCESS);
+    CHECK(std::filesystem::exists(output));
+
+    /* a failed file fails the run, the others are still converted */
+    std::filesystem::remove(output);
+    CHECK(run({missing.c_str()}) == EXIT_CODE_FAILED_JOBS);
+    CHECK(run({RES_DIR "cube.obj", missing.c_str(), "-o", directory.string().c_str(), "-f", "ply"}) == EXIT_CODE_FAILED_JOBS);
+    CHECK(std::filesystem::exists(directory / "cube.ply"));
+    CHECK(run({(directory / "3dfc_nothing_*.obj").string().c_str()}) == EXIT_CODE_FAILED_JOBS);
+
+    std::filesystem::remove(directory / "cube.ply");
+  }
+}
+
+TEST_CASE("Conversion daemon", "[daemon]") {
+  const TemporaryDirectory temporary;
+  const auto directory = temporary.path;
+  DaemonOptions options;
+  options.socketPath = (directory / ("3dfc_test" + std::to_string(::getpid()) + ".sock")).string();
+  options.maxNumOfMeshes = 1u;
+
+  /* a file that is not a socket is never replaced */
+  {
+    std::ofstream(options.socketPath) << "not a socket";
+    REQUIRE_THROWS_AS(ConversionDaemon(options), std::runtime_error);
+    REQUIRE(std::filesystem::is_regular_file(options.socketPath));
+    std::filesystem::remove(options.socketPath);
+  }
+
+  /* a socket file left behind by a daemon that is gone is replaced */
+  {
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, options.socketPath.c_str(), options.socketPath.size());
+    int stale = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    REQUIRE(::bind(stale, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0);
+    ::close(stale);
+    REQUIRE(std::filesystem::is_socket(options.socketPath));
+  }
+
+  ConversionDaemon daemon(options);
+  std::thread server([&daemon]() { daemon.run(); });
+
+  /* the socket of a running daemon is not taken over */
+  REQUIRE_THROWS_AS(ConversionDaemon(options), std::runtime_error);
+
+  {
+    DaemonClient client(options.socketPath);
+    const std::string cube = std::filesystem::absolute(RES_DIR "cube.obj").string();
+    const std::string box = std::filesystem::absolute(RES_DIR "box.obj").string();
+
+    REQUIRE(client.volume(cube) == Approx(8.0));
+    REQUIRE(client.surface(cube) == Approx(24.0));
+    REQUIRE(client.volume(cube, {{TransformType::TRANSFORM_TYPE_SCALE, glm::dvec3(2.0, 1.0, 1.0)}}) == Approx(16.0));
+
+    auto inside = client.isPointInside(cube, {glm::dvec3(1.0, 1.0, 1.0), glm::dvec3(5.0, 1.0, 1.0)});
+    REQUIRE(inside.size() == 2u);
+    REQUIRE(inside[0]);
+    REQUIRE(!inside[1]);
+
+    /* the cube stays loaded, the box replaces it in the cache of one mesh */
+    DaemonStatistics statistics = client.statistics();
+    REQUIRE(statistics.misses == 1u);
+    REQUIRE(statistics.hits == 3u);
+    REQUIRE(client.volume(box) > 0.0);
+    REQUIRE(client.statistics().misses == 2u);
+    REQUIRE(client.statistics().numOfMeshes == 1u);
+
+    const std::string output = (directory / "3dfc_daemon.stl").string();
+    REQUIRE(client.convert(cube, output) == 12u);
+    REQUIRE(std::filesystem::exists(output));
+    std::filesystem::remove(output);
+
+    REQUIRE_THROWS_AS(client.volume(RES_DIR "missing.obj"), std::runtime_error);
+    REQUIRE_THROWS_AS(client.request("unknown"), std::runtime_error);
+
+    /* a line without end gets an error and its connection is closed */
+    {
+      sockaddr_un address;
+      std::memset(&address, 0, sizeof(address));
+      address.sun_family = AF_UNIX;
+      std::memcpy(address.sun_path, options.socketPath.c_str(), options.socketPath.size());
+      int endless = ::socket(AF_UNIX, SOCK_STREAM, 0);
+      REQUIRE(::connect(endless, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0);
+
+      const std::string data(DAEMON_MAX_LINE_SIZE_IN_BYTES + 1u, 'a');
+      size_t sent = 0u;
+      while (sent < data.size()) {
+        ssize_t result = ::send(endless, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        REQUIRE(result > 0);
+        sent += static_cast<size_t>(result);
+      }
+
+      std::string response;
+      char received[256];
+      ssize_t result = 0;
+      while ((result = ::recv(endless, received, sizeof(received), 0)) > 0) {
+        response.append(received, static_cast<size_t>(result));
+      }
+      ::close(endless);
+      REQUIRE(response.rfind(std::string("error") + DAEMON_FIELD_SEPARATOR, 0u) == 0u);
+    }
+
+    /* concurrent clients */
+    std::vector<double> volumes(8u, 0.0);
+    std::vector<std::thread> clients;
+    for (size_t i = 0u; i < volumes.size(); ++i) {
+      clients.emplace_back([&, i]() {
+        DaemonClient other(options.socketPath);
+        volumes[i] = other.volume(cube, {{TransformType::TRANSFORM_TYPE_SCALE, glm::dvec3(1.0 + i, 1.0, 1.0)}});
+      });
+    }
+    for (auto& t : clients) {
+      t.join();
+    }
+    for (size_t i = 0u; i < volumes.size(); ++i) {
+      REQUIRE(volumes[i] == Approx(8.0 * (1.0 + i)));
+    }
+
+    client.shutdown();
+  }
+
+  server.join();
+}
+
+TEST_CASE("Content hash", "[hash]") {
+  const std::string abc = "abc";
+  const std::string sentence = "Nobody inspects the spammish repetition";
+
+  REQUIRE(hash64(nullptr, 0u) == 0xEF46DB3751D8E999u);
+  REQUIRE(hash64(abc.data(), abc.size()) == 0x44BC2CF5AD770999u);
+  REQUIRE(hash64(sentence.data(), sentence.size()) == 0xFBCEA83C8A378BF1u);
+}
+
+TEST_CASE("Conversion result cache", "[cache]") {
+  const TemporaryDirectory temporary;
+  const auto directory = temporary.path / "3dfc_cache_test";
+  std::filesystem::remove_all(directory);
+
+  const std::vector<Transform> scale = {{TransformType::TRANSFORM_TYPE_SCALE, glm::dvec3(2.0, 2.0, 2.0)}};
+  const uint64_t cubeKey = ConversionCache::key(RES_DIR "cube.obj", InputType::INPUT_TYPE_OBJ, OutputType::OUTPUT_TYPE_STL, {});
+  const uint64_t scaledKey = ConversionCache::key(RES_DIR "cube.obj", InputType::INPUT_TYPE_OBJ, OutputType::OUTPUT_TYPE_STL, scale);
+  const uint64_t boxKey = ConversionCache::key(RES_DIR "box.obj", InputType::INPUT_TYPE_OBJ, OutputType::OUTPUT_TYPE_STL, {});
+  REQUIRE(cubeKey != scaledKey);
+  REQUIRE(cubeKey != boxKey);
+
+  /* an identical copy of the input gets the same key */
+  const auto copy = temporary.path / "3dfc_cache_copy.obj";
+  std::filesystem::copy_file(RES_DIR "cube.obj", copy, std::filesystem::copy_options::overwrite_existing);
+  REQUIRE(ConversionCache::key(copy.string(), InputType::INPUT_TYPE_OBJ, OutputType::OUTPUT_TYPE_STL, {}) == cubeKey);
+  std::filesystem::remove(copy);
+
+  /* the mapping hashed for the key is parsed by the session without reading the file again */
+  {
+    MappedFile file(RES_DIR "cube.obj");
+    REQUIRE(ConversionCache::key(file.data(), file.size(), InputType::INPUT_TYPE_OBJ, OutputType::OUTPUT_TYPE_STL, {}) == cubeKey);
+
+    FileConverter session;
+    session.setInputFormat(InputType::INPUT_TYPE_AUTO);
+    session.read(file, RES_DIR "cube.obj");
+    REQUIRE(session.volume() == Approx(8.0));
+  }
+
+  const uint64_t outputSize = std::filesystem::file_size(RES_DIR "cube.stl");
+  const std::string output = (directory / "fetched.stl").string();
+  {
+    ConversionCache cache(directory.string(), 2u * outputSize);
+    REQUIRE(!cache.fetch(cubeKey, output));
+
+    cache.store(cubeKey, RES_DIR "cube.stl");
+    cache.store(boxKey, RES_DIR "cube.stl");
+    REQUIRE(cache.fetch(cubeKey, output));
+    REQUIRE(std::filesystem::file_size(output) == outputSize);
+
+    /* the box is the least recently used output */
+    cache.store(scaledKey, RES_DIR "cube.stl");
+    REQUIRE(cache.sizeInBytes() == 2u * outputSize);
+    REQUIRE(!cache.fetch(boxKey, output));
+  }
+
+  /* the outputs are found again by the next run */
+  ConversionCache cache(directory.string(), 2u * outputSize);
+  REQUIRE(cache.sizeInBytes() == 2u * outputSize);
+  REQUIRE(cache.fetch(cubeKey, output));
+  REQUIRE(cache.fetch(scaledKey, output));
+
+  /* an output removed by another process leaves the existing output as it was */
+  std::ostringstream entry;
+  entry << std::hex << std::setw(16) << std::setfill('0') << cubeKey << ".bin";
+  REQUIRE(std::filesystem::remove(directory / entry.str()));
+  std::filesystem::resize_file(output, 1u);
+  REQUIRE(!cache.fetch(cubeKey, output));
+  REQUIRE(std::filesystem::file_size(output) == 1u);
+  for (const auto& file : std::filesystem::directory_iterator(directory)) {
+    REQUIRE(file.path().string().find(".tmp") == std::string::npos);
+  }
+
+  std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("Batch conversion", "[batch]") {
+  const TemporaryDirectory temporary;
+  const auto directory = temporary.path;
+
+  std::vector<BatchJob> jobs;
+  for (size_t i = 0u; i < 20u; ++i) {
+    BatchJob job;
+    job.inputPath = RES_DIR "cube.obj";
+    job.outputPath = (directory / ("3dfc_batch_" + std::to_string(i) + ".stl")).string();
+    job.transforms.push_back({TransformType::TRANSFORM_TYPE_SCALE, glm::dvec3(1.0 + i, 1.0, 1.0)});
+    job.transforms.push_back({TransformType::TRANSFORM_TYPE_TRANSLATE, glm::dvec3(0.0, 0.0, 1.0 * i)});
+    jobs.emplace_back(job);
+  }
+  BatchJob missing;
+  missing.inputPath = RES_DIR "missing.obj";
+  missing.outputPath = (directory / "3dfc_batch_missing.stl").string();
+  jobs.emplace_back(missing);
+
+  BatchOptions options;
+  options.maxNumOfMeshes = 3u;
+  BatchReport report = BatchConverter(options).run(jobs);
+
+  REQUIRE(report.failures.size() == 1u);
+  REQUIRE(report.failures[0].job == 20u);
+  REQUIRE(report.read.numOfJobs == 20u);
+  REQUIRE(report.transform.numOfJobs == 20u);
+  REQUIRE(report.write.numOfJobs == 20u);
+  REQUIRE(report.read.numOfTriangles == report.write.numOfTriangles);
+  REQUIRE(report.write.numOfBytes > 0u);
+  REQUIRE(report.wallSeconds > 0.0);
+
+  uint64_t numOfBytes = 0u;
+  for (size_t i = 0u; i < 20u; ++i) {
+    numOfBytes += std::filesystem::file_size(jobs[i].outputPath);
+    std::filesystem::remove(jobs[i].outputPath);
+  }
+  REQUIRE(numOfBytes == report.write.numOfBytes);
+  REQUIRE(!std::filesystem::exists(missing.outputPath));
+
+  SECTION("Testing the result cache") {
+    const auto cacheDirectory = directory / "3dfc_batch_cache";
+    std::filesystem::remove_all(cacheDirectory);
+    options.cache = std::make_shared<ConversionCache>(cacheDirectory.string(), 1u << 30u);
+    jobs.pop_back();
+
+    BatchReport first = BatchConverter(options).run(jobs);
+    BatchReport second = BatchConverter(options).run(jobs);
+    REQUIRE(first.numOfCacheHits == 0u);
+    REQUIRE(first.write.numOfJobs == 20u);
+    REQUIRE(second.numOfCacheHits == 20u);
+    REQUIRE(second.read.numOfJobs == 0u);
+    REQUIRE(std::filesystem::file_size(jobs[7].outputPath) == first.write.numOfBytes / 20u);
+
+    for (const auto& job : jobs) {
+      std::filesystem::remove(job.outputPath);
+    }
+    std::filesystem::remove_all(cacheDirectory);
+  }
+}
+
+TEST_CASE("Format detection", "[formats]") {
+  const auto& registry = FormatRegistry::instance();
+
+  SECTION("Testing detection from content") {
+    const ReaderFormat* obj = registry.detect(RES_DIR "cube.obj");
+    REQUIRE(obj != nullptr);
+    CHECK(obj->type == InputType::INPUT_TYPE_OBJ);
+    CHECK(0u != (obj->capabilities & READER_CAPABILITY_MMAP));
+
+    const std::string text = "# comment\nhello world\nnot a mesh\n";
+    CHECK(registry.detect(reinterpret_cast<const uint8_t*>(text.data()), text.size(), text.size()) == nullptr);
+
+    const std::vector<uint8_t> binary{0x00u, 0xffu, 0x10u, 0x80u, 0x01u};
+    CHECK(registry.detect(binary.data(), binary.size(), binary.size()) == nullptr);
+  }
+
+  SECTION("Testing an empty file") {
+    /* an empty .obj reads as an empty mesh, as it did before the detection */
+    const TemporaryDirectory temporary;
+    const auto empty = temporary.path / "3dfc_empty.obj";
+    std::ofstream(empty).close();
+
+    const ReaderFormat* format = registry.detect(empty.string());
+    REQUIRE(format != nullptr);
+    CHECK(format->type == InputType::INPUT_TYPE_OBJ);
+
+    FileConverter fc;
+    fc.setInputFormat(InputType::INPUT_TYPE_AUTO);
+    fc.read(empty.string());
+    CHECK(fc.mesh().geometricVertices.empty());
+    CHECK(fc.mesh().triangles.empty());
+
+    const std::string comments = "# exported without geometry\n\n";
+    format = registry.detect(reinterpret_cast<const uint8_t*>(comments.data()), comments.size(), comments.size());
+    REQUIRE(format != nullptr);
+    CHECK(format->type == InputType::INPUT_TYPE_OBJ);
+
+    std::filesystem::remove(empty);
+  }
+
+  SECTION("Testing output format by extension") {
+    REQUIRE(registry.writerForPath("mesh.STL") != nullptr);
+    CHECK(registry.writerForPath("mesh.STL")->type == OutputType::OUTPUT_TYPE_STL);
+    CHECK(registry.writer("stl") == registry.writer(OutputType::OUTPUT_TYPE_STL));
+    CHECK(registry.writerForPath("mesh.xyz") == nullptr);
+  }
+
+  SECTION("Testing a registered format") {
+    FormatRegistry custom;
+    custom.registerReader({InputType::INPUT_TYPE_OBJ, "obj", READER_CAPABILITY_NONE,
+                           [](const uint8_t* bytes, size_t size, uint64_t) { return (size > 0u && bytes[0] == 'M') ? 100 : 0; },
+                           [] { return std::make_unique<ReadObj>(); }});
+    const std::string magic = "MAGIC";
+    CHECK(custom.detect(reinterpret_cast<const uint8_t*>(magic.data()), magic.size(), magic.size()) != nullptr);
+    CHECK(custom.reader(InputType::INPUT_TYPE_OBJ)->capabilities == READER_CAPABILITY_NONE);
+  }
+
+  SECTION("Testing automatic formats of a session") {
+    const TemporaryDirectory temporary;
+    const auto directory = temporary.path;
+    FileConverter fc;
+    REQUIRE_NOTHROW(fc.setInputFormat(InputType::INPUT_TYPE_AUTO));
+    REQUIRE_NOTHROW(fc.setOutputFormat(OutputType::OUTPUT_TYPE_AUTO));
+    CHECK(fc.inputFormat() == nullptr);
+
+    REQUIRE_NOTHROW(fc.read(RES_DIR "cube.obj"));
+    REQUIRE(fc.inputFormat() != nullptr);
+    CHECK(fc.inputFormat()->name == "obj");
+    CHECK(fc.mesh().triangles.size() == 12u);
+
+    const std::string output = (directory / "3dfc_auto_test.stl").string();
+    REQUIRE_NOTHROW(fc.write(output));
+    CHECK(std::filesystem::file_size(output) > 84u);
+    std::filesystem::remove(output);
+    CHECK_THROWS(fc.write((directory / "3dfc_auto_test.xyz").string()));
+
+    const std::string unknown = (directory / "3dfc_auto_test.bin").string();
+    std::ofstream(unknown, std::ios::binary) << std::string("\x01\x02\x03", 3);
+    CHECK_THROWS(fc.read(unknown));
+    std::filesystem::remove(unknown);
+  }
+}
+
+TEST_CASE("Read from and write to memory", "[memory]") {
+  const TemporaryDirectory temporary;
+  const std::string path = (temporary.path / "3dfc_memory").string();
+
+  FileConverter source;
+  source.setInputFormat(InputType::INPUT_TYPE_AUTO);
+  source.read(RES_DIR "cube.obj");
+
+  /* function to read the whole file */
+  auto readFile = [&]() {
+    std::ifstream file(path, std::ios::binary);
+    return std::vector<uint8_t>((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  };
+
+  SECTION("Testing the bytes of every writer") {
+    for (OutputType type : {OutputType::OUTPUT_TYPE_STL, OutputType::OUTPUT_TYPE_PLY, OutputType::OUTPUT_TYPE_GLB,
+                            OutputType::OUTPUT_TYPE_NATIVE, OutputType::OUTPUT_TYPE_PACKED,
+                            OutputType::OUTPUT_TYPE_EDGEBREAKER, OutputType::OUTPUT_TYPE_OBJ,
+                            OutputType::OUTPUT_TYPE_OFF, OutputType::OUTPUT_TYPE_3MF}) {
+      source.setOutputFormat(type);
+      REQUIRE_NOTHROW(source.write(path));
+      std::vector<uint8_t> buffer;
+      REQUIRE_NOTHROW(source.write(buffer));
+      CHECK(buffer == readFile());
+
+      /* the formats with a reader are detected and read back from memory */
+      if (type != OutputType::OUTPUT_TYPE_GLB && type != OutputType::OUTPUT_TYPE_3MF) {
+        FileConverter fc;
+        fc.setInputFormat(InputType::INPUT_TYPE_AUTO);
+        REQUIRE_NOTHROW(fc.read(buffer.data(), buffer.size()));
+        CHECK(fc.volume() == Approx(source.volume()));
+      }
+    }
+  }
+
+  SECTION("Testing the name of an ASCII STL solid") {
+    source.setOutputFormat(OutputType::OUTPUT_TYPE_STL_ASCII);
+    std::vector<uint8_t> buffer;
+    REQUIRE_NOTHROW(source.write(buffer));
+    const std::string text(buffer.begin(), buffer.end());
+    CHECK(text.rfind("solid mesh\n", 0u) == 0u);
+    CHECK(text.find("endsolid mesh\n") != std::string::npos);
+  }
+
+  SECTION("Testing an archive appended to a buffer") {
+    source.setOutputFormat(OutputType::OUTPUT_TYPE_3MF);
+    REQUIRE_NOTHROW(source.write(path));
+    const std::vector<uint8_t> bytes = readFile();
+
+    std::vector<uint8_t> buffer = {'3', 'd', 'f', 'c'};
+    REQUIRE_NOTHROW(source.write(buffer));
+    REQUIRE(buffer.size() == bytes.size() + 4u);
+    CHECK(std::equal(bytes.begin(), bytes.end(), buffer.begin() + 4));
+  }
+
+  SECTION("Testing an archive written to a stream that cannot seek") {
+    /* stream buffer without positions, like a socket */
+    struct SequentialBuffer : public std::streambuf {
+      std::string bytes;
+
+      std::streamsize xsputn(const char* s, std::streamsize n) override {
+        bytes.append(s, static_cast<size_t>(n));
+        return n;
+      }
+
+      int_type overflow(int_type c) override {
+        bytes += traits_type::to_char_type(c);
+        return c;
+      }
+    };
+
+    SequentialBuffer output;
+    std::ostream stream(&output);
+    REQUIRE_NOTHROW(Write3mf(ZipMethod::ZIP_METHOD_STORED).write(stream, source.mesh(), Progress()));
+
+    /* the same entries stored in a seekable archive, for the checksums of their data */
+    std::vector<uint8_t> stored;
+    REQUIRE_NOTHROW(Write3mf(ZipMethod::ZIP_METHOD_STORED).write(stored, source.mesh(), Progress()));
+    const std::string seekable(stored.begin(), stored.end());
+
+    const std::string& bytes = output.bytes;
+    auto read = [](const std::string& archive, size_t position, size_t size) {
+      uint64_t value = 0u;
+      for (size_t i = size; i-- > 0u;) {
+        value = (value << 8u) | static_cast<uint8_t>(archive.at(position + i));
+      }
+      return value;
+    };
+
+    REQUIRE(bytes.size() >= 22u);
+    const size_t end = bytes.size() - 22u;
+    REQUIRE(bytes.compare(end, 4u, "PK\x05\x06") == 0);
+    const uint64_t numOfEntries = read(bytes, end + 10u, 2u);
+    CHECK(numOfEntries == 3u);
+
+    /* every entry is deflated and followed by a data descriptor that agrees with the central directory */
+    size_t central = static_cast<size_t>(read(bytes, end + 16u, 4u));
+    size_t storedCentral = static_cast<size_t>(read(seekable, seekable.size() - 22u + 16u, 4u));
+    for (uint64_t e = 0u; e < numOfEntries; ++e) {
+      REQUIRE(bytes.compare(central, 4u, "PK\x01\x02") == 0);
+      const uint64_t method = read(bytes, central + 10u, 2u);
+      const uint64_t crc = read(bytes, central + 16u, 4u);
+      const uint64_t compressedSize = read(bytes, central + 20u, 4u);
+      const uint64_t uncompressedSize = read(bytes, central + 24u, 4u);
+      const size_t nameSize = static_cast<size_t>(read(bytes, central + 28u, 2u));
+      const size_t local = static_cast<size_t>(read(bytes, central + 42u, 4u));
+      CHECK(method == static_cast<uint64_t>(ZipMethod::ZIP_METHOD_DEFLATED));
+
+      REQUIRE(bytes.compare(local, 4u, "PK\x03\x04") == 0);
+      CHECK((read(bytes, local + 6u, 2u) & 0x08u) != 0u);
+      CHECK(read(bytes, local + 8u, 2u) == method);
+      const size_t data = local + 30u + static_cast<size_t>(read(bytes, local + 26u, 2u) + read(bytes, local + 28u, 2u));
+      const size_t descriptor = data + static_cast<size_t>(compressedSize);
+      REQUIRE(bytes.compare(descriptor, 4u, "PK\x07\x08") == 0);
+      CHECK(read(bytes, descriptor + 4u, 4u) == crc);
+      CHECK(read(bytes, descriptor + 8u, 8u) == compressedSize);
+      CHECK(read(bytes, descriptor + 16u, 8u) == uncompressedSize);
+
+      /* the stored entry of the same name has the same data */
+      CHECK(seekable.compare(storedCentral + 46u, nameSize, bytes, central + 46u, nameSize) == 0);
+      CHECK(read(seekable, storedCentral + 24u, 4u) == uncompressedSize);
+      const size_t storedLocal = static_cast<size_t>(read(seekable, storedCentral + 42u, 4u));
+      const size_t storedData = storedLocal + 30u +
+                                static_cast<size_t>(read(seekable, storedLocal + 26u, 2u) + read(seekable, storedLocal + 28u, 2u));
+      REQUIRE(storedData + uncompressedSize <= stored.size());
+      CHECK(crc32(0u, stored.data() + storedData, static_cast<size_t>(uncompressedSize)) == crc);
+
+      central += 46u + nameSize + static_cast<size_t>(read(bytes, central + 30u, 2u) + read(bytes, central + 32u, 2u));
+      storedCentral += 46u + static_cast<size_t>(read(seekable, storedCentral + 28u, 2u) +
+                                                 read(seekable, storedCentral + 30u, 2u) + read(seekable, storedCentral + 32u, 2u));
+    }
+    CHECK(central == end);
+  }
+
+  SECTION("Testing a missing output format") {
+    source.setOutputFormat(OutputType::OUTPUT_TYPE_AUTO);
+    std::vector<uint8_t> buffer;
+    CHECK_THROWS(source.write(buffer));
+  }
+
+  SECTION("Testing unknown bytes") {
+    const std::vector<uint8_t> bytes(64u, 0xFFu);
+    FileConverter fc;
+    fc.setInputFormat(InputType::INPUT_TYPE_AUTO);
+    CHECK_THROWS(fc.read(bytes.data(), bytes.size()));
+  }
+
+  std::filesystem::remove(path);
+}
+
+TEST_CASE("Read binary STL", "[stl reader]") {
+  const TemporaryDirectory temporary;
+  const auto directory = temporary.path;
+  const std::string stl = (directory / "3dfc_read_stl.stl").string();
+
+  FileConverter source;
+  source.setInputFormat(InputType::INPUT_TYPE_OBJ);
+  source.setOutputFormat(OutputType::OUTPUT_TYPE_STL);
+  source.read(RES_DIR "cube.obj");
+  source.write(stl);
+  REQUIRE(std::filesystem::file_size(stl) == 84u + 12u * 50u);
+  REQUIRE(FormatRegistry::instance().detect(stl)->type == InputType::INPUT_TYPE_STL);
+
+  SECTION("Testing triangle soup") {
+    FileConverter fc;
+    fc.setInputFormat(InputType::INPUT_TYPE_AUTO);
+    REQUIRE_NOTHROW(fc.read(stl));
+    CHECK(fc.mesh().triangles.size() == 12u);
+    CHECK(fc.mesh().geometricVertices.size() == 36u);
+    CHECK(fc.volume() == Approx(source.volume()));
+  }
+
+  SECTION("Testing welded vertices") {
+    FileConverter fc;
+    fc.setReader(std::make_unique<ReadStl>(true));
+    REQUIRE_NOTHROW(fc.read(stl));
+    CHECK(fc.mesh().triangles.size() == 12u);
+    CHECK(fc.mesh().geometricVertices.size() == 8u);
+    CHECK(fc.volume() == Approx(source.volume()));
+    CHECK(fc.isPointInside(glm::dvec3(1.0, 1.0, 1.0)) == source.isPointInside(glm::dvec3(1.0, 1.0, 1.0)));
+  }
+
+  SECTION("Testing double precision records of earlier versions") {
+    std::vector<uint8_t> bytes(84u + 98u, 0u);
+    bytes[80] = 1u;
+    const double vertices[9] = {0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0, 0.0};
+    std::memcpy(bytes.data() + 84u + 3u * sizeof(double), vertices, sizeof(vertices));
+
+    MeshData data;
+    REQUIRE_NOTHROW(ReadStl().read(bytes.data(), bytes.size(), data, Progress()));
+    REQUIRE(data.triangles.size() == 1u);
+    CHECK(data.triangles[0].vertices[1] == glm::dvec3(1.0, 0.0, 0.0));
+    CHECK(data.triangles[0].normal == glm::dvec3(0.0, 0.0, 1.0));
+  }
+
+  SECTION("Testing invalid files") {
+    MeshData data;
+    REQUIRE_NOTHROW(ReadStl().read(RES_DIR "box.stl", data));
+    CHECK(data.triangles.empty());
+
+    std::vector<uint8_t> truncated(84u + 49u, 0u);
+    truncated[80] = 1u;
+    CHECK_THROWS(ReadStl().read(truncated.data(), truncated.size(), data, Progress()));
+    CHECK_THROWS(ReadStl().read(truncated.data(), 10u, data, Progress()));
+  }
+
+  std::filesystem::remove(stl);
+}
+
+TEST_CASE("ASCII STL", "[stl ascii]") {
+  const TemporaryDirectory temporary;
+  const auto directory = temporary.path;
+  const std::string stl = (directory / "3dfc_ascii.stl").string();
+
+  SECTION("Testing a round trip") {
+    FileConverter source;
+    source.setInputFormat(InputType::INPUT_TYPE_OBJ);
+    source.setOutputFormat(OutputType::OUTPUT_TYPE_STL_ASCII);
+    source.read(RES_DIR "cube.obj");
+    source.rotate(glm::dvec3(0.1, 0.2, 0.3));
+    REQUIRE_NOTHROW(source.write(stl));
+    REQUIRE(FormatRegistry::instance().detect(stl)->type == InputType::INPUT_TYPE_STL_ASCII);
+
+    FileConverter fc;
+    fc.setInputFormat(InputType::INPUT_TYPE_AUTO);
+    REQUIRE_NOTHROW(fc.read(stl));
+    REQUIRE(fc.mesh().triangles.size() == source.mesh().triangles.size());
+    for (size_t i = 0u; i < fc.mesh().triangles.size(); ++i) {
+      CHECK(fc.mesh().triangles[i].vertices == source.mesh().triangles[i].vertices);
+    }
+
+    fc.setReader(std::make_unique<ReadStlAscii>(true));
+    REQUIRE_NOTHROW(fc.read(stl));
+    CHECK(fc.mesh().geometricVertices.size() == 8u);
+    CHECK(fc.volume() == Approx(8.0));
+  }
+
+  SECTION("Testing a file parsed in many chunks") {
+    MeshData data;
+    for (uint32_t i = 0u; i < 30000u; ++i) {
+      const double x = 0.001 * i;
+      data.geometricVertices.push_back({x, 0.0, 0.0, 1.0});
+      data.geometricVertices.push_back({x, 1.0 / 3.0, 0.0, 1.0});
+      data.geometricVertices.push_back({x, 0.0, -1e-7, 1.0});
+      Face f;
+      f.geometricVertexReferences = {3u * i + 1u, 3u * i + 2u, 3u * i + 3u};
+      data.faces.push_back(f);
+    }
+    data.updateTriangles();
+    REQUIRE_NOTHROW(WriteStlAscii().write(stl, data));
+    REQUIRE(std::filesystem::file_size(stl) > (2u << 20u));
+
+    MeshData read;
+    REQUIRE_NOTHROW(ReadStlAscii().read(stl, read));
+    REQUIRE(read.triangles.size() == data.triangles.size());
+    bool isEqual = true;
+    for (size_t i = 0u; i < read.triangles.size(); ++i) {
+      isEqual = isEqual && (read.triangles[i].vertices == data.triangles[i].vertices);
+    }
+    CHECK(isEqual);
+  }
+
+  SECTION("Testing invalid files") {
+    const std::string twoVertices = "solid vertex\nfacet normal 0 0 1\nouter loop\nvertex 0 0 0\nvertex 1 0 0\n"
+                                    "endloop\nendfacet\nendsolid vertex\n";
+    const std::string badNumber = "solid s\nfacet normal 0 0 1\nouter loop\nvertex 0 0 0\nvertex 1 x 0\n"
+                                  "vertex 0 1 0\nendloop\nendfacet\nendsolid s\n";
+    MeshData data;
+    CHECK_THROWS(ReadStlAscii().read(reinterpret_cast<const uint8_t*>(twoVertices.data()), twoVertices.size(), data, Progress()));
+    CHECK_THROWS(ReadStlAscii().read(reinterpret_cast<const uint8_t*>(badNumber.data()), badNumber.size(), data, Progress()));
+
+    const std::string empty = "solid empty\nendsolid empty\n";
+    REQUIRE_NOTHROW(ReadStlAscii().read(reinterpret_cast<const uint8_t*>(empty.data()), empty.size(), data, Progress()));
+    CHECK(data.triangles.empty());
+  }
+
+  std::filesystem::remove(stl);
+}
+
+TEST_CASE("Binary PLY", "[ply]") {
+  const TemporaryDirectory temporary;
+  const auto directory = temporary.path;
+  const std::string ply = (directory / "3dfc_binary.ply").string();
+
+  SECTION("Testing a round trip") {
+    FileConverter source;
+    source.setInputFormat(InputType::INPUT_TYPE_OBJ);
+    source.setOutputFormat(OutputType::OUTPUT_TYPE_AUTO);
+    source.read(RES_DIR "cube.obj");
+    REQUIRE_NOTHROW(source.write(ply));
+    REQUIRE(FormatRegistry::instance().detect(ply)->type == InputType::INPUT_TYPE_PLY);
+
+    FileConverter fc;
+    fc.setInputFormat(InputType::INPUT_TYPE_AUTO);
+    REQUIRE_NOTHROW(fc.read(ply));
+    CHECK(fc.mesh().geometricVertices.size() == source.mesh().geometricVertices.size());
+    CHECK(fc.mesh().faces.size() == source.mesh().faces.size());
+    CHECK(fc.mesh().triangles.size() == source.mesh().triangles.size());
+    CHECK(fc.volume() == Approx(8.0));
+  }
+
+  /* big endian quad with normals, a face property before the indices and an element after the faces */
+  std::string header = "ply\nformat binary_big_endian 1.0\nelement vertex 4\n"
+                       "property double x\nproperty double y\nproperty double z\n"
+                       "property float nx\nproperty float ny\nproperty float nz\n"
+                       "element face 1\nproperty uchar flags\nproperty list uchar uint vertex_indices\n"
+                       "element edge 1\nproperty list uchar int vertex_pair\nend_header\n";
+  std::vector<uint8_t> bytes(header.begin(), header.end());
+  auto appendBigEndian = [&](const auto& value) {
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(&value);
+    for (size_t i = sizeof(value); i > 0u; --i) {
+      bytes.push_back(p[i - 1u]);
+    }
+  };
+  const double positions[4][3] = {{0.0, 0.0, 0.0}, {1.0, 0.0, 0.0}, {1.0, 1.0, 0.0}, {0.0, 1.0, 0.0}};
+  for (const auto& p : positions) {
+    appendBigEndian(p[0]);
+    appendBigEndian(p[1]);
+    appendBigEndian(p[2]);
+    appendBigEndian(0.0f);
+    appendBigEndian(0.0f);
+    appendBigEndian(1.0f);
+  }
+  bytes.push_back(7u);
+  bytes.push_back(4u);
+  for (uint32_t i = 0u; i < 4u; ++i) {
+    appendBigEndian(i);
+  }
+  bytes.push_back(2u);
+  appendBigEndian(int32_t(0));
+  appendBigEndian(int32_t(1));
+
+  SECTION("Testing a general file") {
+    MeshData data;
+    REQUIRE_NOTHROW(ReadPly().read(bytes.data(), bytes.size(), data, Progress()));
+    REQUIRE(data.faces.size() == 1u);
+    CHECK(data.faces[0].geometricVertexReferences == std::vector<uint32_t>{1u, 2u, 3u, 4u});
+    CHECK(data.faces[0].vertexNormalReferences == data.faces[0].geometricVertexReferences);
+    CHECK(data.vertexNormals[2] == glm::dvec3(0.0, 0.0, 1.0));
+    CHECK(data.geometricVertices[2] == glm::dvec4(1.0, 1.0, 0.0, 1.0));
+    CHECK(data.triangles.size() == 2u);
+
+    /* the normals are written per vertex */
+    REQUIRE_NOTHROW(WritePly().write(ply, data));
+    MeshData read;
+    REQUIRE_NOTHROW(ReadPly().read(ply, read));
+    CHECK(read.vertexNormals == data.vertexNormals);
+    CHECK(read.faces[0].geometricVertexReferences == data.faces[0].geometricVertexReferences);
+  }
+
+  SECTION("Testing invalid files") {
+    MeshData data;
+    std::vector<uint8_t> truncated(bytes.begin(), bytes.end() - 5);
+    CHECK_THROWS(ReadPly().read(truncated.data(), truncated.size(), data, Progress()));
+
+    std::vector<uint8_t> outOfRange(bytes);
+    outOfRange[outOfRange.size() - 10u - 1u] = 9u;
+    CHECK_THROWS(ReadPly().read(outOfRange.data(), outOfRange.size(), data, Progress()));
+
+    const std::string ascii = "ply\nformat ascii 1.0\nelement vertex 0\nend_header\n";
+    CHECK_THROWS(ReadPly().read(reinterpret_cast<const uint8_t*>(ascii.data()), ascii.size(), data, Progress()));
+  }
+
+  std::filesystem::remove(ply);
+}
+
+TEST_CASE("OBJ writer", "[obj]") {
+  const TemporaryDirectory temporary;
+  const std::string obj = (temporary.path / "3dfc_written.obj").string();
+
+  /* function to write the mesh and check that the same arrays are read back */
+  auto roundTrip = [&](const MeshData& source) {
+    REQUIRE_NOTHROW(WriteObj().write(obj, source));
+    REQUIRE(FormatRegistry::instance().detect(obj)->type == InputType::INPUT_TYPE_OBJ);
+
+    FileConverter fc;
+    fc.setInputFormat(InputType::INPUT_TYPE_AUTO);
+    REQUIRE_NOTHROW(fc.read(obj));
+    const MeshData& data = fc.mesh();
+    CHECK(data.geometricVertices == source.geometricVertices);
+    CHECK(data.textureVertices == source.textureVertices);
+    CHECK(data.vertexNormals == source.vertexNormals);
+    REQUIRE(data.faces.size() == source.faces.size());
+    for (size_t i = 0u; i < data.faces.size(); ++i) {
+      CHECK(data.faces[i].geometricVertexReferences == source.faces[i].geometricVertexReferences);
+      CHECK(data.faces[i].textureVertexReferences == source.faces[i].textureVertexReferences);
+      CHECK(data.faces[i].vertexNormalReferences == source.faces[i].vertexNormalReferences);
+    }
+  };
+
+  SECTION("Testing the files of the meshes") {
+    for (const char* name : {RES_DIR "cube.obj", RES_DIR "cube2.obj", RES_DIR "box.obj"}) {
+      FileConverter source;
+      source.setInputFormat(InputType::INPUT_TYPE_OBJ);
+      source.read(name);
+      roundTrip(source.mesh());
+    }
+  }
+
+  SECTION("Testing every face variant and exact numbers") {
+    MeshData data;
+    data.geometricVertices = {{0.1, -2.5e-300, 1e21, 1.0}, {1.0 / 3.0, 0.0, -0.0, 0.5}, {1.0, 1.0, 1.0, 1.0},
+                              {-7.0, 123456789.125, 2.0, 1.0}};
+    data.textureVertices = {{0.25, 0.75, 0.0}, {1.0 / 7.0, 0.0, 0.5}, {1.0, 1.0, 0.0}};
+    data.vertexNormals = {{0.0, 0.0, 1.0}, {0.6, 0.8, 0.0}};
+
+    Face f;
+    f.geometricVertexReferences = {1u, 2u, 3u};
+    data.faces.push_back(f);
+    f.textureVertexReferences = {1u, 2u, 3u};
+    data.faces.push_back(f);
+    f.vertexNormalReferences = {1u, 2u, 1u};
+    data.faces.push_back(f);
+    f.geometricVertexReferences = {1u, 2u, 3u, 4u};
+    f.textureVertexReferences.clear();
+    f.vertexNormalReferences = {1u, 2u, 2u, 1u};
+    data.faces.push_back(f);
+    data.updateTriangles();
+    roundTrip(data);
+  }
+
+  SECTION("Testing writing by the extension") {
+    FileConverter fc;
+    fc.setInputFormat(InputType::INPUT_TYPE_OBJ);
+    fc.setOutputFormat(OutputType::OUTPUT_TYPE_AUTO);
+    fc.read(RES_DIR "cube.obj");
+    fc.translate(glm::dvec3(1.0, 2.0, 3.0));
+    REQUIRE_NOTHROW(fc.write(obj));
+
+    FileConverter translated;
+    translated.setInputFormat(InputType::INPUT_TYPE_AUTO);
+    translated.read(obj);
+    CHECK(translated.volume() == Approx(8.0));
+    CHECK(translated.properties().centroid.x == Approx(fc.properties().centroid.x));
+  }
+  std::filesystem::remove(obj);
+}
+
+TEST_CASE("OFF format", "[off]") {
+  const TemporaryDirectory temporary;
+  const auto directory = temporary.path;
+  const std::string off = (directory / "3dfc_mesh.off").string();
+
+  /* function to read the text as an .off file */
+  auto readText = [](const std::string& text, MeshData& data) {
+    ReadOff().read(reinterpret_cast<const uint8_t*>(text.data()), text.size(), data, Progress());
+  };
+
+  SECTION("Testing a round trip") {
+    for (const char* name : {RES_DIR "cube.obj", RES_DIR "cube2.obj", RES_DIR "box.obj"}) {
+      FileConverter source;
+      source.setInputFormat(InputType::INPUT_TYPE_OBJ);
+      source.setOutputFormat(OutputType::OUTPUT_TYPE_AUTO);
+      source.read(name);
+      REQUIRE_NOTHROW(source.write(off));
+      REQUIRE(FormatRegistry::instance().detect(off)->type == InputType::INPUT_TYPE_OFF);
+
+      FileConverter fc;
+      fc.setInputFormat(InputType::INPUT_TYPE_AUTO);
+      REQUIRE_NOTHROW(fc.read(off));
+      CHECK(fc.mesh().geometricVertices == source.mesh().geometricVertices);
+      REQUIRE(fc.mesh().faces.size() == source.mesh().faces.size());
+      for (size_t i = 0u; i < fc.mesh().faces.size(); ++i) {
+        CHECK(fc.mesh().faces[i].geometricVertexReferences == source.mesh().faces[i].geometricVertexReferences);
+      }
+      CHECK(fc.volume() == Approx(source.volume()));
+    }
+  }
+
+  SECTION("Testing the prefixes, comments and colors") {
+    MeshData data;
+    readText("# unit square\nSTCNOFF\n\n4 1 4\n"
+             "0 0 0  0 0 1  255 0 0 255  0 0\n"
+             "1 0 0  0 0 1  255 0 0 255  1 0 # corner\n"
+             "1 1 0  0 0 1  255 0 0 255  1 1\n"
+             "0 1 0  0 0 1  255 0 0 255  0 1\n"
+             "4 0 1 2 3  0.5 0.5 0.5\n", data);
+    REQUIRE(data.geometricVertices.size() == 4u);
+    REQUIRE(data.faces.size() == 1u);
+    CHECK(data.faces[0].geometricVertexReferences == std::vector<uint32_t>{1u, 2u, 3u, 4u});
+    CHECK(data.faces[0].vertexNormalReferences == data.faces[0].geometricVertexReferences);
+    CHECK(data.faces[0].textureVertexReferences == data.faces[0].geometricVertexReferences);
+    CHECK(data.vertexNormals[2] == glm::dvec3(0.0, 0.0, 1.0));
+    CHECK(data.textureVertices[2] == glm::dvec3(1.0, 1.0, 0.0));
+    CHECK(data.triangles.size() == 2u);
+
+    /* counts on the keyword line, homogeneous coordinates, appended after the existing mesh */
+    readText("4OFF 3 1 0\n0 0 0 1\n2 0 0 2\n0 4 0 4\n3 0 1 2\n", data);
+    REQUIRE(data.geometricVertices.size() == 7u);
+    CHECK(data.geometricVertices[5] == glm::dvec4(1.0, 0.0, 0.0, 1.0));
+    CHECK(data.faces[1].geometricVertexReferences == std::vector<uint32_t>{5u, 6u, 7u});
+  }
+
+  SECTION("Testing invalid files") {
+    MeshData data;
+    CHECK_THROWS(readText("OFF\n3 1 0\n0 0 0\n1 0 0\n", data));
+    CHECK_THROWS(readText("OFF\n3 1 0\n0 0 0\n1 0 0\n0 1 0\n3 0 1 3\n", data));
+    CHECK_THROWS(readText("OFF\n3 1 0\n0 0 0\n1 0 x\n0 1 0\n3 0 1 2\n", data));
+    CHECK_THROWS(readText("OFF\n1000000000 1 0\n0 0 0\n", data));
+    CHECK_THROWS(readText("OFF BINARY\n", data));
+    CHECK_THROWS(readText("nOFF\n", data));
+  }
+  std::filesystem::remove(off);
+}
+
+TEST_CASE("3MF writer", "[3mf]") {
+  const TemporaryDirectory temporary;
+  const std::string path = (temporary.path / "3dfc_cube.3mf").string();
+
+  MeshData data;
+  REQUIRE_NOTHROW(ReadObj().read(RES_DIR "cube.obj", data));
+
+  /* function to read the archive, checking the end of central directory record */
+  auto readArchive = [&]() {
+    std::ifstream file(path, std::ios::binary);
+    std::string bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    REQUIRE(bytes.size() >= 22u);
+
+    uint32_t signature = 0u;
+    uint16_t numOfEntries = 0u;
+    std::memcpy(&signature, bytes.data() + bytes.size() - 22u, sizeof(signature));
+    std::memcpy(&numOfEntries, bytes.data() + bytes.size() - 12u, sizeof(numOfEntries));
+    CHECK(signature == 0x06054B50u);
+    CHECK(numOfEntries == 3u);
+    return bytes;
+  };
+
+  /* function to count the occurrences of the text */
+  auto count = [](const std::string& bytes, const std::string& text) {
+    size_t n = 0u;
+    for (size_t pos = bytes.find(text); pos != std::string::npos; pos = bytes.find(text, pos + 1u)) {
+      ++n;
+    }
+    return n;
+  };
+
+  SECTION("Testing the CRC-32") {
+    const std::string check = "123456789";
+    CHECK(crc32(0u, reinterpret_cast<const uint8_t*>(check.data()), check.size()) == 0xCBF43926u);
+
+    /* the CRC can be updated in parts */
+    const uint32_t first = crc32(0u, reinterpret_cast<const uint8_t*>(check.data()), 4u);
+    CHECK(crc32(first, reinterpret_cast<const uint8_t*>(check.data()) + 4u, 5u) == 0xCBF43926u);
+  }
+
+  SECTION("Testing the stored model") {
+    REQUIRE_NOTHROW(Write3mf(ZipMethod::ZIP_METHOD_STORED).write(path, data));
+    const std::string bytes = readArchive();
+
+    CHECK(bytes.compare(0u, 4u, "PK\x03\x04") == 0);
+    CHECK(count(bytes, "[Content_Types].xml") == 2u);
+    CHECK(count(bytes, "3D/3dmodel.model") == 3u);
+
+    /* 8 corners, 6 quads as 12 triangles */
+    CHECK(count(bytes, "<vertex ") == 8u);
+    CHECK(count(bytes, "<triangle ") == 12u);
+  }
+
+  SECTION("Testing the deflated model") {
+    REQUIRE_NOTHROW(Write3mf(ZipMethod::ZIP_METHOD_STORED).write(path, data));
+    const size_t storedSize = readArchive().size();
+
+    REQUIRE_NOTHROW(Write3mf().write(path, data));
+    const std::string bytes = readArchive();
+    CHECK(bytes.size() < storedSize);
+    CHECK(count(bytes, "<vertex ") == 0u);
+  }
+
+  SECTION("Testing the writer by the extension") {
+    FileConverter fc;
+    fc.setInputFormat(InputType::INPUT_TYPE_OBJ);
+    fc.setOutputFormat(OutputType::OUTPUT_TYPE_AUTO);
+    fc.read(RES_DIR "cube.obj");
+    REQUIRE_NOTHROW(fc.write(path));
+    readArchive();
+  }
+
+  SECTION("Testing invalid references") {
+    data.faces[0].geometricVertexReferences[0] = 100u;
+    CHECK_THROWS(Write3mf().write(path, data));
+  }
+
+  std::filesystem::remove(path);
+}
+
+TEST_CASE("GLB writer", "[glb]") {
+  const TemporaryDirectory temporary;
+  const std::string glb = (temporary.path / "3dfc_cube.glb").string();
+
+  MeshData data;
+  REQUIRE_NOTHROW(ReadObj().read(RES_DIR "cube.obj", data));
+
+  /* function to read the file and return its JSON chunk, checking the header */
+  auto readGlb = [&]() {
+    std::ifstream file(glb, std::ios::binary);
+    std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    REQUIRE(bytes.size() >= 20u);
+
+    uint32_t header[5];
+    std::memcpy(header, bytes.data(), sizeof(header));
+    CHECK(header[0] == 0x46546C67u);
+    CHECK(header[1] == 2u);
+    CHECK(header[2] == bytes.size());
+    CHECK(header[3] % 4u == 0u);
+    CHECK(header[4] == 0x4E4F534Au);
+    return std::string(bytes.begin() + 20, bytes.begin() + 20 + header[3]);
+  };
+
+  SECTION("Testing the corners with normals") {
+    REQUIRE_NOTHROW(WriteGlb().write(glb, data));
+    const std::string json = readGlb();
+
+    /* 4 corners per side of the cube, 16 bit indices */
+    CHECK(json.find("\"NORMAL\":1") != std::string::npos);
+    CHECK(json.find("\"count\":24,\"type\":\"VEC3\",\"min\":[0,0,0],\"max\":[2,2,2]") != std::string::npos);
+    CHECK(json.find("\"componentType\":5123,\"count\":36") != std::string::npos);
+  }
+
+  SECTION("Testing the corners without normals") {
+    for (auto& f : data.faces) {
+      f.vertexNormalReferences.clear();
+    }
+    REQUIRE_NOTHROW(WriteGlb().write(glb, data));
+    const std::string json = readGlb();
+
+    CHECK(json.find("NORMAL") == std::string::npos);
+    CHECK(json.find("\"count\":8,\"type\":\"VEC3\"") != std::string::npos);
+  }
+
+  SECTION("Testing an empty mesh") {
+    REQUIRE_NOTHROW(WriteGlb().write(glb, MeshData()));
+    CHECK(readGlb().find("\"nodes\":[]") != std::string::npos);
+  }
+
+  std::filesystem::remove(glb);
+}
+
+TEST_CASE("Native format", "[native]") {
+  const TemporaryDirectory temporary;
+  const std::string native = (temporary.path / "3dfc_cube.3dfc").string();
+
+  MeshData data;
+  REQUIRE_NOTHROW(ReadObj().read(RES_DIR "cube.obj", data));
+  data.faces[0].textureVertexReferences = {1u, 1u, 1u};
+  data.textureVertices = {glm::dvec3(0.5, 0.25, 0.0)};
+  REQUIRE_NOTHROW(WriteNative().write(native, data));
+  REQUIRE(FormatRegistry::instance().detect(native)->type == InputType::INPUT_TYPE_NATIVE);
+
+  SECTION("Testing the view of the file") {
+    NativeMesh mesh(native);
+    REQUIRE(mesh.numOfFaces() == data.faces.size());
+    REQUIRE(mesh.geometricVertices().size == data.geometricVertices.size());
+    CHECK(reinterpret_cast<uintptr_t>(mesh.geometricVertices().data) % NATIVE_SECTION_ALIGNMENT == 0u);
+    CHECK(mesh.geometricVertices()[7] == data.geometricVertices[7]);
+    CHECK(mesh.offsets(NATIVE_SECTION_TEXTURE_OFFSETS)[1] == 3u);
+    CHECK(mesh.offsets(NATIVE_SECTION_TEXTURE_OFFSETS)[2] == 3u);
+    CHECK_NOTHROW(mesh.verify());
+  }
+
+  SECTION("Testing a round trip") {
+    FileConverter fc;
+    fc.setInputFormat(InputType::INPUT_TYPE_AUTO);
+    REQUIRE_NOTHROW(fc.read(native));
+    CHECK(fc.mesh().geometricVertices == data.geometricVertices);
+    CHECK(fc.mesh().vertexNormals == data.vertexNormals);
+    CHECK(fc.mesh().textureVertices == data.textureVertices);
+    REQUIRE(fc.mesh().faces.size() == data.faces.size());
+    for (size_t i = 0u; i < data.faces.size(); ++i) {
+      CHECK(fc.mesh().faces[i].geometricVertexReferences == data.faces[i].geometricVertexReferences);
+      CHECK(fc.mesh().faces[i].textureVertexReferences == data.faces[i].textureVertexReferences);
+      CHECK(fc.mesh().faces[i].vertexNormalReferences == data.faces[i].vertexNormalReferences);
+    }
+    CHECK(fc.volume() == Approx(8.0));
+  }
+
+  SECTION("Testing unaligned bytes") {
+    std::ifstream file(native, std::ios::binary);
+    const std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    std::vector<uint8_t> buffer(bytes.size() + 1u);
+    std::memcpy(buffer.data() + 1u, bytes.data(), bytes.size());
+
+    NativeMesh mesh(buffer.data() + 1u, bytes.size());
+    CHECK(reinterpret_cast<uintptr_t>(mesh.geometricVertices().data) % NATIVE_SECTION_ALIGNMENT == 0u);
+    CHECK(mesh.geometricVertices()[7] == data.geometricVertices[7]);
+    CHECK_NOTHROW(mesh.verify());
+
+    FileConverter fc;
+    fc.setInputFormat(InputType::INPUT_TYPE_AUTO);
+    REQUIRE_NOTHROW(fc.read(buffer.data() + 1u, bytes.size()));
+    CHECK(fc.mesh().geometricVertices == data.geometricVertices);
+    CHECK(fc.volume() == Approx(8.0));
+  }
+
+  SECTION("Testing invalid files") {
+    std::ifstream file(native, std::ios::binary);
+    std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    MeshData read;
+
+    std::vector<uint8_t> truncated(bytes.begin(), bytes.end() - 4);
+    CHECK_THROWS(ReadNative().read(truncated.data(), truncated.size(), read, Progress()));
+
+    std::vector<uint8_t> corrupted(bytes);
+    corrupted[bytes.size() - 1u] ^= 1u;
+    CHECK_THROWS(ReadNative().read(corrupted.data(), corrupted.size(), read, Progress()));
+
+    std::vector<uint8_t> header(bytes);
+    header[sizeof(NATIVE_MAGIC) + 12u] ^= 1u;
+    CHECK_THROWS(NativeMesh(header.data(), header.size()));
+
+    /* a number of faces that wraps around, with a valid header checksum */
+    NativeHeader wrapped;
+    std::memcpy(&wrapped, bytes.data(), sizeof(wrapped));
+    wrapped.numOfFaces = std::numeric_limits<uint64_t>::max();
+    for (NativeSection kind : {NATIVE_SECTION_GEOMETRIC_OFFSETS, NATIVE_SECTION_TEXTURE_OFFSETS, NATIVE_SECTION_NORMAL_OFFSETS}) {
+      wrapped.sections[kind].count = 0u;
+    }
+    wrapped.checksum = hash64(&wrapped, offsetof(NativeHeader, checksum));
+    std::vector<uint8_t> faces(bytes);
+    std::memcpy(faces.data(), &wrapped, sizeof(wrapped));
+    CHECK_THROWS_AS(NativeMesh(faces.data(), faces.size()), std::runtime_error);
+    CHECK_THROWS_AS(ReadNative().read(faces.data(), faces.size(), read, Progress()), std::runtime_error);
+  }
+
+  std::filesystem::remove(native);
+}
+
+TEST_CASE("Compressed format", "[packed]") {
+  const TemporaryDirectory temporary;
+  const std::string packed = (temporary.path / "3dfc_cube.3dfz").string();
+
+  SECTION("Testing the entropy coder") {
+    std::vector<uint8_t> skewed(100000u);
+    for (size_t i = 0u; i < skewed.size(); ++i) {
+      skewed[i] = static_cast<uint8_t>((i % 7u == 0u) ? (i * 31u) : (i % 3u));
+    }
+    const std::vector<uint8_t> encoded = entropyEncode(skewed);
+    CHECK(encoded.size() < skewed.size() / 2u);
+    CHECK(entropyDecode(encoded.data(), encoded.size(), skewed.size()) == skewed);
+
+    std::vector<uint8_t> noise(4096u);
+    uint64_t state = 1u;
+    for (auto& b : noise) {
+      state = state * 6364136223846793005u + 1442695040888963407u;
+      b = static_cast<uint8_t>(state >> 56u);
+    }
+    const std::vector<uint8_t> stored = entropyEncode(noise);
+    CHECK(entropyDecode(stored.data(), stored.size(), noise.size()) == noise);
+
+    const std::vector<uint8_t> empty = entropyEncode({});
+    CHECK(entropyDecode(empty.data(), empty.size(), 0u).empty());
+    CHECK_THROWS(entropyDecode(encoded.data(), encoded.size() - 1u, skewed.size()));
+
+    /* a single byte value still costs some bits, so a short stream cannot claim a huge decoded size */
+    const std::vector<uint8_t> same(100000u, 7u);
+    const std::vector<uint8_t> encodedSame = entropyEncode(same);
+    CHECK(encodedSame.size() < 400u);
+    CHECK(entropyDecode(encodedSame.data(), encodedSame.size(), same.size()) == same);
+
+    std::vector<uint8_t> forged;
+    appendVarint(forged, uint64_t(1u) << 40u);
+    forged.push_back(1u);
+    appendVarint(forged, 4096u);
+    forged.insert(forged.end(), 255u + 8u, 0u);
+    forged[forged.size() - 1u] = 0x7Fu;
+    forged[forged.size() - 5u] = 0x7Fu;
+    CHECK_THROWS(entropyDecode(forged.data(), forged.size(), std::numeric_limits<size_t>::max()));
+  }
+
+  SECTION("Testing a round trip") {
+    FileConverter source;
+    source.setInputFormat(InputType::INPUT_TYPE_OBJ);
+    source.read(RES_DIR "cube2.obj");
+    REQUIRE_NOTHROW(WritePacked(12u).write(packed, source.mesh()));
+
+    FileConverter fc;
+    fc.setInputFormat(InputType::INPUT_TYPE_AUTO);
+    REQUIRE_NOTHROW(fc.read(packed));
+    REQUIRE(fc.inputFormat()->type == InputType::INPUT_TYPE_PACKED);
+    REQUIRE(fc.mesh().faces.size() == source.mesh().faces.size());
+
+    /* every corner lies within half a quantization step of the original along each axis */
+    const MeshProperties& properties = source.properties();
+    const glm::dvec3 step = (properties.boundsMax - properties.boundsMin) / 4095.0;
+    const double tolerance = 0.5 * glm::length(step) * (1.0 + 1e-9);
+    for (size_t i = 0u; i < source.mesh().triangles.size(); ++i) {
+      for (size_t k = 0u; k < 3u; ++k) {
+        CHECK(glm::length(fc.mesh().triangles[i].vertices[k] - source.mesh().triangles[i].vertices[k]) <= tolerance);
+      }
+    }
+    CHECK(fc.volume() == Approx(source.volume()).epsilon(0.01));
+  }
+
+  SECTION("Testing invalid input") {
+    CHECK_THROWS_AS(WritePacked(0u), std::invalid_argument);
+    CHECK_THROWS_AS(WritePacked(31u), std::invalid_argument);
+
+    MeshData data;
+    REQUIRE_NOTHROW(ReadObj().read(RES_DIR "cube.obj", data));
+    REQUIRE_NOTHROW(WritePacked().write(packed, data));
+    std::ifstream file(packed, std::ios::binary);
+    std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    MeshData read;
+    REQUIRE_NOTHROW(ReadPacked().read(bytes.data(), bytes.size(), read, Progress()));
+    CHECK(read.geometricVertices.size() == 8u);
+    CHECK_THROWS(ReadPacked().read(bytes.data(), bytes.size() - 1u, read, Progress()));
+
+    /* a file of the other byte order */
+    std::vector<uint8_t> swapped = bytes;
+    std::reverse(swapped.begin() + offsetof(PackedHeader, byteOrderMark),
+                 swapped.begin() + offsetof(PackedHeader, byteOrderMark) + sizeof(uint32_t));
+    CHECK_THROWS(ReadPacked().read(swapped.data(), swapped.size(), read, Progress()));
+
+    /* more blocks than the file can hold */
+    std::vector<uint8_t> manyBlocks = bytes;
+    const uint32_t numOfBlocks = std::numeric_limits<uint32_t>::max();
+    std::memcpy(manyBlocks.data() + offsetof(PackedHeader, numOfFaceBlocks), &numOfBlocks, sizeof(numOfBlocks));
+    CHECK_THROWS(ReadPacked().read(manyBlocks.data(), manyBlocks.size(), read, Progress()));
+  }
+
+  SECTION("Testing the compression ratio") {
+    /* wavy height field of 200 x 200 quads, split into triangles */
+    const uint32_t n = 200u;
+    MeshData data;
+    for (uint32_t i = 0u; i <= n; ++i) {
+      for (uint32_t j = 0u; j <= n; ++j) {
+        data.geometricVertices.emplace_back(i, j, 3.0 * std::sin(0.1 * i) * std::cos(0.07 * j), 1.0);
+      }
+    }
+    for (uint32_t i = 0u; i < n; ++i) {
+      for (uint32_t j = 0u; j < n; ++j) {
+        Face lower;
+        Face upper;
+        lower.geometricVertexReferences = {i * (n + 1u) + j + 1u, (i + 1u) * (n + 1u) + j + 1u, (i + 1u) * (n + 1u) + j + 2u};
+        upper.geometricVertexReferences = {i * (n + 1u) + j + 1u, (i + 1u) * (n + 1u) + j + 2u, i * (n + 1u) + j + 2u};
+        data.faces.emplace_back(lower);
+        data.faces.emplace_back(upper);
+      }
+    }
+    data.updateTriangles();
+
+    std::vector<uint8_t> stl;
+    std::vector<uint8_t> compressed;
+    WriteStl().write(stl, data);
+    WritePacked().write(compressed, data);
+    CHECK(5u * compressed.size() < stl.size());
+
+    MeshData read;
+    REQUIRE_NOTHROW(ReadPacked().read(compressed.data(), compressed.size(), read, Progress()));
+    CHECK(read.faces.size() == data.faces.size());
+    CHECK(read.geometricVertices.size() == data.geometricVertices.size());
+  }
+
+  std::filesystem::remove(packed);
+}
+
+TEST_CASE("Edgebreaker connectivity", "[edgebreaker]") {
+  using Triangles = std::vector<std::array<uint32_t, 3>>;
+
+  /* function to encode and decode the triangles, checking that the same oriented triangles come back */
+  auto roundTrip = [](const Triangles& triangles, size_t numOfVertices) {
+    const EncodedConnectivity encoded = encodeConnectivity(triangles, numOfVertices);
+    REQUIRE(encoded.vertexOrder.size() == numOfVertices);
+    Triangles decoded = decodeConnectivity(encoded.symbols.data(), encoded.symbols.size(), encoded.indices.data(),
+                                           encoded.indices.size(), triangles.size(), numOfVertices);
+
+    auto canonical = [](Triangles t) {
+      for (auto& triangle : t) {
+        std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+      }
+      std::sort(t.begin(), t.end());
+      return t;
+    };
+    for (auto& triangle : decoded) {
+      for (auto& vertex : triangle) {
+        vertex = encoded.vertexOrder[vertex];
+      }
+    }
+    CHECK(canonical(decoded) == canonical(triangles));
+    return 8.0 * static_cast<double>(entropyEncode(encoded.symbols).size() + entropyEncode(encoded.indices).size()) /
+           std::max<size_t>(1u, triangles.size());
+  };
+
+  /* grid of n x m quads, closed into a torus or open */
+  auto grid = [](uint32_t n, uint32_t m, bool isTorus) {
+    Triangles triangles;
+    const uint32_t columns = isTorus ? m : m + 1u;
+    auto vertex = [&](uint32_t i, uint32_t j) { return (i % (isTorus ? n : n + 1u)) * columns + (j % columns); };
+    for (uint32_t i = 0u; i < n; ++i) {
+      for (uint32_t j = 0u; j < m; ++j) {
+        triangles.push_back({vertex(i, j), vertex(i, j + 1u), vertex(i + 1u, j)});
+        triangles.push_back({vertex(i, j + 1u), vertex(i + 1u, j + 1u), vertex(i + 1u, j)});
+      }
+    }
+    return triangles;
+  };
+
+  SECTION("Testing synthetic meshes") {
+    const double torusBits = roundTrip(grid(300u, 400u, true), 300u * 400u);
+    CHECK(torusBits < 2.5);
+    const double openBits = roundTrip(grid(200u, 300u, false), 201u * 301u);
+    CHECK(openBits < 2.5);
+
+    /* non-manifold edge, a vertex shared by two fans, a degenerate and an unreferenced vertex */
+    roundTrip({{0u, 1u, 2u}, {1u, 0u, 3u}, {1u, 0u, 4u}, {0u, 1u, 5u}, {2u, 6u, 7u}, {2u, 2u, 6u}}, 9u);
+    roundTrip({}, 0u);
+  }
+
+  SECTION("Testing invalid streams") {
+    const Triangles triangles = grid(10u, 10u, true);
+    const EncodedConnectivity encoded = encodeConnectivity(triangles, 100u);
+    CHECK_THROWS(decodeConnectivity(encoded.symbols.data(), encoded.symbols.size() - 1u, encoded.indices.data(),
+                                    encoded.indices.size(), triangles.size(), 100u));
+    std::vector<uint8_t> symbols(encoded.symbols);
+    std::fill(symbols.begin() + 1, symbols.end(), static_cast<uint8_t>(1u));
+    CHECK_THROWS(decodeConnectivity(symbols.data(), symbols.size(), encoded.indices.data(), encoded.indices.size(),
+                                    triangles.size(), 100u));
+  }
+
+  SECTION("Testing the files of the meshes") {
+    const TemporaryDirectory temporary;
+    const std::string edgebreaker = (temporary.path / "3dfc_mesh.3dfe").string();
+    for (const char* name : {RES_DIR "cube.obj", RES_DIR "cube2.obj", RES_DIR "box.obj"}) {
+      FileConverter source;
+      source.setInputFormat(InputType::INPUT_TYPE_OBJ);
+      source.read(name);
+      REQUIRE_NOTHROW(WriteEdgebreaker().write(edgebreaker, source.mesh()));
+
+      FileConverter fc;
+      fc.setInputFormat(InputType::INPUT_TYPE_AUTO);
+      REQUIRE_NOTHROW(fc.read(edgebreaker));
+      REQUIRE(fc.inputFormat()->type == InputType::INPUT_TYPE_EDGEBREAKER);
+      CHECK(fc.mesh().triangles.size() == source.mesh().triangles.size());
+      CHECK(fc.volume() == Approx(source.volume()));
+      CHECK(fc.surface() == Approx(source.surface()));
+    }
+    std::filesystem::remove(edgebreaker);
+  }
+
+  SECTION("Testing a file of the other byte order") {
+    MeshData data;
+    REQUIRE_NOTHROW(ReadObj().read(RES_DIR "cube.obj", data));
+    std::vector<uint8_t> bytes;
+    REQUIRE_NOTHROW(WriteEdgebreaker().write(bytes, data));
+
+    MeshData read;
+    REQUIRE_NOTHROW(ReadEdgebreaker().read(bytes.data(), bytes.size(), read, Progress()));
+    std::reverse(bytes.begin() + offsetof(EdgebreakerHeader, byteOrderMark),
+                 bytes.begin() + offsetof(EdgebreakerHeader, byteOrderMark) + sizeof(uint32_t));
+    CHECK_THROWS_AS(ReadEdgebreaker().read(bytes.data(), bytes.size(), read, Progress()), std::runtime_error);
+  }
+}
+
+TEST_CASE("Vertex cache optimization", "[vertexcache]") {
+  SECTION("Testing a scrambled grid") {
+    /* grid of n x n quads, the faces in a scrambled order */
+    const uint32_t n = 100u;
+    MeshData data;
+    for (uint32_t i = 0u; i <= n; ++i) {
+      for (uint32_t j = 0u; j <= n; ++j) {
+        data.geometricVertices.emplace_back(i, j, 0.0, 1.0);
+      }
+    }
+    for (uint32_t k = 0u; k < n * n; ++k) {
+      const uint32_t quad = (k * 7919u) % (n * n);
+      const uint32_t i = quad / n;
+      const uint32_t j = quad % n;
+      Face f;
+      f.geometricVertexReferences = {i * (n + 1u) + j + 1u, (i + 1u) * (n + 1u) + j + 1u,
+                                     (i + 1u) * (n + 1u) + j + 2u, i * (n + 1u) + j + 2u};
+      data.faces.emplace_back(f);
+    }
+    data.updateTriangles();
+
+    auto corners = [](const MeshData& mesh) {
+      std::vector<std::array<double, 9>> triangles;
+      for (const auto& t : mesh.triangles) {
+        const auto& v = t.vertices;
+        triangles.push_back({v[0].x, v[0].y, v[0].z, v[1].x, v[1].y, v[1].z, v[2].x, v[2].y, v[2].z});
+      }
+      std::sort(triangles.begin(), triangles.end());
+      return triangles;
+    };
+    const auto before = corners(data);
+
+    const VertexCacheStatistics statistics = optimizeVertexCache(data);
+    REQUIRE(statistics.numOfTriangles == 2u * n * n);
+    CHECK(statistics.acmrBefore() > 1.5);
+    CHECK(statistics.acmrAfter() < 0.8);
+    CHECK(statistics.numOfMissesAfter == countCacheMisses(data));
+    CHECK(corners(data) == before);
+
+    /* the vertices are fetched in the order of their first use */
+    uint32_t nextVertex = 1u;
+    bool isInOrder = true;
+    for (const auto& f : data.faces) {
+      for (uint32_t reference : f.geometricVertexReferences) {
+        isInOrder = isInOrder && (reference <= nextVertex);
+        nextVertex += (reference == nextVertex) ? 1u : 0u;
+      }
+    }
+    CHECK(isInOrder);
+    CHECK(nextVertex == data.geometricVertices.size() + 1u);
+  }
+
+  SECTION("Testing the files of the meshes") {
+    for (const char* name : {RES_DIR "cube.obj", RES_DIR "cube2.obj", RES_DIR "box.obj"}) {
+      FileConverter fc;
+      fc.setInputFormat(InputType::INPUT_TYPE_OBJ);
+      fc.read(name);
+      const double volume = fc.volume();
+      const double surface = fc.surface();
+      const size_t numOfTriangles = fc.mesh().triangles.size();
+
+      const VertexCacheStatistics statistics = fc.optimizeVertexCache();
+      CHECK(statistics.numOfMissesAfter <= statistics.numOfMissesBefore);
+      CHECK(fc.mesh().triangles.size() == numOfTriangles);
+      CHECK(fc.volume() == Approx(volume));
+      CHECK(fc.surface() == Approx(surface));
+    }
+  }
+
+  SECTION("Testing invalid references") {
+    MeshData data;
+    data.geometricVertices.assign(3u, glm::dvec4(0.0, 0.0, 0.0, 1.0));
+    Face f;
+    for (uint32_t reference : {0u, 4u, 1000000u}) {
+      f.geometricVertexReferences = {1u, 2u, reference};
+      data.faces.assign(1u, f);
+      CHECK_THROWS_AS(countCacheMisses(data), std::runtime_error);
+      CHECK_THROWS_AS(optimizeVertexCache(data), std::runtime_error);
+    }
+  }
+}